@@ -0,0 +1,352 @@
+#include "Window.h"
+#include "Tiling.h"
+#include "Layering.h"
+#include "PointFold.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// Samples per benchmark, after one to warm up.
+#define SAMPLES 15
+// Iterations per sample are doubled until a sample takes at least this long, in seconds.
+#define MIN_SAMPLE_TIME 0.002
+
+//--------------------
+
+namespace
+{
+// Seconds per iteration over the samples.
+struct Stats
+{
+	double min;
+	double median;
+	double mean;
+	double deviation;
+	size_t iterations; // Per sample.
+};
+
+struct Result
+{
+	std::string name;
+	Stats       stats;
+	size_t      items; // Processed per iteration, for throughput.
+};
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// The median is what to compare between runs. The deviation tells how
+// far to trust it; system noise mostly shows up in the mean and the max.
+template <typename Function>
+Stats measure(Function&& function)
+{
+	// Calibrating doubles as the warm-up.
+	size_t iterations = 1;
+	for (;;)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < iterations; ++i)
+			function();
+
+		if (seconds_since(start) >= MIN_SAMPLE_TIME)
+			break;
+		iterations *= 2;
+	}
+
+	std::vector<double> times;
+	for (int sample = 0; sample < SAMPLES; ++sample)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < iterations; ++i)
+			function();
+
+		times.push_back(seconds_since(start) / iterations);
+	}
+
+	std::sort(std::begin(times), std::end(times));
+
+	double sum = 0.0, squares = 0.0;
+	for (auto time : times)
+	{
+		sum     += time;
+		squares += time * time;
+	}
+
+	Stats stats;
+	stats.min        = times.front();
+	stats.median     = times[times.size() / 2];
+	stats.mean       = sum / times.size();
+	stats.deviation  = std::sqrt(std::max(squares / times.size() - stats.mean * stats.mean, 0.0));
+	stats.iterations = iterations;
+
+	return stats;
+}
+
+class Report
+{
+public:
+	void add(const std::string& name, const Stats& stats, size_t items = 0)
+	{
+		results_.push_back({name, stats, items});
+
+		std::printf("  %-36s %12.3f us  min %12.3f us  +-%5.1f%%", name.c_str(),
+		            stats.median * 1e6, stats.min * 1e6,
+		            stats.mean > 0.0 ? 100.0 * stats.deviation / stats.mean : 0.0);
+		if (items)
+			std::printf("  %9.1f M/s", items / stats.median * 1e-6);
+		std::printf("\n");
+	}
+
+	bool write_json(const char* path) const
+	{
+		FILE* file = std::fopen(path, "w");
+		if (!file)
+		{
+			std::fprintf(stderr, "Could not write the results to %s.\n", path);
+			return false;
+		}
+
+		std::fprintf(file, "{\"unit\":\"seconds\",\"samples\":%d,\"benchmarks\":[", SAMPLES);
+		for (size_t i = 0; i < results_.size(); ++i)
+		{
+			const auto& result = results_[i];
+			const auto& stats  = result.stats;
+			std::fprintf(file, "%s\n{\"name\":\"%s\",\"median\":%.9g,\"min\":%.9g,\"mean\":%.9g,"
+			             "\"deviation\":%.9g,\"iterations\":%zu,\"items_per_second\":%.9g}",
+			             i ? "," : "", result.name.c_str(), stats.median, stats.min, stats.mean,
+			             stats.deviation, stats.iterations, result.items / stats.median);
+		}
+		std::fprintf(file, "\n]}\n");
+
+		bool successful = std::ferror(file) == 0;
+		std::fclose(file);
+		return successful;
+	}
+
+private:
+	std::vector<Result> results_;
+};
+
+void bench_point_fold(Report& report)
+{
+	const size_t num_points = 1 << 20;
+
+	std::mt19937 generator(0);
+	std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+
+	std::vector<float> x(num_points), y(num_points);
+	for (size_t i = 0; i < num_points; ++i)
+	{
+		x[i] = distribution(generator);
+		y[i] = distribution(generator);
+	}
+
+	std::printf("PointFold (%s), %zu points\n", PointFold::instruction_set(), num_points);
+
+	PointFold::Result result;
+	for (int group = 0; group < Wallpaper::NUM_GROUPS; ++group)
+	{
+		Tiling tiling;
+		tiling.set_symmetry_group((Wallpaper::Group)group);
+
+		PointFold fold(tiling);
+		auto stats = measure([&](){ fold.fold(x.data(), y.data(), num_points, result); });
+		report.add(std::string("point_fold/") + tiling.symmetry_group(), stats, num_points);
+	}
+}
+
+void bench_set_symmetry_group(Report& report)
+{
+	std::printf("Tiling::set_symmetry_group\n");
+
+	Tiling tiling;
+	for (int group = 0; group < Wallpaper::NUM_GROUPS; ++group)
+	{
+		auto stats = measure([&](){ tiling.set_symmetry_group((Wallpaper::Group)group); });
+		report.add(std::string("set_symmetry_group/") + tiling.symmetry_group(), stats);
+	}
+}
+
+// One group per lattice type, since the constraints differ by lattice.
+// The deformations circle around the origin, so the lattice stays sane.
+void bench_deform(Report& report)
+{
+	std::printf("Tiling::deform, Tiling::set_t2\n");
+
+	const Wallpaper::Group groups[] = {
+		Wallpaper::Group::P1, Wallpaper::Group::CM, Wallpaper::Group::PM,
+		Wallpaper::Group::P4, Wallpaper::Group::P6
+	};
+
+	for (auto group : groups)
+	{
+		Tiling tiling;
+		tiling.set_symmetry_group(group);
+		tiling.set_deform_origin({0.9f, 0.7f});
+
+		float angle = 0.0f;
+		auto deform = measure([&](){
+			angle += 0.01f;
+			tiling.deform({0.1f * std::cos(angle), 0.1f * std::sin(angle)});
+		});
+		report.add(std::string("deform/") + tiling.symmetry_group(), deform);
+
+		tiling.set_t1({1.0f, 0.0f});
+		auto set_t2 = measure([&](){
+			angle += 0.01f;
+			tiling.set_t2({0.3f * std::cos(angle), 1.0f + 0.3f * std::sin(angle)});
+		});
+		report.add(std::string("set_t2/") + tiling.symmetry_group(), set_t2);
+	}
+}
+
+void bench_layer_transforms(Report& report)
+{
+	const size_t num_points = 4096;
+
+	std::printf("Layer::to_world, Layer::from_world, %zu points\n", num_points);
+
+	Layer layer;
+	layer.set_position({0.3f, -0.2f});
+	layer.set_rotation(0.7f);
+	layer.set_t1({1.5f, 0.4f});
+
+	std::mt19937 generator(0);
+	std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+
+	std::vector<Eigen::Vector2f> points(num_points);
+	for (auto& point : points)
+		point = {distribution(generator), distribution(generator)};
+
+	// The sum keeps the compiler from dropping the work.
+	Eigen::Vector2f sum = Eigen::Vector2f::Zero();
+	auto to_world = measure([&](){
+		for (const auto& point : points)
+			sum += layer.to_world(point);
+	});
+	report.add("layer/to_world", to_world, num_points);
+
+	auto from_world = measure([&](){
+		for (const auto& point : points)
+			sum += layer.from_world(point);
+	});
+	report.add("layer/from_world", from_world, num_points);
+
+	if (sum.hasNaN())
+		std::printf("  (NaN in the transforms)\n");
+}
+
+// Domain textures are drawn on the GPU, so the times include a glFinish.
+// The symmetry mesh is only rebuilt when the group changes, so with the
+// smallest domain texture, the difference between the first two is about
+// the cost of the rebuild. More lattice domains draw more instances.
+void bench_domain_texture(Report& report)
+{
+	std::printf("Layer::symmetry_mesh, Layer::domain_texture\n");
+
+	Layer layer("checkerboard", GL::Texture::checkerboard());
+	layer.tiling().set_symmetry_group(Wallpaper::Group::P4M);
+	layer.tiling().set_scale(0.5f);
+	layer.domain_texture(64);
+
+	int flip = 0;
+	auto rebuild_mesh = measure([&](){
+		flip ^= 1;
+		layer.tiling().set_symmetry_group(flip ? Wallpaper::Group::P6M : Wallpaper::Group::P4M);
+		layer.domain_texture(64);
+		glFinish();
+	});
+	report.add("symmetry_mesh/rebuild", rebuild_mesh);
+
+	auto same_mesh = measure([&](){
+		layer.set_inconsistent();
+		layer.domain_texture(64);
+		glFinish();
+	});
+	report.add("symmetry_mesh/same_group", same_mesh);
+
+	for (int domains : {1, 4, 9, 25})
+	{
+		layer.tiling().set_num_lattice_domains(domains);
+		auto stats = measure([&](){
+			layer.set_inconsistent();
+			layer.domain_texture(512);
+			glFinish();
+		});
+		report.add("domain_texture/512/domains_" + std::to_string(domains), stats);
+	}
+}
+
+// Images move back and forth between the first and the last layer, so
+// every iteration starts from the same layering.
+void bench_transfer_image(Report& report)
+{
+	std::printf("Layering::transfer_image\n");
+
+	const std::pair<size_t, size_t> sizes[] = {{4, 16}, {16, 64}, {64, 256}};
+	for (const auto& size : sizes)
+	{
+		Layering layering;
+		for (size_t i = 0; i < size.first; ++i)
+		{
+			if (i > 0)
+				layering.add_layer();
+
+			auto& layer = layering.current_layer();
+			for (size_t j = 0; j < size.second; ++j)
+				layer.add_image("image", GL::Texture::empty_2D(4, 4));
+		}
+
+		auto last = size.first - 1;
+		auto name = std::to_string(size.first) + "x" + std::to_string(size.second);
+
+		auto between = measure([&](){
+			layering.transfer_image(0, last);
+			layering.transfer_image(last, 0);
+		});
+		report.add("transfer_image/layers/" + name, between);
+
+		auto within = measure([&](){
+			layering.transfer_image(0, 0, size.second - 1);
+		});
+		report.add("transfer_image/within/" + name, within);
+	}
+}
+} // namespace
+
+// Usage: symmetrifier_bench [--json <file>]
+int main(int argc, char* argv[])
+{
+	const char* json_path = nullptr;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+			json_path = argv[++i];
+		else
+			std::fprintf(stderr, "Unknown argument %s.\n", argv[i]);
+	}
+
+	// The tilings upload their meshes to the MeshArena, and the domain texture
+	// benchmark renders, so we need a context.
+	MainWindow window(64, 64, "symmetrifier_bench", false);
+
+	Report report;
+	bench_point_fold(report);
+	bench_set_symmetry_group(report);
+	bench_deform(report);
+	bench_layer_transforms(report);
+	bench_domain_texture(report);
+	bench_transfer_image(report);
+
+	if (json_path && !report.write_json(json_path))
+		return 1;
+
+	return 0;
+}
@@ -1,26 +1,51 @@
 #ifndef APP_H
 #define APP_H
 
+#include "Options.h"
 #include "Window.h"
+#include "InputReplay.h"
 #include "GUI.h"
 #include "ShaderCanvas.h"
 #include "Mesh.h"
 #include "Layering.h"
 #include "Tiling.h"
 #include "GLObjects.h"
+#include "UniformArray.h"
 #include "Rectangle.h"
+#include <string>
+#include <vector>
 
 //--------------------
 
 class App
 {
 public:
-	App (int argc, char* argv[]);
+	explicit App (const Options&);
 	App (const App&) = delete;
 
 	App& operator= (const App&) = delete;
 
-	void loop (void);
+	// The interactive session, or a replay of one. Returns the exit code.
+	int loop (void);
+
+	// Writes the trace and the memory usage asked for on the command line.
+	void dump_reports (void);
+
+	// For the headless drivers, which set up scenes and time renders of them.
+	Layering&   layering             (void) { return layering_; }
+	void        set_view             (const Eigen::Vector2f& center, double pixels_per_unit);
+	void        set_overlays_visible (bool visible);
+	void        load_layer_image     (const char* filename);
+	void        rebuild_domains      (void);
+
+	// Everything that happens in a frame but waiting for input.
+	void render_frame (void);
+
+	// The scene at the export resolution, at the zoom level of the graphics area.
+	GL::Texture render_export    (int width, int height);
+
+	// The scene at the current zoom level, through the HQ path or the interactive one.
+	GL::Texture render_offscreen (int width, int height, bool hq);
 
 private:
 	// Renders everything but the GUI.
@@ -28,11 +53,16 @@ private:
 	void render_scene_hq        (const Rectangle<int>& viewport, GLuint framebuffer = 0);
 
 	void render_layer           (const Layer& layer, const Rectangle<int>& viewport, GLuint framebuffer = 0);
+	void render_layer_folded    (const Layer& layer, const Rectangle<int>& viewport, GLuint framebuffer = 0);
 	void render_layer_images    (const Layer& layer, const Rectangle<int>& viewport, GLuint framebuffer = 0);
-	void render_symmetry_frame  (const Tiling& tiling, const Rectangle<int>& viewport, GLuint framebuffer = 0);
+	void render_symmetry_frame  (const Layer& layer, const Rectangle<int>& viewport, GLuint framebuffer = 0);
 
 	void render_export_frame    (const Rectangle<int>& viewport, GLuint framebuffer = 0);
 
+	// Uploads the view and the lattice and image transforms of every layer.
+	void   update_uniform_blocks (const Rectangle<int>& viewport);
+	size_t layer_index           (const Layer&) const;
+
 	// Input handling.
 	void mouse_position_callback (double, double);
 	void mouse_button_callback   (int, int, int);
@@ -41,10 +71,16 @@ private:
 	void path_drop_callback      (int, const char**);
 
 	// Utilities.
-	void            load_layer_image      (const char* filename);
 	void            next_layer_object     (void);
 	void            previous_layer_object (void);
 	void            export_result         (int, int, const char*);
+	void            preload_programs      (void);
+	void            enforce_memory_budget (void);
+	void            restore_textures      (void);
+	unsigned        domain_resolution     (const Layer&);
+	void            mark_interaction      (void);
+	void            refine_domain         (void);
+	void            dump_trace            (const std::string& path);
 	Eigen::Vector2f screen_to_view        (double x, double y);
 	Eigen::Vector2f view_to_world         (const Eigen::Vector2f&);
 	Eigen::Vector2f screen_to_world       (double x, double y);
@@ -56,11 +92,26 @@ private:
 	double          zoom_factor_;
 	bool            show_symmetry_frame_;
 	bool            show_result_;
+	bool            fold_analytically_;
+	bool            use_fold_table_;
 	bool            show_object_settings_;
 	bool            show_view_settings_;
 	bool            show_export_settings_;
 	int             export_width_;
 	int             export_height_;
+	int             memory_budget_mb_;
+	float           domain_quality_;
+	bool            full_domain_resolution_;
+	bool            show_profiler_;
+	Options         options_;
+
+	// Runs the session headlessly, with --replay.
+	InputReplay     replay_;
+
+	// While the current layer is being edited, its domain texture is built
+	// at 1 / 2^domain_lod_ resolution. It is refined once input goes idle.
+	int             domain_lod_;
+	double          last_interaction_time_;
 
 	// Framework objects.
 	MainWindow    window_;
@@ -69,6 +120,12 @@ private:
 	Layering      layering_;
 	GUI           gui_;
 
+	// Uniform blocks shared by the render passes.
+	UniformArray        view_block_;
+	UniformArray        lattice_blocks_;
+	UniformArray        image_blocks_;
+	std::vector<size_t> first_image_block_;
+
 	// Mouse input helper variables.
 	Eigen::Vector2f press_position_;
 	Eigen::Vector2f screen_center_static_position_;
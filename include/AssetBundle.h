@@ -0,0 +1,74 @@
+#ifndef ASSETBUNDLE_H
+#define ASSETBUNDLE_H
+
+#include "MappedFile.h"
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// The read-only assets packed into a single file at build time: the shaders,
+// the GUI font and the thumbnails, the latter already decoded into one atlas.
+// The bundle is mapped into memory as a whole, so startup opens one file and
+// decodes nothing. Assets missing from the bundle are read from the loose
+// files instead, so a bare source tree still runs. Debug builds also read
+// the loose files edited since the bundle was built, so shader changes show
+// up without a rebuild; release builds don't look at the loose files of
+// bundled assets at all.
+class AssetBundle
+{
+public:
+	// The images of a directory packed into a grid of equal, power-of-two
+	// cells, so that mipmaps don't bleed between them. RGBA, bottom row first.
+	struct Atlas
+	{
+		struct Image
+		{
+			std::string name;
+			int         x, y, width, height;
+		};
+
+		int                        width, height;
+		const unsigned char*       pixels;
+		std::vector<Image>         images;
+		std::vector<unsigned char> storage; // Owns the pixels if they aren't in the bundle.
+	};
+
+	static const AssetBundle& get (void);
+
+	// Writes a bundle of the given files and of atlases of the given directories.
+	static bool pack (const std::string& path, const std::vector<std::string>& files,
+	                  const std::vector<std::string>& atlas_directories);
+
+	// Decodes the images of a directory into an atlas, in file name order.
+	static Atlas pack_atlas (const std::string& directory);
+
+	bool        valid (void) const { return file_.valid(); }
+
+	// Points to the contents of a bundled file. False if it isn't bundled,
+	// or in debug builds if the loose file is newer than the bundle.
+	bool        find  (const std::string& path, const unsigned char*& data, size_t& size) const;
+
+	// The contents of a file, from the bundle if possible.
+	std::string read  (const std::string& path) const;
+
+	// The atlas of a directory, from the bundle if possible.
+	Atlas       atlas (const std::string& directory) const;
+
+private:
+	struct Entry
+	{
+		const unsigned char* data;
+		size_t               size;
+	};
+
+	explicit AssetBundle (const std::string& path);
+
+	bool parse (void);
+
+	MappedFile                             file_;
+	std::filesystem::file_time_type        written_;
+	std::unordered_map<std::string, Entry> entries_;
+};
+
+#endif // ASSETBUNDLE_H
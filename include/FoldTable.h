@@ -0,0 +1,41 @@
+#ifndef FOLDTABLE_H
+#define FOLDTABLE_H
+
+#include "GLObjects.h"
+#include <array>
+#include <vector>
+
+class Layer;
+
+// The whole fold of a lattice domain into the domain texture, baked into
+// a repeating texture: for each point, the domain texture coordinates it
+// samples and the triangle of the symmetry domain mesh it falls in. The
+// table depends only on the symmetry group and the symmetry scale, so it
+// stays valid through any change of view, lattice or images. Per pixel,
+// folding becomes a single fetch.
+class FoldTable
+{
+public:
+	// Tables are built once per symmetry group and scale.
+	static const FoldTable& get (const Layer&);
+
+	// Float texture covering one lattice domain in lattice coordinates.
+	// Each texel holds the domain texture coordinates at its center and
+	// its triangle index.
+	const GL::Texture& texture       (void) const { return texture_; }
+
+	// Derivatives of the domain texture coordinates in lattice coordinates,
+	// per triangle, as column-major 2x2 matrices. The fold is affine within
+	// a triangle, so these carry a texel center to any point around it.
+	const std::vector<std::array<float, 4>>&
+	                   jacobians     (void) const { return jacobians_; }
+	int                num_triangles (void) const { return jacobians_.size(); }
+
+private:
+	explicit FoldTable (const Layer&);
+
+	GL::Texture                       texture_;
+	std::vector<std::array<float, 4>> jacobians_;
+};
+
+#endif // FOLDTABLE_H
@@ -2,6 +2,7 @@
 #define GLFWIMGUI_H
 
 #include "GLObjects.h"
+#include "StreamBuffer.h"
 
 class MainWindow;
 
@@ -20,12 +21,11 @@ private:
 
 	MainWindow& window_;
 
-	GL::VAO     vao_;
-	GL::Buffer  vbo_;
-	GL::Buffer  ebo_;
-	GL::Texture fonts_texture_;
+	GL::VAO      vao_;
+	StreamBuffer stream_;
+	GL::Texture  fonts_texture_;
 
-	GL::ShaderProgram shader_;
+	GLuint            shader_; // Owned by ProgramCache.
 	GLuint            display_size_uniform_;
 	GLuint            texture_sampler_uniform_;
 
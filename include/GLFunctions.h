@@ -3,6 +3,7 @@
 
 #include <GL/glew.h>
 #include "GLObjects.h"
+#include <vector>
 
 //--------------------
 
@@ -10,14 +11,17 @@ namespace GL
 {
 inline void clear(GLbitfield mask, GLuint framebuffer = 0)
 {
-	GLint old_fbo; glGetIntegerv(GL_FRAMEBUFFER_BINDING, &old_fbo);
-	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	GLuint old_fbo = State::framebuffer(GL_FRAMEBUFFER);
+	State::bind_framebuffer(GL_FRAMEBUFFER, framebuffer);
 	glClear(mask);
-	glBindFramebuffer(GL_FRAMEBUFFER, old_fbo);
+	State::bind_framebuffer(GL_FRAMEBUFFER, old_fbo);
 }
 
 size_t internal_format_size(GLenum format);
 
+// RGBA rows from top to bottom, as in image files.
+std::vector<unsigned char> tex_to_pixels(const Texture& texture);
+
 void tex_to_png(const Texture& texture, const char* filename);
 } // namespace GL
 
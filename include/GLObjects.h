@@ -1,6 +1,7 @@
 #ifndef GLOBJECTS_H
 #define GLOBJECTS_H
 
+#include "MemoryUsage.h"
 #include <GL/glew.h>
 #include <string>
 #define GL_SHADER_SOURCE(CODE) #CODE
@@ -12,6 +13,7 @@ namespace GL
 class Buffer {
 public:
 	Buffer  (void);
+	explicit Buffer (MemoryUsage::Owner);
 	Buffer  (const Buffer&);
 	Buffer  (Buffer&&);
 	~Buffer (void);
@@ -20,8 +22,19 @@ public:
 	Buffer& operator= (Buffer&&);
 	operator GLuint   (void) const {return buffer_;}
 
+	// GPU memory held by this buffer. Whoever calls glBufferData on it
+	// reports the new size; copies report their own.
+	size_t             bytes     (void) const { return bytes_; }
+	void               set_bytes (size_t bytes);
+
+	// What the memory is accounted to in MemoryUsage.
+	MemoryUsage::Owner owner     (void) const { return owner_; }
+	void               set_owner (MemoryUsage::Owner);
+
 private:
-	GLuint buffer_;
+	GLuint             buffer_;
+	size_t             bytes_;
+	MemoryUsage::Owner owner_;
 };
 
 class Texture {
@@ -35,17 +48,41 @@ public:
 	Texture& operator= (Texture&&);
 	operator GLuint    (void) const {return texture_;}
 
-	static Texture from_png                   (const char* filename, bool& successful);
+	// The owner is what the texture's memory is accounted to from the start.
+	static Texture from_png                   (const char* filename, bool& successful,
+	                                           MemoryUsage::Owner = MemoryUsage::OTHER);
 	static Texture from_png                   (const char* filename);
-	static Texture empty_2D                   (int width, int height);
-	static Texture empty_2D_multisample       (int width, int height, int samples = 4);
-	static Texture empty_2D_depth             (int width, int height);
-	static Texture empty_2D_multisample_depth (int width, int height, int samples = 4);
-	static Texture empty_cube                 (int resolution);
-	static Texture empty_cube_depth           (int resolution);
+	static Texture from_png_memory            (const unsigned char* data, size_t size, const char* name,
+	                                           bool& successful, bool mipmaps = true,
+	                                           MemoryUsage::Owner = MemoryUsage::OTHER);
+	// RGBA rows, bottom row first.
+	static Texture from_pixels                (const unsigned char* pixels, int width, int height,
+	                                           bool mipmaps = true, MemoryUsage::Owner = MemoryUsage::OTHER);
+	static Texture checkerboard               (MemoryUsage::Owner = MemoryUsage::OTHER);
+	static Texture empty_2D                   (int width, int height, MemoryUsage::Owner = MemoryUsage::OTHER);
+	static Texture empty_2D_mipmap            (int width, int height, MemoryUsage::Owner = MemoryUsage::OTHER);
+	static Texture empty_2D_multisample       (int width, int height, int samples = 4,
+	                                           MemoryUsage::Owner = MemoryUsage::OTHER);
+	static Texture empty_2D_depth             (int width, int height, MemoryUsage::Owner = MemoryUsage::OTHER);
+	static Texture empty_2D_multisample_depth (int width, int height, int samples = 4,
+	                                           MemoryUsage::Owner = MemoryUsage::OTHER);
+	static Texture empty_cube                 (int resolution, MemoryUsage::Owner = MemoryUsage::OTHER);
+	static Texture empty_cube_depth           (int resolution, MemoryUsage::Owner = MemoryUsage::OTHER);
 	static Texture buffer_texture             (const Buffer& buffer, GLenum format);
+
+	// Approximate GPU memory held by this texture. Buffer textures don't own their storage.
+	size_t         bytes                      (void) const { return bytes_; }
+	void           set_bytes                  (size_t bytes);
+
+	// What the memory is accounted to in MemoryUsage. Moves with the texture.
+	// Prefer passing it to the factory, so the memory never counts as OTHER.
+	MemoryUsage::Owner owner                  (void) const { return owner_; }
+	void           set_owner                  (MemoryUsage::Owner);
+
 private:
-	GLuint texture_;
+	GLuint             texture_;
+	size_t             bytes_;
+	MemoryUsage::Owner owner_;
 public:
 	unsigned int width_, height_; // TODO: Getters and setters.
 };
@@ -96,6 +133,9 @@ public:
 	operator GLuint         (void) const {return shader_object_;}
 
 	static ShaderObject from_file          (GLenum shader_type, const char* filename);
+	// Inserts the definitions right after the #version line.
+	static ShaderObject from_file          (GLenum shader_type, const char* filename,
+	                                        const std::string& definitions);
 	static ShaderObject vertex_passthrough (void);
 private:
 	GLuint shader_object_;
@@ -108,6 +148,7 @@ public:
 	ShaderProgram  (const ShaderObject& vertex_shader, const ShaderObject& geometry_shader,
 	                const ShaderObject& fragment_shader);
 	ShaderProgram  (const char* vertex_source, const char* fragment_source);
+	explicit ShaderProgram (const ShaderObject& compute_shader);
 	ShaderProgram  (const ShaderProgram&) = delete;
 	ShaderProgram  (ShaderProgram&&);
 	~ShaderProgram (void);
@@ -122,10 +163,50 @@ public:
 	static ShaderProgram from_files (const char* vertex_file, const char* fragment_file);
 	static ShaderProgram from_files (const char* vertex_file, const char* geometry_file,
 	                                 const char* fragment_file);
+	static ShaderProgram from_file  (const char* compute_file);
 	static ShaderProgram simple     (void);
 private:
 	GLuint shader_program_;
 };
+
+// Shadows the bindings and blend state the application changes, so that
+// redundant calls are skipped and old bindings can be restored without
+// querying the driver. The shadow is only right if all such changes go
+// through here. Textures are tracked per unit for the common targets.
+class State {
+public:
+	static void   use_program         (GLuint program);
+	static void   bind_vao            (GLuint vao);
+	// GL_FRAMEBUFFER binds both the read and the draw framebuffer.
+	static void   bind_framebuffer    (GLenum target, GLuint framebuffer);
+	static void   active_texture      (GLenum unit);
+	// Binds to the active texture unit.
+	static void   bind_texture        (GLenum target, GLuint texture);
+	static void   viewport            (GLint x, GLint y, GLsizei width, GLsizei height);
+	static void   enable_blend        (bool enabled);
+	static void   enable_depth_test   (bool enabled);
+	static void   enable_scissor_test (bool enabled);
+	static void   blend_func          (GLenum source, GLenum destination);
+	static void   blend_func          (GLenum source_rgb, GLenum destination_rgb,
+	                                    GLenum source_alpha, GLenum destination_alpha);
+
+	static GLuint program             (void);
+	static GLuint vao                 (void);
+	// GL_FRAMEBUFFER gives the draw framebuffer.
+	static GLuint framebuffer         (GLenum target);
+	static GLenum active_texture      (void);
+	static GLuint texture             (GLenum target);
+
+	// Deleting a bound object unbinds it. Called by the object wrappers.
+	static void   forget_texture      (GLuint texture);
+	static void   forget_vao          (GLuint vao);
+	static void   forget_framebuffer  (GLuint framebuffer);
+
+	// Call once per frame. saved_calls() then gives the number of
+	// redundant calls skipped during the frame.
+	static void   end_frame           (void);
+	static size_t saved_calls         (void);
+};
 } // namespace GL
 
 #endif // GLOBJECTS_H
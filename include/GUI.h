@@ -40,6 +40,8 @@ public:
 	GUIVariable<double>          pixels_per_unit_;
 	GUIVariable<bool>            frame_visible_;
 	GUIVariable<bool>            result_visible_;
+	GUIVariable<bool>            fold_analytically_;
+	GUIVariable<bool>            use_fold_table_;
 	GUIVariable<bool>            menu_bar_visible_;
 	GUIVariable<bool>            settings_window_visible_;
 	GUIVariable<bool>            usage_window_visible_;
@@ -48,6 +50,9 @@ public:
 	GUIVariable<bool>            export_settings_visible_;
 	GUIVariable<int>             export_width_;
 	GUIVariable<int>             export_height_;
+	GUIVariable<int>             memory_budget_mb_;
+	GUIVariable<float>           domain_quality_;
+	GUIVariable<bool>            profiler_visible_;
 
 private:
 	// Helper functions.
@@ -79,8 +84,10 @@ private:
 	void draw_current_frame_settings  (void);
 	void draw_current_image_settings  (void);
 	void draw_export_settings         (void);
+	void draw_performance_overlay     (void);
 
 	void populate_thumbnail_map (void);
+	bool thumbnail_button       (const char* symmetry_group, int frame_padding);
 
 	GLFWImGui implementation_;
 
@@ -97,7 +104,9 @@ private:
 
 	ExportCallback export_callback_;
 
-	std::unordered_map<std::string, GL::Texture> thumbnail_map_;
+	// Texture coordinates of each group's thumbnail in the atlas.
+	GL::Texture                                       thumbnail_atlas_;
+	std::unordered_map<std::string, Rectangle<float>> thumbnail_map_;
 
 	std::string export_base_name_;
 	std::string export_filename_;
@@ -0,0 +1,30 @@
+#ifndef GOLDENCHECK_H
+#define GOLDENCHECK_H
+
+#include <string>
+
+class App;
+
+//--------------------
+
+// Renders every group with one of the example images at a fixed
+// transformation, through both the interactive and the HQ path of a
+// headless app, and compares the renders against <group>.png and
+// <group>_hq.png in a directory of golden images.
+class GoldenCheck
+{
+public:
+	// With a report path, the results and timings are written there as JSON.
+	// With update, the golden images are written instead of checked.
+	GoldenCheck (App&, const std::string& report, bool update);
+
+	// True if all renders pass.
+	bool run (const std::string& directory);
+
+private:
+	App&        app_;
+	std::string report_;
+	bool        update_;
+};
+
+#endif // GOLDENCHECK_H
@@ -0,0 +1,40 @@
+#ifndef INPUTEVENT_H
+#define INPUTEVENT_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// One GLFW input callback and its arguments, as recorded and replayed.
+// Events are stored one per line, with dropped paths on lines of their
+// own. Doubles are written with full precision, so a replay moves the
+// cursor through exactly the recorded positions.
+struct InputEvent
+{
+	enum Type
+	{
+		KEY,
+		CHAR,
+		MOUSE_BUTTON,
+		MOUSE_POS,
+		SCROLL,
+		PATH_DROP
+	};
+
+	double time; // Seconds since the recording started.
+	Type   type;
+
+	int          code;      // The key or the mouse button.
+	int          scancode;
+	int          action;
+	int          mods;
+	unsigned int character;
+	double       x, y;      // Cursor position or scroll offset.
+
+	std::vector<std::string> paths;
+};
+
+std::ostream& operator<< (std::ostream&, const InputEvent&);
+std::istream& operator>> (std::istream&, InputEvent&);
+
+#endif // INPUTEVENT_H
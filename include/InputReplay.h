@@ -0,0 +1,52 @@
+#ifndef INPUTREPLAY_H
+#define INPUTREPLAY_H
+
+#include "InputEvent.h"
+#include <string>
+#include <vector>
+
+class MainWindow;
+
+// Plays a recorded input session back into a window, for repeatable
+// performance runs. Events are due at their recorded times. With a fixed
+// step, the replay clock advances by the step every frame instead of
+// following the wall clock, so every run renders the same frames however
+// long each of them takes. Frame times are collected for a report.
+class InputReplay
+{
+public:
+	// An empty path makes an inactive replay.
+	InputReplay (const std::string& path, double step = 0.0);
+
+	bool active (void) const { return active_; }
+	int  width  (void) const { return width_; }
+	int  height (void) const { return height_; }
+
+	// Takes over the input of the window, at replay time zero.
+	void start           (MainWindow&);
+
+	// Moves the clock on, waiting for at most timeout seconds with the
+	// recorded pacing, and dispatches the events that are due by then.
+	// False once every event has been dispatched.
+	bool advance         (MainWindow&, double timeout);
+
+	void add_frame_time  (double seconds);
+
+	// Frame time percentiles.
+	void report          (void) const;
+
+private:
+	bool   active_;
+	int    width_, height_;
+	double step_;
+
+	std::vector<InputEvent> events_;
+	size_t                  next_event_;
+
+	double start_time_; // On the GLFW clock.
+	double clock_;
+
+	std::vector<double> frame_times_;
+};
+
+#endif // INPUTREPLAY_H
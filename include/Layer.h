@@ -2,6 +2,8 @@
 #define LAYER_H
 
 #include "LayerImage.h"
+#include "Mesh.h"
+#include "ProgramCache.h"
 #include "Tiling.h"
 
 class Layer
@@ -10,6 +12,9 @@ public:
 	Layer (void);
 	Layer (const std::string& image_name, GL::Texture&&);
 
+	// The shader programs used for building domain textures on this context.
+	static std::vector<std::vector<ProgramCache::Stage>> programs (void);
+
 	const Layer&           as_const            (void)         const { return *this; }
 
 	const Eigen::Vector2f& position            (void)         const { return position_; }
@@ -33,9 +38,19 @@ public:
 	const LayerImage&      current_image       (void)         const { return image(current_index_); }
 	LayerImage&            current_image       (void)               { return image(current_index_); }
 
-	const GL::Texture&     domain_texture      (void)         const;
+	// The domain texture is square. A nonzero resolution is a hint of the
+	// texel count needed along its side, e.g. from its on-screen footprint.
+	// Zero gives the full resolution of the source images.
+	const GL::Texture&     domain_texture      (unsigned resolution = 0) const;
+	// Length of the longest domain edge in world units.
+	float                  domain_footprint    (void)         const;
+	unsigned               last_used_frame     (void)         const { return last_used_frame_; }
+	// GPU memory of the domain texture as it is, without building it.
+	size_t                 domain_texture_bytes (void)        const { return domain_texture_.bytes(); }
 	const std::vector<Eigen::Vector2f>&
 	                       domain_coordinates  (void)         const { return domain_coordinates_; }
+	// Of the domain coordinates about their triangle centroids, to avoid seams.
+	float                  symmetry_scale      (void)         const { return symmetry_scale_; }
 
 	Eigen::Vector2f to_world             (const Eigen::Vector2f&) const;
 	Eigen::Vector2f from_world           (const Eigen::Vector2f&) const;
@@ -51,6 +66,11 @@ public:
 	void set_invisible    (void)   { set_visibility(false); }
 	void set_inconsistent (void)   { consistent_ = false; }
 
+	// Frees the domain texture. It is rebuilt when needed again.
+	void release_domain_texture (void) const;
+	// Has the domain texture rebuilt if it was built from downsampled images.
+	void refresh_reduced        (void) const;
+
 	void set_current_image   (const LayerImage&);
 	void set_current_image   (size_t index);
 	void unset_current_image (void) { current_index_ = size(); }
@@ -71,8 +91,11 @@ public:
 	auto end   (void) const { return images_.end(); }
 
 private:
-	void        symmetrify    (void) const;
-	const Mesh& symmetry_mesh (void) const;
+	unsigned    domain_resolution   (unsigned hint) const;
+	void        symmetrify          (unsigned dimension) const;
+	void        symmetrify_graphics (const std::vector<LayerImage::View>&) const;
+	void        symmetrify_compute  (const std::vector<LayerImage::View>&, float texels_per_unit) const;
+	const Mesh& symmetry_mesh       (void) const;
 
 	std::vector<LayerImage>      images_;
 	size_t                       current_index_;
@@ -91,9 +114,12 @@ private:
 	// This is necessary in order to avoid ugly seams when rendering.
 	float                        symmetry_scale_;
 	mutable Mesh                 symmetry_mesh_;
+	mutable Wallpaper::Group     symmetry_mesh_group_;
 
 	LayerImage                   error_image_;
 	mutable GL::Texture          domain_texture_;
+	mutable bool                 domain_from_reduced_;
+	mutable unsigned             last_used_frame_;
 	std::vector<Eigen::Vector2f> domain_coordinates_;
 };
 
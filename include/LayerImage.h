@@ -2,15 +2,43 @@
 #define LAYERIMAGE_H
 
 #include "GLObjects.h"
+#include "TextureCache.h"
 #include <Eigen/Geometry>
 #include <string>
 
 class LayerImage
 {
 public:
+	// A texture to sample the image from, and where it lies in layer coordinates.
+	// The view keeps the texture alive, so views can be collected before drawing.
+	struct View
+	{
+		TextureCache::Handle texture;
+		Eigen::Vector2f      position;
+		Eigen::Vector2f      t1;
+		Eigen::Vector2f      t2;
+	};
+
 	LayerImage (const std::string& name, GL::Texture&&);
+	LayerImage (const std::string& name, TextureCache::Handle);
+
+	// Counts as a use, which brings a downsampled texture back to full
+	// resolution before the next frame. See TextureCache::restore_used.
+	const GL::Texture&     texture  (void) const;
+	bool                   reduced  (void) const { return TextureCache::get().reduced(texture_); }
+	// Source dimensions, as when the texture was set. Unlike texture(),
+	// these and the resident ones don't count as a use.
+	unsigned               width    (void) const { return width_; }
+	unsigned               height   (void) const { return height_; }
+	// The texture as it is now, which may have been downsampled since.
+	const GL::Texture&     resident (void) const { return *texture_; }
+	// GPU memory of the texture, which other images may share.
+	size_t                 bytes    (void) const { return texture_->bytes(); }
 
-	const GL::Texture&     texture  (void) const { return texture_; }
+	// For sampling the given region of layer coordinates at the given
+	// density. Regular images are viewed whole; tiled ones only page in
+	// the part and the level of detail required.
+	View                   view     (const Eigen::AlignedBox2f& region, float texels_per_unit) const;
 
 	const Eigen::Vector2f& position (void) const { return position_; }
 	Eigen::Vector2f        center   (void) const;
@@ -24,6 +52,7 @@ public:
 	const std::string&     name     (void) const { return name_; }
 
 	void set_texture (GL::Texture&&);
+	void set_texture (TextureCache::Handle);
 
 	void set_position   (const Eigen::Vector2f& p) { position_ = p; }
 	void set_center     (const Eigen::Vector2f&);
@@ -36,11 +65,18 @@ public:
 
 	void set_name       (const std::string& n)     { name_ = n; }
 
+	// Nearest neighbor filtering, trilinear minification if the texture has
+	// mipmaps, and clamping to border, as used for all images.
+	static void set_sampling_parameters (const GL::Texture&);
+
 private:
-	GL::Texture     texture_;
-	Eigen::Vector2f position_;
-	Eigen::Vector2f t1_;
-	std::string     name_;
+	// Possibly shared with other images.
+	TextureCache::Handle texture_;
+	unsigned             width_;
+	unsigned             height_;
+	Eigen::Vector2f      position_;
+	Eigen::Vector2f      t1_;
+	std::string          name_;
 };
 
 #endif // LAYERIMAGE_H
@@ -0,0 +1,37 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include "MemoryUsage.h"
+#include <cstddef>
+#include <string>
+
+// A read-only memory mapping of a whole file. The operating system pages
+// the contents in on access, so only the parts actually read use memory.
+class MappedFile
+{
+public:
+	MappedFile (void);
+	// The whole mapping is accounted to the owner as host memory, resident or not.
+	explicit MappedFile (const std::string& path, MemoryUsage::Owner = MemoryUsage::OTHER);
+	MappedFile (MappedFile&&);
+	~MappedFile (void);
+
+	MappedFile (const MappedFile&) = delete;
+	MappedFile& operator= (const MappedFile&) = delete;
+	MappedFile& operator= (MappedFile&&);
+
+	// False if the file couldn't be opened or mapped.
+	bool                 valid (void) const { return data_ != nullptr; }
+
+	const unsigned char* data  (void) const { return data_; }
+	size_t               size  (void) const { return size_; }
+
+private:
+	void unmap (void);
+
+	const unsigned char* data_;
+	size_t               size_;
+	MemoryUsage::Owner   owner_;
+};
+
+#endif // MAPPEDFILE_H
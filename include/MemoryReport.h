@@ -0,0 +1,19 @@
+#ifndef MEMORYREPORT_H
+#define MEMORYREPORT_H
+
+#include <string>
+
+class Layering;
+
+//--------------------
+
+// The memory usage of a session as JSON: the totals by owner, and what
+// every layer and image holds. Images sharing a source texture each list
+// it, so those don't add up.
+class MemoryReport
+{
+public:
+	static bool write (const std::string& path, const Layering&);
+};
+
+#endif // MEMORYREPORT_H
@@ -0,0 +1,66 @@
+#ifndef MEMORYUSAGE_H
+#define MEMORYUSAGE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+
+// Live and peak bytes of GPU and host memory, by what the memory is held
+// for. Textures and buffers report their storage here whenever it is
+// allocated, resized or freed, and mapped files report their mappings.
+// The owner is given when an object is created, so its memory is never
+// counted under another one first; objects created without one count as
+// OTHER. GPU sizes follow from the internal formats, so they don't include
+// driver padding or alignment.
+class MemoryUsage
+{
+public:
+	enum Owner
+	{
+		OTHER,
+		SOURCE_IMAGE,
+		DOMAIN_TEXTURE,
+		MESH,
+		FOLD_TABLE,
+		EXPORT,
+		GUI,
+		NUM_OWNERS
+	};
+
+	enum Pool
+	{
+		GPU,
+		HOST,
+		NUM_POOLS
+	};
+
+	struct Total
+	{
+		size_t bytes;
+		size_t peak;
+		size_t objects; // Holding any bytes.
+	};
+
+	static MemoryUsage& get  (void);
+
+	static const char*  name (Owner);
+	static const char*  name (Pool);
+
+	// An object of the given owner going from old_bytes to new_bytes.
+	void         resize      (Pool, Owner, size_t old_bytes, size_t new_bytes);
+
+	const Total& total       (Pool pool, Owner owner) const { return totals_[pool][owner]; }
+	// Over all owners. The peak is of the sum, not the sum of the peaks.
+	const Total& total       (Pool pool) const              { return pool_totals_[pool]; }
+
+	// Both pools by owner, as a JSON object.
+	void         write_json  (FILE*) const;
+
+private:
+	MemoryUsage (void);
+
+	std::array<std::array<Total, NUM_OWNERS>, NUM_POOLS> totals_;
+	std::array<Total, NUM_POOLS>                         pool_totals_;
+};
+
+#endif // MEMORYUSAGE_H
@@ -9,8 +9,17 @@
 
 class Mesh {
 public:
-	Mesh (void) : num_vertices_(0), primitive_type_(GL_TRIANGLES) {}
-
+	Mesh (void) : num_vertices_(0), primitive_type_(GL_TRIANGLES),
+	              position_capacity_(0), normal_capacity_(0), texcoord_capacity_(0)
+	{
+		position_buffer_.set_owner(MemoryUsage::MESH);
+		normal_buffer_.set_owner(MemoryUsage::MESH);
+		texcoord_buffer_.set_owner(MemoryUsage::MESH);
+	}
+
+	// Buffers keep their storage between updates and only grow,
+	// so meshes can be rebuilt in place without reallocating.
+	void clear          (void);
 	void update_buffers (void);
 
 	static Mesh from_obj (const char* filename);
@@ -30,6 +39,12 @@ public:
 
 	size_t num_vertices_;
 	GLenum primitive_type_;
+
+private:
+	// Allocated buffer sizes in bytes.
+	size_t position_capacity_;
+	size_t normal_capacity_;
+	size_t texcoord_capacity_;
 };
 
 #endif // MESH_H
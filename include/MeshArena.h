@@ -0,0 +1,47 @@
+#ifndef MESHARENA_H
+#define MESHARENA_H
+
+#include "GLObjects.h"
+#include "WallpaperGroups.h"
+#include <array>
+
+// The domain and frame meshes of every wallpaper group in one immutable,
+// indexed vertex buffer. It is built once; meshes are ranges within it.
+class MeshArena
+{
+public:
+	struct Vertex
+	{
+		GLushort x, y;    // Lattice coordinates, normalized.
+		GLubyte  r, g, b; // Frame line color.
+		GLubyte  corner;  // Which of the six vertices of a symmetry domain this is.
+	};
+
+	struct Range
+	{
+		GLenum  primitive_type;
+		GLsizei num_indices;
+		size_t  index_offset;    // In bytes.
+		GLint   base_vertex;
+	};
+
+	static const MeshArena& get (void);
+
+	const Range& domain (Wallpaper::Group group) const { return domains_[(int)group]; }
+	const Range& frame  (Wallpaper::Group group) const { return frames_[(int)group]; }
+
+	// Binds the arena and draws the range.
+	void draw (const Range&, GLsizei num_instances = 1) const;
+
+private:
+	MeshArena (void);
+
+	GL::VAO    vao_;
+	GL::Buffer vertex_buffer_;
+	GL::Buffer index_buffer_;
+
+	std::array<Range, Wallpaper::NUM_GROUPS> domains_;
+	std::array<Range, Wallpaper::NUM_GROUPS> frames_;
+};
+
+#endif // MESHARENA_H
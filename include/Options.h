@@ -0,0 +1,30 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <string>
+
+//--------------------
+
+// The command line. Every run but a plain interactive one is headless.
+struct Options
+{
+	std::string trace_file;       // With --trace, the last trace_seconds are written here on exit.
+	double      trace_seconds;
+	std::string memory_file;      // With --memory, memory usage is written here on exit.
+	std::string record_file;      // With --record, all input is written here.
+	std::string replay_file;      // With --replay, input comes from here instead.
+	double      replay_step;      // Seconds per frame, or zero for the recorded pacing.
+	std::string benchmark_file;   // With --scene-benchmark, scaling curves go here.
+	std::string golden_directory; // With --golden, renders are checked against the images here.
+	std::string golden_report;    // With --golden-report, the check results and timings go here.
+	bool        update_golden;    // With --golden-update, the images are written instead.
+
+	static Options parse (int argc, char* argv[]);
+
+	bool headless (void) const
+	{
+		return !replay_file.empty() || !benchmark_file.empty() || !golden_directory.empty();
+	}
+};
+
+#endif // OPTIONS_H
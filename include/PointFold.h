@@ -0,0 +1,75 @@
+#ifndef POINTFOLD_H
+#define POINTFOLD_H
+
+#include <Eigen/Geometry>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Tiling;
+class Layer;
+
+// Maps many points into the fundamental domain of a tiling at once.
+// The transformation is set up once, so folding a point costs no matrix
+// inversions. The kernels process 8 points at a time with AVX2, 4 with SSE2.
+class PointFold
+{
+public:
+	// Results in structure-of-arrays form.
+	struct Result
+	{
+		// Coordinates in the unit square of the domain texture. Folding
+		// for a layer pulls them toward the triangle centroids by the
+		// layer's symmetry scale, as its domain coordinates are.
+		std::vector<float>   u;
+		std::vector<float>   v;
+
+		// The orbit element: the lattice translation and the symmetry
+		// domain within the lattice domain that the point was in.
+		std::vector<int32_t> lattice_x;
+		std::vector<int32_t> lattice_y;
+		std::vector<int32_t> domain;
+
+		void   resize (size_t n);
+		size_t size   (void) const { return u.size(); }
+	};
+
+	// Folds points given in layer coordinates. Nothing is scaled.
+	explicit PointFold (const Tiling&);
+	// Folds points given in world coordinates, for sampling the domain texture of the layer.
+	explicit PointFold (const Layer&);
+
+	// Result is resized to n.
+	void fold (const float* x, const float* y, size_t n, Result&) const;
+
+	// Instruction set the kernels were compiled for.
+	static const char* instruction_set (void);
+
+	// Lattice domain triangles are stored as maps from lattice to
+	// barycentric coordinates, three columns of two.
+	using Triangle = float[6];
+
+	// Most triangles any group has.
+	static const int MAX_TRIANGLES = 24;
+
+private:
+	using Kernel = void (*)(const PointFold&, const float*, const float*, size_t, size_t, Result&);
+
+	void set_up (const Tiling&, const Eigen::Matrix2f& basis, const Eigen::Vector2f& position,
+	             float scale);
+
+	// To lattice coordinates.
+	Eigen::Matrix2f to_lattice_;
+	Eigen::Vector2f offset_;
+	// Of the domain texture coordinates about the triangle centroids.
+	float           scale_;
+
+	Triangle        triangles_[MAX_TRIANGLES];
+	int             num_triangles_;
+	Kernel          kernel_;
+
+	template <typename Lanes, int NumTriangles>
+	friend struct FoldKernel;
+};
+
+#endif // POINTFOLD_H
@@ -0,0 +1,140 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "Trace.h"
+#include <GL/glew.h>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Per-pass timings and per-frame counters for the performance overlay.
+// Passes are timed with scoped zones, which may nest. Each zone gets CPU
+// time from the steady clock and GPU time from a pair of timestamp queries.
+// The queries are read back a few frames later, so timing never waits for
+// the GPU to catch up. Draw calls, triangles and texture uploads are counted
+// even while timing is disabled, since that costs next to nothing.
+// Zones are always recorded in the Trace as well, and the GPU times are
+// added to its GPU track when they're read back. Use on the GL thread only.
+class Profiler
+{
+public:
+	static const size_t FRAME_HISTORY = 120;
+
+	// Totals over a frame, smoothed over the frames before it.
+	struct Pass
+	{
+		std::string name;
+		int         depth;
+		int         calls;
+		double      cpu_ms;
+		double      gpu_ms;
+	};
+
+	struct Counters
+	{
+		size_t draw_calls;
+		size_t triangles;
+		size_t texture_uploads;
+		size_t upload_bytes;
+	};
+
+	// Times its lifetime as a pass within the enclosing zones.
+	class Zone
+	{
+	public:
+		explicit Zone (const char* name);
+		Zone (const char* name, size_t index); // E.g. per layer.
+		~Zone (void);
+
+		Zone (const Zone&) = delete;
+		Zone& operator= (const Zone&) = delete;
+
+	private:
+		Trace::Zone trace_;
+		bool        active_;
+	};
+
+	static Profiler& get (void);
+
+	// Nearest rank of sorted times, for p in [0, 1]. Shared by all the
+	// timing reports, so that their percentiles mean the same thing.
+	static double percentile (const std::vector<double>& sorted, double p);
+
+	// Sorted times of the runs in milliseconds, each waiting for the GPU.
+	static std::vector<double> time_runs (int runs, const std::function<void(void)>& function);
+
+	// The frame itself is the outermost zone.
+	void begin_frame  (void);
+	void end_frame    (void);
+
+	// Takes effect from the next frame on.
+	void set_enabled  (bool enabled) { enable_next_frame_ = enabled; }
+	bool enabled      (void) const   { return enabled_; }
+
+	void count_draw   (GLenum mode, GLsizei vertices, GLsizei instances = 1);
+	void count_upload (size_t bytes);
+
+	// Passes in the order they were entered, of the latest frame read back.
+	const std::vector<Pass>&                 passes            (void) const { return passes_; }
+
+	// Of the latest finished frame.
+	const Counters&                          counters          (void) const { return counters_; }
+
+	// CPU frame times in milliseconds. The oldest is at frame_time_offset().
+	const std::array<float, FRAME_HISTORY>&  frame_times       (void) const { return frame_times_; }
+	size_t                                   frame_time_offset (void) const { return frame_time_offset_; }
+
+private:
+	static const size_t FRAME_LATENCY = 4;
+
+	using Clock = std::chrono::steady_clock;
+
+	struct Sample
+	{
+		std::string       key; // Names of the enclosing zones and this one.
+		std::string       name;
+		int               depth;
+		Clock::time_point cpu_begin, cpu_end;
+		size_t            gpu_begin, gpu_end; // Into the frame's queries.
+	};
+
+	struct Frame
+	{
+		std::vector<Sample> samples;
+		std::vector<GLuint> queries;
+		size_t              num_queries;
+		bool                pending;    // Waiting for its queries.
+		int64_t             gpu_offset; // From GPU time to Trace::now().
+	};
+
+	Profiler (void);
+	~Profiler (void);
+
+	void   begin     (std::string name);
+	void   end       (void);
+	size_t timestamp (void);
+	bool   available (const Frame&) const;
+	void   resolve   (Frame&);
+
+	bool enabled_;
+	bool enable_next_frame_;
+
+	std::array<Frame, FRAME_LATENCY> frames_;
+	size_t                           frame_;
+	int64_t                          frame_begin_;
+	std::vector<size_t>              open_; // Samples of the zones entered but not left.
+
+	std::vector<Pass>                                          passes_;
+	std::unordered_map<std::string, std::pair<double, double>> smoothed_; // CPU and GPU.
+
+	Counters counters_;
+	Counters frame_counters_;
+
+	std::array<float, FRAME_HISTORY> frame_times_;
+	size_t                           frame_time_offset_;
+};
+
+#endif // PROFILER_H
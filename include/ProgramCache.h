@@ -0,0 +1,59 @@
+#ifndef PROGRAMCACHE_H
+#define PROGRAMCACHE_H
+
+#include "GLObjects.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Shader programs, shared by source and kept for the lifetime of the context.
+// Linked programs are saved to disk with glGetProgramBinary, keyed by the
+// hash of their sources and the driver, so later runs skip compilation.
+// preload() brings the fixed set of programs in at startup, so first uses
+// of a pass don't hitch. Programs requested outside that set are recorded
+// too, and later runs preload them as well.
+class ProgramCache
+{
+public:
+	struct Stage
+	{
+		Stage (void) = default;
+		Stage (GLenum stage_type, const std::string& source_file, const std::string& source_definitions = "") :
+			type(stage_type), file(source_file), definitions(source_definitions) {}
+
+		GLenum      type;
+		std::string file;
+		std::string definitions; // Inserted after the #version line.
+	};
+
+	static ProgramCache& get (void);
+
+	const GL::ShaderProgram& program (const std::vector<Stage>& stages);
+
+	// Loads or compiles the given programs, then any others recorded by
+	// earlier runs, and reports the timings.
+	void preload (const std::vector<std::vector<Stage>>& programs);
+
+private:
+	ProgramCache (void);
+
+	bool              load     (const GL::ShaderProgram& program, uint64_t hash);
+	void              save     (const GL::ShaderProgram& program, uint64_t hash);
+	GL::ShaderProgram compile  (const std::vector<Stage>& stages);
+	void              remember (const std::vector<Stage>& stages, const std::string& key);
+
+	std::string driver_;
+	bool        binaries_supported_;
+	size_t      num_loaded_, num_compiled_;
+	double      load_time_, compile_time_;
+
+	std::unordered_map<std::string, GL::ShaderProgram> programs_;
+
+	// What the manifest on disk lists.
+	std::vector<std::vector<Stage>>                    recorded_;
+	std::unordered_set<std::string>                    recorded_keys_;
+};
+
+#endif // PROGRAMCACHE_H
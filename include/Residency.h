@@ -0,0 +1,44 @@
+#ifndef RESIDENCY_H
+#define RESIDENCY_H
+
+#include <cstddef>
+
+// Keeps track of GPU memory, as MemoryUsage counts it, against a budget.
+// The actual eviction is done by the owners of the textures; this only
+// tells them when and what.
+class Residency
+{
+public:
+	// Comfortably fits on integrated GPUs with shared memory.
+	static const size_t DEFAULT_BUDGET = 1024u * 1024u * 1024u;
+
+	static Residency& get (void);
+
+	// Budget in bytes. Zero means unlimited.
+	size_t   budget         (void) const { return budget_; }
+	size_t   resident_bytes (void) const;
+	bool     over_budget    (void) const;
+
+	// How many bytes must be released to get under budget.
+	size_t   excess_bytes   (void) const;
+
+	// Frames are used to find out what hasn't been used recently.
+	unsigned frame          (void) const { return frame_; }
+	unsigned idle_frames    (void) const { return idle_frames_; }
+	bool     is_idle        (unsigned last_used_frame) const;
+
+	void set_budget      (size_t bytes) { budget_ = bytes; }
+	void set_idle_frames (unsigned n)   { idle_frames_ = n; }
+	void next_frame      (void)         { ++frame_; }
+
+private:
+	Residency (void);
+
+	size_t   budget_;
+	unsigned frame_;
+
+	// Objects unused for this many frames may be downsampled.
+	unsigned idle_frames_;
+};
+
+#endif // RESIDENCY_H
@@ -0,0 +1,41 @@
+#ifndef SCENEBENCHMARK_H
+#define SCENEBENCHMARK_H
+
+#include "WallpaperGroups.h"
+#include <string>
+#include <vector>
+
+class App;
+
+//--------------------
+
+// Scaling curves of a headless app: each parameter of a procedurally
+// generated scene in turn is swept from a base scene, and the frames,
+// the domain texture rebuilds and the exports of each are timed.
+class SceneBenchmark
+{
+public:
+	explicit SceneBenchmark (App&);
+
+	// Writes CSV, or JSON for a .json path.
+	void run (const std::string& path);
+
+private:
+	struct Scene
+	{
+		const char*      axis;       // The parameter varied from the base scene.
+		int              layers;
+		int              images;     // Per layer.
+		int              resolution; // Of the square source images.
+		Wallpaper::Group group;
+		int              domains;    // Lattice domains per layer.
+	};
+
+	static std::vector<Scene> sweep (void);
+
+	void build (const Scene&);
+
+	App& app_;
+};
+
+#endif // SCENEBENCHMARK_H
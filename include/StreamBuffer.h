@@ -0,0 +1,50 @@
+#ifndef STREAMBUFFER_H
+#define STREAMBUFFER_H
+
+#include "GLObjects.h"
+#include <array>
+
+// A buffer for data that is rewritten every frame. The buffer is split into
+// a ring of regions, and each frame writes into the next one while the GPU
+// may still be reading the previous ones. A fence guards every region, so
+// writes never stall on the driver unless the GPU is a whole ring behind.
+// The regions are persistently mapped when buffer storage is available, and
+// mapped unsynchronized for each write otherwise.
+class StreamBuffer
+{
+public:
+	// The owner is what the memory is accounted to.
+	explicit StreamBuffer (MemoryUsage::Owner owner = MemoryUsage::OTHER, size_t region_size = 1u << 16);
+	~StreamBuffer (void);
+
+	StreamBuffer (const StreamBuffer&) = delete;
+	StreamBuffer& operator= (const StreamBuffer&) = delete;
+
+	// Returns space for the given amount of bytes in the next region.
+	// The region grows if it's too small, which replaces the buffer.
+	void*  begin  (size_t size);
+
+	// Finishes writing. Returns the offset of the written bytes in the buffer.
+	size_t end    (void);
+
+	// Call after the draws reading the current region have been issued.
+	void   fence  (void);
+
+	operator GLuint (void) const { return buffer_; }
+
+private:
+	static const size_t NUM_REGIONS = 3;
+
+	void allocate (size_t region_size);
+	void wait     (size_t region);
+
+	GL::Buffer buffer_;
+	size_t     region_size_;
+	size_t     region_;
+	char*      mapping_;
+	bool       persistent_;
+
+	std::array<GLsync, NUM_REGIONS> fences_;
+};
+
+#endif // STREAMBUFFER_H
@@ -0,0 +1,82 @@
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include "GLObjects.h"
+#include "TiledImage.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// Source image textures are shared between all images using the same file.
+// Files are identified by their content, so the same image under different
+// paths is uploaded only once. A texture lives as long as someone holds its handle.
+// Images too large for a single texture are tiled; their handle holds an overview.
+class TextureCache
+{
+public:
+	using Handle = std::shared_ptr<GL::Texture>;
+
+	static TextureCache& get (void);
+
+	// Returns the error texture if loading fails. Never fails.
+	Handle load_png      (const char* filename, bool& successful);
+	Handle load_png      (const char* filename);
+
+	// The checkerboard shown in place of images that couldn't be loaded.
+	Handle error_texture (void);
+
+	// The tiles behind the texture, or null for a regular texture.
+	std::shared_ptr<TiledImage> tiles (const Handle&) const;
+
+	// Number of distinct textures currently alive.
+	size_t size          (void) const;
+
+	// Marks the texture used this frame.
+	void   touch         (const Handle&);
+
+	// Whether the texture is currently downsampled.
+	bool   reduced       (const Handle&) const;
+
+	// Brings downsampled textures used since back to full resolution, by
+	// decoding their files again. A file that is gone or whose content no
+	// longer matches stays downsampled for good. Returns how many were restored.
+	size_t restore_used  (void);
+
+	// Downsamples textures idle for a while, least recently used first,
+	// until at least the given amount of bytes has been released.
+	// Returns the amount actually released.
+	size_t reduce_idle   (size_t bytes);
+
+private:
+	TextureCache (void) = default;
+
+	// Lets us skip reading and hashing the file if it hasn't changed.
+	struct FileStamp
+	{
+		long long mtime;
+		uintmax_t size;
+		uint64_t  hash;
+	};
+
+	struct Entry
+	{
+		std::weak_ptr<GL::Texture>  texture;
+		std::string                 path;
+		unsigned                    last_used;
+		bool                        reduced;
+		bool                        restorable;
+		std::shared_ptr<TiledImage> tiles;
+	};
+
+	Handle find  (uint64_t hash) const;
+	void   prune (void);
+
+	std::unordered_map<std::string, FileStamp>        stamps_;
+	std::unordered_map<uint64_t, Entry>               entries_;
+	std::unordered_map<const GL::Texture*, uint64_t>  hashes_;
+
+	Handle error_texture_;
+};
+
+#endif // TEXTURECACHE_H
@@ -0,0 +1,87 @@
+#ifndef TILEDIMAGE_H
+#define TILEDIMAGE_H
+
+#include "GLObjects.h"
+#include "MappedFile.h"
+#include <Eigen/Geometry>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Source images too large for a single texture are cut into tiles at every
+// mip level and cached on disk once. The cache file is memory-mapped, and
+// only the tiles covering a requested region are uploaded.
+class TiledImage
+{
+public:
+	// The uploaded part of the image, and where it lies in the unit square
+	// of the whole image. The texture outlives its replacement in the cache.
+	struct Window
+	{
+		std::shared_ptr<GL::Texture> texture;
+		Eigen::Vector2f              min;
+		Eigen::Vector2f              max;
+	};
+
+	// Whether the encoded PNG is too large to be uploaded as is.
+	static bool needs_tiling (const std::vector<unsigned char>& png);
+
+	// Maps the tile cache of the image with the given content hash.
+	// The cache is built from the encoded PNG first if it doesn't exist yet.
+	static std::shared_ptr<TiledImage> open (const std::vector<unsigned char>& png,
+	                                         uint64_t hash, bool& successful);
+
+	unsigned    width      (void) const { return width_; }
+	unsigned    height     (void) const { return height_; }
+	unsigned    num_levels (void) const { return levels_.size(); }
+
+	// The whole image at the finest level no larger than max_size.
+	// The texture reports the full image dimensions.
+	GL::Texture overview   (unsigned max_size) const;
+
+	// Uploads the part of the image covering [min, max] of its unit square,
+	// at the coarsest level that still has the given number of texels
+	// across the full image width. The texture is cached until a few other
+	// regions have been requested, so each view usually finds its own.
+	Window      window     (const Eigen::Vector2f& min, const Eigen::Vector2f& max,
+	                        float texels_across);
+
+private:
+	struct Level
+	{
+		uint32_t width;
+		uint32_t height;
+		uint32_t tiles_x;
+		uint32_t tiles_y;
+		uint64_t offset;
+	};
+
+	explicit TiledImage (MappedFile&&);
+
+	bool                 valid  (void) const { return !levels_.empty(); }
+	const unsigned char* tile   (unsigned level, unsigned x, unsigned y) const;
+	GL::Texture          upload (unsigned level, unsigned x0, unsigned y0,
+	                                             unsigned x1, unsigned y1) const;
+
+	MappedFile         file_;
+	unsigned           width_;
+	unsigned           height_;
+	unsigned           tile_size_;
+	std::vector<Level> levels_;
+
+	// Consecutive requests from the same view usually hit the same tiles,
+	// so the last few windows are kept around, and the least recently used
+	// one is replaced. The rectangle is in texels of its level.
+	struct CachedWindow
+	{
+		std::shared_ptr<GL::Texture> texture;
+		unsigned                     level;
+		unsigned                     rect[4];
+		uint64_t                     last_used;
+	};
+
+	std::vector<CachedWindow> windows_;
+	uint64_t                  window_clock_;
+};
+
+#endif // TILEDIMAGE_H
@@ -1,30 +1,31 @@
 #ifndef TILING_H
 #define TILING_H
 
-#include "GLObjects.h"
-#include "Mesh.h"
+#include "MeshArena.h"
+#include "WallpaperGroups.h"
 #include <Eigen/Geometry>
+#include <array>
+#include <vector>
 
 class Tiling
 {
 public:
 	Tiling (void);
 
-	// Lattice types.
-	enum class Lattice
-	{
-		Oblique,
-		Rhombic,
-		Rectangular,
-		Square,
-		Hexagonal
-	};
+	using Lattice = Wallpaper::Lattice;
 
 	// Properties.
-	const char* symmetry_group       (void) const { return symmetry_group_; }
-	Lattice     lattice              (void) const { return lattice_; }
-	int         num_lattice_domains  (void) const { return num_lattice_domains_; }
-	int         num_symmetry_domains (void) const { return mesh_.positions_.size() / 6 * num_lattice_domains_; }
+	Wallpaper::Group group                (void) const { return group_; }
+	const char*      symmetry_group       (void) const { return Wallpaper::info(group_).name; }
+	Lattice          lattice              (void) const { return Wallpaper::info(group_).lattice; }
+	int              lattice_side         (void) const { return lattice_side_; }
+	int              num_lattice_domains  (void) const { return lattice_side_ * lattice_side_; }
+	int              num_symmetry_domains (void) const { return Wallpaper::info(group_).num_vertices / 6 * num_lattice_domains(); }
+
+	// Lattice domains form a square. Domain (x, y) is offset from the one at the
+	// origin by (x - side / 2, y - side / 2) in lattice coordinates, with integer
+	// division. These are the smallest and largest offsets.
+	Eigen::AlignedBox2f lattice_offsets  (void) const;
 
 	// Transformations.
 	const Eigen::Vector2f& position (void) const { return position_; }
@@ -36,16 +37,20 @@ public:
 	double                 rotation (void) const;
 	double                 scale    (void) const { return t1_.norm(); }
 
-	// Meshes.
-	const Mesh& mesh       (void) const { return mesh_; }
-	const Mesh& frame      (void) const { return frame_mesh_; }
-	const Mesh& total_mesh (void) const { return total_mesh_; }
+	// Meshes. One lattice domain and its frame are shared ranges of the mesh arena.
+	// Shaders replicate them for the other lattice domains.
+	const MeshArena::Range& mesh  (void) const { return MeshArena::get().domain(group_); }
+	const MeshArena::Range& frame (void) const { return MeshArena::get().frame(group_); }
 
-	// Textures & coordinates.
-	const GL::Texture& mesh_texture       (void) const { return mesh_texture_; }
+	// For each triangle of mesh(), the affine map from lattice coordinates
+	// to its barycentric coordinates, as three columns of two.
+	std::vector<std::array<float, 6>> barycentric_maps (void) const;
 
 	// Set properties.
 	void set_symmetry_group      (const char*);
+	void set_symmetry_group      (Wallpaper::Group);
+
+	// Uses the largest square number of domains not above n.
 	void set_num_lattice_domains (int n);
 
 	// Set transformations.
@@ -64,39 +69,12 @@ public:
 	void deform                  (const Eigen::Vector2f&);
 
 private:
-	// Mesh construction functions for the different symmetry groups.
-	void construct_p1   (void);
-	void construct_pm   (void);
-	void construct_cm   (void);
-	void construct_pg   (void);
-
-	void construct_p2   (void);
-	void construct_pmm  (void);
-	void construct_pmg  (void);
-	void construct_cmm  (void);
-	void construct_pgg  (void);
-
-	void construct_p3   (void);
-	void construct_p3m1 (void);
-	void construct_p31m (void);
-
-	void construct_p4   (void);
-	void construct_p4m  (void);
-	void construct_p4g  (void);
-
-	void construct_p6   (void);
-	void construct_p6m  (void);
-
-	void update_total_mesh (void);
-
-
 	// Properties.
-	const char* symmetry_group_;
-	Lattice     lattice_;
+	Wallpaper::Group group_;
 
-	// How many lattice domains to take into account when building
-	// the domain texture?
-	int         num_lattice_domains_;
+	// How many lattice domains, per side, to take into account
+	// when building the domain texture?
+	int              lattice_side_;
 
 
 	// Transformations.
@@ -107,30 +85,6 @@ private:
 	Eigen::Vector2f t2_relative_;
 
 
-	// Meshes.
-
-	// The mesh representation of one lattice domain. Triangles are defined clockwise
-	// or counterclockwise depending on whether they should be mirrored or not.
-	// The vertices are defined relative to the translation vectors.
-	Mesh mesh_;
-
-	// Line mesh for visualizing the lattice domain.
-	// Lines that are mirrors or 180-degree flips are coloured separately.
-	Mesh frame_mesh_;
-	Eigen::Vector3f line_color_;
-	Eigen::Vector3f mirror_color_;
-	Eigen::Vector3f rotation_color_;
-
-	// The mesh representation of all lattice domains; defined similarly to mesh_ above.
-	Mesh total_mesh_;
-
-
-	// Textures & coordinates.
-
-	// This is a buffer texture and will contain the sampling mesh (total_mesh_).
-	GL::Texture mesh_texture_;
-
-
 	// Variables used for intuitive deformations.
 	Eigen::Vector2f deform_origin_;
 	Eigen::Vector2f deform_original_t1_;
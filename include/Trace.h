@@ -0,0 +1,45 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+#include <string>
+
+// Event capture for offline analysis in chrome://tracing or Perfetto.
+// Every thread records into a ring buffer of its own, which only it ever
+// writes, so recording takes no locks; the buffers just keep the latest
+// events. GPU work is recorded on a track of its own, with its times
+// already converted to the CPU clock. dump() writes the last few seconds
+// of every track in the Chrome trace-event JSON format.
+class Trace
+{
+public:
+	// Records its lifetime on the calling thread.
+	class Zone
+	{
+	public:
+		explicit Zone (const char* name);
+		explicit Zone (const std::string& name);
+		~Zone (void);
+
+		Zone (const Zone&) = delete;
+		Zone& operator= (const Zone&) = delete;
+
+	private:
+		char    name_[48];
+		int64_t begin_;
+	};
+
+	// Nanoseconds on the steady clock, the timeline of all events.
+	static int64_t now (void);
+
+	static void record          (const char* name, int64_t begin, int64_t end);
+	static void record_gpu      (const char* name, int64_t begin, int64_t end);
+
+	// Shown instead of the thread number.
+	static void set_thread_name (const char* name);
+
+	// Writes the events that ended within the given amount of seconds.
+	static bool dump            (const std::string& path, double seconds);
+};
+
+#endif // TRACE_H
@@ -0,0 +1,39 @@
+#ifndef UNIFORMARRAY_H
+#define UNIFORMARRAY_H
+
+#include "GLObjects.h"
+#include <cassert>
+#include <vector>
+
+// An array of uniform blocks in one buffer. Elements are padded to the
+// uniform buffer offset alignment, so that each can be bound on its own
+// with glBindBufferRange. The array is built on the CPU and uploaded at
+// once; the buffer is orphaned on upload, so it never waits for the GPU.
+class UniformArray
+{
+public:
+	explicit UniformArray (size_t element_size);
+
+	void   clear  (void);
+
+	// Returns the index of the element.
+	size_t push   (const void* element);
+	template <typename T>
+	size_t push   (const T& element) { assert(sizeof(T) == element_size_); return push((const void*)&element); }
+
+	void   upload (void);
+
+	// Binds the element to the uniform buffer binding point.
+	void   bind   (GLuint binding, size_t index) const;
+
+	size_t size   (void) const { return data_.size() / stride_; }
+
+private:
+	size_t                     element_size_;
+	size_t                     stride_;
+	size_t                     capacity_;
+	std::vector<unsigned char> data_;
+	GL::Buffer                 buffer_;
+};
+
+#endif // UNIFORMARRAY_H
@@ -0,0 +1,591 @@
+#ifndef WALLPAPERGROUPS_H
+#define WALLPAPERGROUPS_H
+
+#include <iterator>
+
+// The 17 wallpaper groups as immutable, compile-time data. Everything is
+// given in lattice coordinates, i.e. relative to the translation vectors.
+namespace Wallpaper
+{
+enum class Lattice
+{
+	Oblique,
+	Rhombic,
+	Rectangular,
+	Square,
+	Hexagonal
+};
+
+// Crystallographic names; the orbifold names are in the table.
+enum class Group
+{
+	P1,
+	PM,
+	CM,
+	PG,
+	P2,
+	PMM,
+	PMG,
+	CMM,
+	PGG,
+	P3,
+	P3M1,
+	P31M,
+	P4,
+	P4M,
+	P4G,
+	P6,
+	P6M
+};
+
+inline constexpr int NUM_GROUPS = 17;
+
+struct Point
+{
+	float x, y;
+};
+
+// Lines that are mirrors or 180-degree flips are drawn separately.
+enum class LineType
+{
+	Plain,
+	Mirror,
+	Rotation
+};
+
+struct FrameLine
+{
+	Point    a, b;
+	LineType type;
+};
+
+struct GroupInfo
+{
+	const char*      name;            // Orbifold notation.
+	Lattice          lattice;
+	Point            t2_relative;     // Default t2 relative to t1 and its normal.
+	int              rotation_order;  // Highest order of rotational symmetry.
+	bool             mirrors;
+	bool             glides;          // Glide reflections along non-mirror axes.
+
+	// One lattice domain, six vertices per symmetry domain. Triangles are defined
+	// clockwise or counterclockwise depending on whether they should be mirrored.
+	const Point*     triangles;
+	int              num_vertices;
+
+	const FrameLine* frame;
+	int              num_frame_lines;
+};
+
+inline constexpr Point SQUARE_T2    = {0.0f, 1.0f};
+inline constexpr Point HEXAGONAL_T2 = {0.5f, 0.866025404f};
+
+//--------------------
+
+inline constexpr Point P1_TRIANGLES[] = {
+	{0, 0}, {1, 0}, {1, 1},
+	{1, 1}, {0, 1}, {0, 0}
+};
+
+inline constexpr FrameLine P1_FRAME[] = {
+	{{0, 0}, {1, 0}, LineType::Plain},
+	{{0, 1}, {1, 1}, LineType::Plain},
+	{{0, 0}, {0, 1}, LineType::Plain},
+	{{1, 0}, {1, 1}, LineType::Plain}
+};
+
+inline constexpr Point PM_TRIANGLES[] = {
+	// Left half.
+	{0, 0},    {0.5f, 0}, {0.5f, 1},
+	{0.5f, 1}, {0, 1},    {0, 0},
+	// Right half, mirrored.
+	{1, 0},    {0.5f, 0}, {0.5f, 1},
+	{0.5f, 1}, {1, 1},    {1, 0}
+};
+
+inline constexpr FrameLine PM_FRAME[] = {
+	{{0, 0},    {1, 0},    LineType::Plain},
+	{{0, 1},    {1, 1},    LineType::Plain},
+	{{0, 0},    {0, 1},    LineType::Mirror},
+	{{1, 0},    {1, 1},    LineType::Mirror},
+	{{0.5f, 0}, {0.5f, 1}, LineType::Mirror}
+};
+
+inline constexpr Point CM_TRIANGLES[] = {
+	// Bottom right.
+	{1, 1}, {0.5f, 0.5f}, {1, 0},
+	{1, 0}, {0.5f, 0.5f}, {0, 0},
+	// Top left, mirrored.
+	{1, 1}, {0.5f, 0.5f}, {0, 1},
+	{0, 1}, {0.5f, 0.5f}, {0, 0}
+};
+
+inline constexpr FrameLine CM_FRAME[] = {
+	{{0, 0}, {1, 0}, LineType::Plain},
+	{{0, 1}, {1, 1}, LineType::Plain},
+	{{0, 0}, {0, 1}, LineType::Plain},
+	{{1, 0}, {1, 1}, LineType::Plain},
+	{{0, 0}, {1, 1}, LineType::Mirror}
+};
+
+inline constexpr Point PG_TRIANGLES[] = {
+	// Left half.
+	{0, 0},    {0.5f, 0}, {0.5f, 1},
+	{0.5f, 1}, {0, 1},    {0, 0},
+	// Right half, mirrored.
+	{0.5f, 1}, {1, 1},    {1, 0},
+	{1, 0},    {0.5f, 0}, {0.5f, 1}
+};
+
+inline constexpr FrameLine PG_FRAME[] = {
+	{{0, 0},    {1, 0},    LineType::Plain},
+	{{0, 1},    {1, 1},    LineType::Plain},
+	{{0, 0},    {0, 1},    LineType::Plain},
+	{{1, 0},    {1, 1},    LineType::Plain},
+	{{0.5f, 0}, {0.5f, 1}, LineType::Plain}
+};
+
+inline constexpr Point P2_TRIANGLES[] = {
+	// Lower right-hand triangle, divided in half.
+	{1, 0}, {0.5f, 0.5f}, {0, 0},
+	{1, 1}, {0.5f, 0.5f}, {1, 0},
+	// Upper left-hand triangle.
+	{0, 1}, {0.5f, 0.5f}, {1, 1},
+	{0, 0}, {0.5f, 0.5f}, {0, 1}
+};
+
+inline constexpr FrameLine P2_FRAME[] = {
+	{{0, 0}, {1, 0}, LineType::Rotation},
+	{{0, 1}, {1, 1}, LineType::Rotation},
+	{{0, 0}, {0, 1}, LineType::Rotation},
+	{{1, 0}, {1, 1}, LineType::Rotation},
+	{{0, 0}, {1, 1}, LineType::Rotation}
+};
+
+inline constexpr Point PMM_TRIANGLES[] = {
+	// Bottom left.
+	{0, 0},       {0.5f, 0}, {0.5f, 0.5f},
+	{0.5f, 0.5f}, {0, 0.5f}, {0, 0},
+	// Top left, mirrored.
+	{0, 1},       {0.5f, 1}, {0.5f, 0.5f},
+	{0.5f, 0.5f}, {0, 0.5f}, {0, 1},
+	// Top right.
+	{1, 1},       {0.5f, 1}, {0.5f, 0.5f},
+	{0.5f, 0.5f}, {1, 0.5f}, {1, 1},
+	// Bottom right, mirrored.
+	{1, 0},       {0.5f, 0}, {0.5f, 0.5f},
+	{0.5f, 0.5f}, {1, 0.5f}, {1, 0}
+};
+
+inline constexpr FrameLine PMM_FRAME[] = {
+	{{0, 0},    {1, 0},    LineType::Mirror},
+	{{0, 1},    {1, 1},    LineType::Mirror},
+	{{0, 0},    {0, 1},    LineType::Mirror},
+	{{1, 0},    {1, 1},    LineType::Mirror},
+	{{0, 0.5f}, {1, 0.5f}, LineType::Mirror},
+	{{0.5f, 0}, {0.5f, 1}, LineType::Mirror}
+};
+
+inline constexpr Point PMG_TRIANGLES[] = {
+	// Bottom left.
+	{0, 0},       {0.5f, 0},    {0.5f, 0.5f},
+	{0.5f, 0.5f}, {0, 0.5f},    {0, 0},
+	// Top left, mirrored.
+	{0, 1},       {0.5f, 1},    {0.5f, 0.5f},
+	{0.5f, 0.5f}, {0, 0.5f},    {0, 1},
+	// Top right, mirrored.
+	{1, 0.5f},    {0.5f, 0.5f}, {0.5f, 1},
+	{0.5f, 1},    {1, 1},       {1, 0.5f},
+	// Bottom right.
+	{1, 0.5f},    {0.5f, 0.5f}, {0.5f, 0},
+	{0.5f, 0},    {1, 0},       {1, 0.5f}
+};
+
+inline constexpr FrameLine PMG_FRAME[] = {
+	{{0, 0},    {1, 0},    LineType::Mirror},
+	{{0, 1},    {1, 1},    LineType::Mirror},
+	{{0, 0},    {0, 1},    LineType::Rotation},
+	{{1, 0},    {1, 1},    LineType::Rotation},
+	{{0, 0.5f}, {1, 0.5f}, LineType::Mirror},
+	{{0.5f, 0}, {0.5f, 1}, LineType::Rotation}
+};
+
+inline constexpr Point CMM_TRIANGLES[] = {
+	// Bottom triangle, divided in half.
+	{0, 0},       {0.5f, 0}, {0.5f, 0.5f},
+	{0.5f, 0.5f}, {0.5f, 0}, {1, 0},
+	// Left triangle. This is mirrored, so clockwise.
+	{0, 0},       {0, 0.5f}, {0.5f, 0.5f},
+	{0.5f, 0.5f}, {0, 0.5f}, {0, 1},
+	// Top triangle. Not mirrored - counter-clockwise.
+	{1, 1},       {0.5f, 1}, {0.5f, 0.5f},
+	{0.5f, 0.5f}, {0.5f, 1}, {0, 1},
+	// Right triangle. Mirrored. Clockwise again.
+	{1, 1},       {1, 0.5f}, {0.5f, 0.5f},
+	{0.5f, 0.5f}, {1, 0.5f}, {1, 0}
+};
+
+inline constexpr FrameLine CMM_FRAME[] = {
+	{{0, 0}, {1, 0}, LineType::Rotation},
+	{{0, 1}, {1, 1}, LineType::Rotation},
+	{{0, 0}, {0, 1}, LineType::Rotation},
+	{{1, 0}, {1, 1}, LineType::Rotation},
+	{{0, 0}, {1, 1}, LineType::Mirror},
+	{{0, 1}, {1, 0}, LineType::Mirror}
+};
+
+inline constexpr Point PGG_TRIANGLES[] = {
+	// Bottom left and right.
+	{0, 0.5f}, {0, 0},       {0.5f, 0},
+	{0.5f, 0}, {1, 0},       {1, 0.5f},
+	// Top right and left.
+	{1, 0.5f}, {1, 1},       {0.5f, 1},
+	{0.5f, 1}, {0, 1},       {0, 0.5f},
+	// Bottom center, mirrored.
+	{0.5f, 0}, {0.5f, 0.5f}, {1, 0.5f},
+	{0, 0.5f}, {0.5f, 0.5f}, {0.5f, 0},
+	// Top center, mirrored.
+	{0.5f, 1}, {0.5f, 0.5f}, {0, 0.5f},
+	{1, 0.5f}, {0.5f, 0.5f}, {0.5f, 1}
+};
+
+inline constexpr FrameLine PGG_FRAME[] = {
+	{{0, 0},    {1, 0},    LineType::Rotation},
+	{{0, 0.5f}, {1, 0.5f}, LineType::Rotation},
+	{{0, 1},    {1, 1},    LineType::Rotation},
+	{{0, 0.5f}, {0.5f, 0}, LineType::Plain},
+	{{0.5f, 0}, {1, 0.5f}, LineType::Plain},
+	{{1, 0.5f}, {0.5f, 1}, LineType::Plain},
+	{{0.5f, 1}, {0, 0.5f}, LineType::Plain}
+};
+
+inline constexpr Point P3_TRIANGLES[] = {
+	// Left and right side.
+	{0, 0}, {1 / 3.f, 1 / 3.f}, {0, 1},
+	{1, 1}, {2 / 3.f, 2 / 3.f}, {1, 0},
+	// Bottom and top.
+	{1, 0}, {1 / 3.f, 1 / 3.f}, {0, 0},
+	{0, 1}, {2 / 3.f, 2 / 3.f}, {1, 1},
+	// Center.
+	{0, 1}, {1 / 3.f, 1 / 3.f}, {1, 0},
+	{1, 0}, {2 / 3.f, 2 / 3.f}, {0, 1}
+};
+
+inline constexpr FrameLine P3_FRAME[] = {
+	{{0, 0}, {1 / 3.f, 1 / 3.f}, LineType::Plain},
+	{{1, 0}, {1 / 3.f, 1 / 3.f}, LineType::Plain},
+	{{0, 1}, {1 / 3.f, 1 / 3.f}, LineType::Plain},
+	{{1, 1}, {2 / 3.f, 2 / 3.f}, LineType::Plain},
+	{{0, 1}, {2 / 3.f, 2 / 3.f}, LineType::Plain},
+	{{1, 0}, {2 / 3.f, 2 / 3.f}, LineType::Plain}
+};
+
+inline constexpr Point P3M1_TRIANGLES[] = {
+	// Bottom and top left.
+	{0, 0},             {0.5f, 0},    {1 / 3.f, 1 / 3.f},
+	{2 / 3.f, 2 / 3.f}, {0.5f, 1},    {0, 1},
+	// Bottom and top right, mirrored.
+	{1, 0},             {0.5f, 0},    {1 / 3.f, 1 / 3.f},
+	{2 / 3.f, 2 / 3.f}, {0.5f, 1},    {1, 1},
+	// Left and right top.
+	{0, 1},             {0, 0.5f},    {1 / 3.f, 1 / 3.f},
+	{2 / 3.f, 2 / 3.f}, {1, 0.5f},    {1, 1},
+	// Left and right bottom, mirrored.
+	{0, 0},             {0, 0.5f},    {1 / 3.f, 1 / 3.f},
+	{2 / 3.f, 2 / 3.f}, {1, 0.5f},    {1, 0},
+	// Bottom center.
+	{1, 0},             {0.5f, 0.5f}, {1 / 3.f, 1 / 3.f},
+	{2 / 3.f, 2 / 3.f}, {0.5f, 0.5f}, {1, 0},
+	// Top center, mirrored.
+	{0, 1},             {0.5f, 0.5f}, {1 / 3.f, 1 / 3.f},
+	{2 / 3.f, 2 / 3.f}, {0.5f, 0.5f}, {0, 1}
+};
+
+inline constexpr FrameLine P3M1_FRAME[] = {
+	{{0, 0},    {1, 1}, LineType::Mirror},
+	{{0.5f, 0}, {0, 1}, LineType::Mirror},
+	{{0.5f, 1}, {1, 0}, LineType::Mirror},
+	{{0, 0.5f}, {1, 0}, LineType::Mirror},
+	{{1, 0.5f}, {0, 1}, LineType::Mirror}
+};
+
+inline constexpr Point P31M_TRIANGLES[] = {
+	// Bottom.
+	{0, 0},             {0.5f, 0},    {1 / 3.f, 1 / 3.f},
+	{1 / 3.f, 1 / 3.f}, {0.5f, 0},    {1, 0},
+	// Left.
+	{0, 1},             {0, 0.5f},    {1 / 3.f, 1 / 3.f},
+	{1 / 3.f, 1 / 3.f}, {0, 0.5f},    {0, 0},
+	// Top, mirrored.
+	{0, 1},             {0.5f, 1},    {2 / 3.f, 2 / 3.f},
+	{2 / 3.f, 2 / 3.f}, {0.5f, 1},    {1, 1},
+	// Right, mirrored.
+	{1, 1},             {1, 0.5f},    {2 / 3.f, 2 / 3.f},
+	{2 / 3.f, 2 / 3.f}, {1, 0.5f},    {1, 0},
+	// Center left.
+	{1, 0},             {0.5f, 0.5f}, {1 / 3.f, 1 / 3.f},
+	{1 / 3.f, 1 / 3.f}, {0.5f, 0.5f}, {0, 1},
+	// Kepu, mirrored.
+	{1, 0},             {0.5f, 0.5f}, {2 / 3.f, 2 / 3.f},
+	{2 / 3.f, 2 / 3.f}, {0.5f, 0.5f}, {0, 1}
+};
+
+inline constexpr FrameLine P31M_FRAME[] = {
+	{{0, 0}, {1, 0},             LineType::Mirror},
+	{{0, 1}, {1, 1},             LineType::Mirror},
+	{{0, 0}, {0, 1},             LineType::Mirror},
+	{{1, 0}, {1, 1},             LineType::Mirror},
+	{{1, 0}, {0, 1},             LineType::Mirror},
+	{{0, 0}, {1 / 3.f, 1 / 3.f}, LineType::Plain},
+	{{1, 0}, {1 / 3.f, 1 / 3.f}, LineType::Plain},
+	{{0, 1}, {1 / 3.f, 1 / 3.f}, LineType::Plain},
+	{{1, 1}, {2 / 3.f, 2 / 3.f}, LineType::Plain},
+	{{0, 1}, {2 / 3.f, 2 / 3.f}, LineType::Plain},
+	{{1, 0}, {2 / 3.f, 2 / 3.f}, LineType::Plain}
+};
+
+inline constexpr Point P4_TRIANGLES[] = {
+	// Bottom left.
+	{0, 0},       {0.5f, 0}, {0.5f, 0.5f},
+	{0.5f, 0.5f}, {0, 0.5f}, {0, 0},
+	// Top left.
+	{0, 1},       {0, 0.5f}, {0.5f, 0.5f},
+	{0.5f, 0.5f}, {0.5f, 1}, {0, 1},
+	// Top right.
+	{1, 1},       {0.5f, 1}, {0.5f, 0.5f},
+	{0.5f, 0.5f}, {1, 0.5f}, {1, 1},
+	// Bottom right.
+	{1, 0},       {1, 0.5f}, {0.5f, 0.5f},
+	{0.5f, 0.5f}, {0.5f, 0}, {1, 0}
+};
+
+inline constexpr FrameLine P4_FRAME[] = {
+	{{0, 0},    {1, 0},    LineType::Plain},
+	{{0, 0.5f}, {1, 0.5f}, LineType::Plain},
+	{{0, 1},    {1, 1},    LineType::Plain},
+	{{0, 0},    {0, 1},    LineType::Plain},
+	{{0.5f, 0}, {0.5f, 1}, LineType::Plain},
+	{{1, 0},    {1, 1},    LineType::Plain}
+};
+
+inline constexpr Point P4M_TRIANGLES[] = {
+	// Bottom left.
+	{0.5f, 0.5f}, {0.25f, 0.25f}, {0.5f, 0},
+	{0.5f, 0},    {0.25f, 0.25f}, {0, 0},
+	// Left bottom, mirrored.
+	{0.5f, 0.5f}, {0.25f, 0.25f}, {0, 0.5f},
+	{0, 0.5f},    {0.25f, 0.25f}, {0, 0},
+	// Left top.
+	{0.5f, 0.5f}, {0.25f, 0.75f}, {0, 0.5f},
+	{0, 0.5f},    {0.25f, 0.75f}, {0, 1},
+	// Top left, mirrored.
+	{0.5f, 0.5f}, {0.25f, 0.75f}, {0.5f, 1},
+	{0.5f, 1},    {0.25f, 0.75f}, {0, 1},
+	// Top right.
+	{0.5f, 0.5f}, {0.75f, 0.75f}, {0.5f, 1},
+	{0.5f, 1},    {0.75f, 0.75f}, {1, 1},
+	// Right top, mirrored.
+	{0.5f, 0.5f}, {0.75f, 0.75f}, {1, 0.5f},
+	{1, 0.5f},    {0.75f, 0.75f}, {1, 1},
+	// Right bottom.
+	{0.5f, 0.5f}, {0.75f, 0.25f}, {1, 0.5f},
+	{1, 0.5f},    {0.75f, 0.25f}, {1, 0},
+	// Bottom right, mirrored.
+	{0.5f, 0.5f}, {0.75f, 0.25f}, {0.5f, 0},
+	{0.5f, 0},    {0.75f, 0.25f}, {1, 0}
+};
+
+inline constexpr FrameLine P4M_FRAME[] = {
+	{{0, 0},    {1, 0},    LineType::Mirror},
+	{{0, 0.5f}, {1, 0.5f}, LineType::Mirror},
+	{{0, 1},    {1, 1},    LineType::Mirror},
+	{{0, 0},    {0, 1},    LineType::Mirror},
+	{{0.5f, 0}, {0.5f, 1}, LineType::Mirror},
+	{{1, 0},    {1, 1},    LineType::Mirror},
+	{{0, 0},    {1, 1},    LineType::Mirror},
+	{{0, 1},    {1, 0},    LineType::Mirror}
+};
+
+inline constexpr Point P4G_TRIANGLES[] = {
+	// Inner bottom left.
+	{0, 0.5f},    {0.25f, 0.25f}, {0.5f, 0.5f},
+	{0.5f, 0.5f}, {0.25f, 0.25f}, {0.5f, 0},
+	// Outer bottom left, mirrored.
+	{0, 0.5f},    {0.25f, 0.25f}, {0, 0},
+	{0, 0},       {0.25f, 0.25f}, {0.5f, 0},
+	// Inner top left.
+	{0.5f, 1},    {0.25f, 0.75f}, {0.5f, 0.5f},
+	{0.5f, 0.5f}, {0.25f, 0.75f}, {0, 0.5f},
+	// Outer top left, mirrored.
+	{0.5f, 1},    {0.25f, 0.75f}, {0, 1},
+	{0, 1},       {0.25f, 0.75f}, {0, 0.5f},
+	// Inner top right.
+	{1, 0.5f},    {0.75f, 0.75f}, {0.5f, 0.5f},
+	{0.5f, 0.5f}, {0.75f, 0.75f}, {0.5f, 1},
+	// Outer top right, mirrored.
+	{1, 0.5f},    {0.75f, 0.75f}, {1, 1},
+	{1, 1},       {0.75f, 0.75f}, {0.5f, 1},
+	// Inner bottom right.
+	{0.5f, 0},    {0.75f, 0.25f}, {0.5f, 0.5f},
+	{0.5f, 0.5f}, {0.75f, 0.25f}, {1, 0.5f},
+	// Outer bottom right, mirrored.
+	{0.5f, 0},    {0.75f, 0.25f}, {1, 0},
+	{1, 0},       {0.75f, 0.25f}, {1, 0.5f}
+};
+
+inline constexpr FrameLine P4G_FRAME[] = {
+	{{0, 0},    {1, 0},    LineType::Plain},
+	{{0, 0.5f}, {1, 0.5f}, LineType::Plain},
+	{{0, 1},    {1, 1},    LineType::Plain},
+	{{0, 0},    {0, 1},    LineType::Plain},
+	{{0.5f, 0}, {0.5f, 1}, LineType::Plain},
+	{{1, 0},    {1, 1},    LineType::Plain},
+	{{0, 0.5f}, {0.5f, 0}, LineType::Mirror},
+	{{0.5f, 0}, {1, 0.5f}, LineType::Mirror},
+	{{1, 0.5f}, {0.5f, 1}, LineType::Mirror},
+	{{0.5f, 1}, {0, 0.5f}, LineType::Mirror}
+};
+
+inline constexpr Point P6_TRIANGLES[] = {
+	// Bottom.
+	{0, 0},             {0.5f, 0},    {1 / 3.f, 1 / 3.f},
+	{1 / 3.f, 1 / 3.f}, {0.5f, 0},    {1, 0},
+	// Left.
+	{0, 1},             {0, 0.5f},    {1 / 3.f, 1 / 3.f},
+	{1 / 3.f, 1 / 3.f}, {0, 0.5f},    {0, 0},
+	// Top.
+	{1, 1},             {0.5f, 1},    {2 / 3.f, 2 / 3.f},
+	{2 / 3.f, 2 / 3.f}, {0.5f, 1},    {0, 1},
+	// Right.
+	{1, 0},             {1, 0.5f},    {2 / 3.f, 2 / 3.f},
+	{2 / 3.f, 2 / 3.f}, {1, 0.5f},    {1, 1},
+	// Center left.
+	{1, 0},             {0.5f, 0.5f}, {1 / 3.f, 1 / 3.f},
+	{1 / 3.f, 1 / 3.f}, {0.5f, 0.5f}, {0, 1},
+	// Kepu.
+	{0, 1},             {0.5f, 0.5f}, {2 / 3.f, 2 / 3.f},
+	{2 / 3.f, 2 / 3.f}, {0.5f, 0.5f}, {1, 0}
+};
+
+inline constexpr FrameLine P6_FRAME[] = {
+	{{0, 0}, {1, 0},             LineType::Rotation},
+	{{0, 1}, {1, 1},             LineType::Rotation},
+	{{0, 0}, {0, 1},             LineType::Rotation},
+	{{1, 0}, {1, 1},             LineType::Rotation},
+	{{1, 0}, {0, 1},             LineType::Rotation},
+	{{0, 0}, {1 / 3.f, 1 / 3.f}, LineType::Plain},
+	{{1, 0}, {1 / 3.f, 1 / 3.f}, LineType::Plain},
+	{{0, 1}, {1 / 3.f, 1 / 3.f}, LineType::Plain},
+	{{1, 1}, {2 / 3.f, 2 / 3.f}, LineType::Plain},
+	{{0, 1}, {2 / 3.f, 2 / 3.f}, LineType::Plain},
+	{{1, 0}, {2 / 3.f, 2 / 3.f}, LineType::Plain}
+};
+
+inline constexpr Point P6M_TRIANGLES[] = {
+	// Bottom left.
+	{1 / 3.f, 1 / 3.f}, {1 / 6.f, 1 / 6.f}, {0.5f, 0},
+	{0.5f, 0},          {1 / 6.f, 1 / 6.f}, {0, 0},
+	// Bottom right, mirrored.
+	{1 / 3.f, 1 / 3.f}, {2 / 3.f, 1 / 6.f}, {0.5f, 0},
+	{0.5f, 0},          {2 / 3.f, 1 / 6.f}, {1, 0},
+	// Left top.
+	{1 / 3.f, 1 / 3.f}, {1 / 6.f, 2 / 3.f}, {0, 0.5f},
+	{0, 0.5f},          {1 / 6.f, 2 / 3.f}, {0, 1},
+	// Left bottom, mirrored.
+	{1 / 3.f, 1 / 3.f}, {1 / 6.f, 1 / 6.f}, {0, 0.5f},
+	{0, 0.5f},          {1 / 6.f, 1 / 6.f}, {0, 0},
+	// Top right.
+	{2 / 3.f, 2 / 3.f}, {5 / 6.f, 5 / 6.f}, {0.5f, 1},
+	{0.5f, 1},          {5 / 6.f, 5 / 6.f}, {1, 1},
+	// Top left, mirrored.
+	{2 / 3.f, 2 / 3.f}, {1 / 3.f, 5 / 6.f}, {0.5f, 1},
+	{0.5f, 1},          {1 / 3.f, 5 / 6.f}, {0, 1},
+	// Right bottom.
+	{2 / 3.f, 2 / 3.f}, {5 / 6.f, 1 / 3.f}, {1, 0.5f},
+	{1, 0.5f},          {5 / 6.f, 1 / 3.f}, {1, 0},
+	// Right top, mirrored.
+	{2 / 3.f, 2 / 3.f}, {5 / 6.f, 5 / 6.f}, {1, 0.5f},
+	{1, 0.5f},          {5 / 6.f, 5 / 6.f}, {1, 1},
+	// Central bottom left.
+	{1 / 3.f, 1 / 3.f}, {2 / 3.f, 1 / 6.f}, {0.5f, 0.5f},
+	{0.5f, 0.5f},       {2 / 3.f, 1 / 6.f}, {1, 0},
+	// Central bottom right, mirrored.
+	{2 / 3.f, 2 / 3.f}, {5 / 6.f, 1 / 3.f}, {0.5f, 0.5f},
+	{0.5f, 0.5f},       {5 / 6.f, 1 / 3.f}, {1, 0},
+	// Central top right.
+	{2 / 3.f, 2 / 3.f}, {1 / 3.f, 5 / 6.f}, {0.5f, 0.5f},
+	{0.5f, 0.5f},       {1 / 3.f, 5 / 6.f}, {0, 1},
+	// Central top left, mirrored.
+	{1 / 3.f, 1 / 3.f}, {1 / 6.f, 2 / 3.f}, {0.5f, 0.5f},
+	{0.5f, 0.5f},       {1 / 6.f, 2 / 3.f}, {0, 1}
+};
+
+inline constexpr FrameLine P6M_FRAME[] = {
+	{{0, 0},    {1, 0}, LineType::Mirror},
+	{{0, 1},    {1, 1}, LineType::Mirror},
+	{{0, 0},    {0, 1}, LineType::Mirror},
+	{{1, 0},    {1, 1}, LineType::Mirror},
+	{{1, 0},    {0, 1}, LineType::Mirror},
+	{{0, 0},    {1, 1}, LineType::Mirror},
+	{{0.5f, 0}, {0, 1}, LineType::Mirror},
+	{{0.5f, 1}, {1, 0}, LineType::Mirror},
+	{{0, 0.5f}, {1, 0}, LineType::Mirror},
+	{{1, 0.5f}, {0, 1}, LineType::Mirror}
+};
+
+//--------------------
+
+#define WALLPAPER_GROUP(name, lattice, t2, rotation_order, mirrors, glides, id) \
+	{name, Lattice::lattice, t2, rotation_order, mirrors, glides,              \
+	 id##_TRIANGLES, (int)std::size(id##_TRIANGLES), id##_FRAME, (int)std::size(id##_FRAME)}
+
+// Indexed by Group.
+inline constexpr GroupInfo GROUPS[NUM_GROUPS] = {
+	WALLPAPER_GROUP("o",     Oblique,     SQUARE_T2,    1, false, false, P1),
+	WALLPAPER_GROUP("**",    Rectangular, SQUARE_T2,    1, true,  false, PM),
+	WALLPAPER_GROUP("*x",    Rhombic,     SQUARE_T2,    1, true,  true,  CM),
+	WALLPAPER_GROUP("xx",    Rectangular, SQUARE_T2,    1, false, true,  PG),
+	WALLPAPER_GROUP("2222",  Oblique,     SQUARE_T2,    2, false, false, P2),
+	WALLPAPER_GROUP("*2222", Rectangular, SQUARE_T2,    2, true,  false, PMM),
+	WALLPAPER_GROUP("22*",   Rectangular, SQUARE_T2,    2, true,  true,  PMG),
+	WALLPAPER_GROUP("2*22",  Rhombic,     SQUARE_T2,    2, true,  true,  CMM),
+	WALLPAPER_GROUP("22x",   Rectangular, SQUARE_T2,    2, false, true,  PGG),
+	WALLPAPER_GROUP("333",   Hexagonal,   HEXAGONAL_T2, 3, false, false, P3),
+	WALLPAPER_GROUP("*333",  Hexagonal,   HEXAGONAL_T2, 3, true,  true,  P3M1),
+	WALLPAPER_GROUP("3*3",   Hexagonal,   HEXAGONAL_T2, 3, true,  true,  P31M),
+	WALLPAPER_GROUP("442",   Square,      SQUARE_T2,    4, false, false, P4),
+	WALLPAPER_GROUP("*442",  Square,      SQUARE_T2,    4, true,  true,  P4M),
+	WALLPAPER_GROUP("4*2",   Square,      SQUARE_T2,    4, true,  true,  P4G),
+	WALLPAPER_GROUP("632",   Hexagonal,   HEXAGONAL_T2, 6, false, false, P6),
+	WALLPAPER_GROUP("*632",  Hexagonal,   HEXAGONAL_T2, 6, true,  true,  P6M)
+};
+
+#undef WALLPAPER_GROUP
+
+constexpr const GroupInfo& info(Group group)
+{
+	return GROUPS[(int)group];
+}
+
+// Looks a group up by its orbifold name. Returns false if there is no such group.
+constexpr bool find(const char* name, Group& group)
+{
+	for (int i = 0; i < NUM_GROUPS; ++i)
+	{
+		const char* a = GROUPS[i].name;
+		const char* b = name;
+		while (*a && *a == *b)
+			++a, ++b;
+
+		if (*a == *b)
+		{
+			group = (Group)i;
+			return true;
+		}
+	}
+
+	return false;
+}
+} // namespace Wallpaper
+
+#endif // WALLPAPERGROUPS_H
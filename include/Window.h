@@ -3,7 +3,12 @@
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include "InputEvent.h"
+#include <array>
+#include <fstream>
 #include <functional>
+#include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -11,7 +16,8 @@
 class MainWindow
 {
 public:
-	MainWindow  (int width, int height, const char* title);
+	// An invisible window only provides an OpenGL context.
+	MainWindow  (int width, int height, const char* title, bool visible = true);
 	MainWindow  (const MainWindow&) = delete;
 	~MainWindow (void);
 
@@ -82,7 +88,29 @@ public:
 	void add_path_drop_callback(const MemberPathDropCallback<T>& callback, T* this_pointer);
 	void add_path_drop_callback(const PathDropCallback& callback);
 
+	// Input state as of the latest event, whether from GLFW or a replay.
+	bool key_down          (int key) const;
+	bool mouse_button_down (int button) const;
+	void cursor_position   (double& x, double& y) const;
+	bool focused           (void) const;
+
+	// Seconds on the GLFW clock, or on the replay clock during a replay.
+	double time            (void) const;
+
+	// Writes every event from now on to the file, with its time.
+	bool record            (const std::string& path);
+
+	// Hands the input over to a replay. Events from GLFW are ignored
+	// from then on, and time() is whatever the replay sets it to.
+	void begin_replay      (void);
+	void set_replay_time   (double time);
+	void replay            (const InputEvent&);
+
 private:
+	// Updates the input state and records the event, then dispatches it.
+	void receive           (InputEvent&);
+	void dispatch          (const InputEvent&); // To the callbacks.
+
 	GLFWwindow*                   window_p_;
 
 	using KeyCallbackMap         = std::unordered_map<int, std::vector<KeyCallback>>;
@@ -99,6 +127,15 @@ private:
 	std::vector<ScrollCallback>             scroll_callbacks_;
 	std::vector<PathDropCallback>           path_drop_callbacks_;
 
+	std::array<bool, GLFW_KEY_LAST + 1>          keys_down_;
+	std::array<bool, GLFW_MOUSE_BUTTON_LAST + 1> mouse_buttons_down_;
+	double                                       cursor_x_, cursor_y_;
+
+	std::unique_ptr<std::ofstream> recording_;
+	double                         recording_start_;
+	bool                           replaying_;
+	double                         replay_time_;
+
 	static void master_key_callback          (GLFWwindow*, int, int, int, int);
 	static void master_char_callback         (GLFWwindow*, unsigned int);
 	static void master_mouse_button_callback (GLFWwindow*, int, int, int);
@@ -109,6 +146,10 @@ private:
 
 	// This is used by the master callback functions.
 	static PointerMap window_by_pointer__;
+
+	// Errors wait for a key press only with a visible window, since
+	// headless runs have nobody to press one.
+	static bool       visible__;
 };
 
 #include "Window.inl"
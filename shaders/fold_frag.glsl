@@ -0,0 +1,86 @@
+#version 330
+
+//--------------------
+
+// Either FOLD_TABLE is defined, or NUM_TRIANGLES and TRIANGLES are defined
+// per symmetry group at compile time. TRIANGLES[i] maps lattice coordinates within one lattice domain to the
+// barycentric coordinates of the i:th triangle of the symmetry domain mesh.
+// The vertex order of each triangle encodes the rotation, reflection or
+// glide that takes it to the fundamental domain.
+
+// Shared by all passes. See App::update_uniform_blocks.
+layout(std140) uniform View {
+	ivec4 uViewport;
+	vec2  uScreenCenter;
+	float uPixelsPerUnit;
+};
+
+// The lattice of the layer in world coordinates.
+layout(std140) uniform Lattice {
+	vec2 uPos;
+	vec2 uT1;
+	vec2 uT2;
+	int  uLatticeSide;
+	mat2 uBasisInv;
+};
+
+#ifdef FOLD_TABLE
+// The domain texture coordinates and the triangle at the texel centers
+// of a lattice domain, and the derivatives of the coordinates per triangle.
+uniform sampler2D uFoldTable;
+uniform mat2      uJacobians[24];
+#endif
+
+uniform vec2 uTexCoords[6];
+uniform sampler2D uTextureSampler;
+
+layout(location = 0) out vec4 fColor;
+
+void main() {
+	vec2 worldPos   = uScreenCenter + (gl_FragCoord.xy - uViewport.xy - 0.5 * uViewport.zw) / uPixelsPerUnit;
+	vec2 latticePos = uBasisInv * (worldPos - uPos);
+
+	// Translations fold away.
+	vec2 p = fract(latticePos);
+
+#ifdef FOLD_TABLE
+	// The fold is affine within a triangle, so the offset from the texel center carries over exactly.
+	ivec2 tableSize = textureSize(uFoldTable, 0);
+	ivec2 texel     = min(ivec2(p * tableSize), tableSize - 1);
+	vec3  remap     = texelFetch(uFoldTable, texel, 0).xyz;
+
+	mat2 toTexCoord = uJacobians[int(remap.z)];
+	vec2 texCoord   = remap.xy + toTexCoord * (p - (vec2(texel) + 0.5) / tableSize);
+#else
+	// Pick the triangle that contains the point, i.e. the one it's deepest inside.
+	// This is robust against rounding on the shared edges.
+	int   triangle  = 0;
+	vec2  bary      = vec2(0);
+	float best      = -1e9;
+	for (int i = 0; i < NUM_TRIANGLES; ++i) {
+		vec2  b      = TRIANGLES[i] * vec3(p, 1);
+		float inside = min(min(b.x, b.y), 1 - b.x - b.y);
+
+		if (inside > best) {
+			best     = inside;
+			triangle = i;
+			bary     = b;
+		}
+	}
+
+	// Every symmetry domain consists of two triangles, mapped to the
+	// bottom and top halves of the domain texture.
+	int  k  = 3 * (triangle % 2);
+	vec2 e1 = uTexCoords[k + 1] - uTexCoords[k];
+	vec2 e2 = uTexCoords[k + 2] - uTexCoords[k];
+
+	vec2 texCoord   = uTexCoords[k] + bary.x * e1 + bary.y * e2;
+	mat2 toTexCoord = mat2(e1, e2) * mat2(TRIANGLES[triangle][0], TRIANGLES[triangle][1]);
+#endif
+
+	// The fold is discontinuous, but its derivatives aren't.
+	vec2 dx = toTexCoord * dFdx(latticePos);
+	vec2 dy = toTexCoord * dFdy(latticePos);
+
+	fColor = textureGrad(uTextureSampler, texCoord, dx, dy);
+}
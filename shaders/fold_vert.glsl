@@ -0,0 +1,10 @@
+#version 330
+
+//--------------------
+
+// A single triangle covering the whole viewport.
+const vec4 vertexPos[3] = vec4[3](vec4(-1, -1, 0, 1), vec4(3, -1, 0, 1), vec4(-1, 3, 0, 1));
+
+void main() {
+	gl_Position = vertexPos[gl_VertexID % 3];
+}
@@ -8,13 +8,21 @@ layout(location = 1) in vec3 aColor;
 
 uniform int uNumInstances = 1;
 
-uniform vec2 uPos = vec2(0, 0);
-uniform vec2 uT1  = vec2(1, 0);
-uniform vec2 uT2  = vec2(0, 1);
+// Shared by all passes. See App::update_uniform_blocks.
+layout(std140) uniform View {
+	ivec4 uViewport;
+	vec2  uScreenCenter;
+	float uPixelsPerUnit;
+};
 
-uniform ivec2 uScreenSize;
-uniform vec2  uScreenCenter;
-uniform float uPixelsPerUnit;
+// The lattice of the layer in world coordinates.
+layout(std140) uniform Lattice {
+	vec2 uPos;
+	vec2 uT1;
+	vec2 uT2;
+	int  uLatticeSide;
+	mat2 uBasisInv;
+};
 
 // Declare the outputs.
 out Data {
@@ -25,7 +33,7 @@ out Data {
 
 vec2 NDCPosition(in vec3 pos) {
 	vec2 worldPos = uPos + uT1 * pos.x + uT2 * pos.y;
-	return (worldPos - uScreenCenter) * vec2(uPixelsPerUnit) / (0.5 * uScreenSize);
+	return (worldPos - uScreenCenter) * vec2(uPixelsPerUnit) / (0.5 * uViewport.zw);
 }
 
 void main() {
@@ -6,12 +6,18 @@ layout(location = 0) in vec3 aPosition;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aTexCoord;
 
-uniform ivec2 uScreenSize;
-uniform vec2  uScreenCenter;
-uniform vec2  uImagePos;
-uniform vec2  uImageT1;
-uniform vec2  uImageT2;
-uniform float uPixelsPerUnit;
+// Shared by all passes. See App::update_uniform_blocks.
+layout(std140) uniform View {
+	ivec4 uViewport;
+	vec2  uScreenCenter;
+	float uPixelsPerUnit;
+};
+
+layout(std140) uniform Image {
+	vec2 uImagePos;
+	vec2 uImageT1;
+	vec2 uImageT2;
+};
 
 out Data {
 	vec3 vColor;
@@ -27,7 +33,7 @@ void main() {
 	position = mat2(uImageT1, uImageT2) * position + uImagePos;
 
 	// Finally the usual view transformation.
-	position      = (position - uScreenCenter) * vec2(uPixelsPerUnit) / (0.5 * uScreenSize);
+	position      = (position - uScreenCenter) * vec2(uPixelsPerUnit) / (0.5 * uViewport.zw);
 	gl_Position   = vec4(position, 0, 1);
 
 	vNormal   = aNormal;
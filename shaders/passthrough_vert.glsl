@@ -0,0 +1,18 @@
+#version 330 core
+
+//--------------------
+
+layout(location = 0) in vec4 aPosition;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec2 aTexCoord;
+
+out Data {
+	vec3 vNormal;
+	vec2 vTexCoord;
+};
+
+void main() {
+	gl_Position = aPosition;
+	vNormal = aNormal;
+	vTexCoord = aTexCoord;
+}
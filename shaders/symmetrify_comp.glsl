@@ -0,0 +1,71 @@
+#version 430
+
+//--------------------
+
+// Builds the whole domain texture in one dispatch. Every texel gathers
+// every image from every symmetry domain, in the order the graphics path
+// draws them, and blends them the same way.
+
+#define MAX_IMAGES 16
+
+layout(local_size_x = 16, local_size_y = 16) in;
+
+// Positions of the dilated symmetry mesh of one lattice domain,
+// six vertices per symmetry domain.
+layout(std430, binding = 0) readonly buffer Positions {
+	float positions[];
+};
+
+layout(rgba8, binding = 0) uniform image2D uDomain;
+
+uniform int  uNumDomains;
+uniform int  uLatticeSide = 1;
+uniform bool uAccumulate;
+
+uniform vec2 uLatticePos   = vec2(0, 0);
+uniform mat2 uLatticeBasis = mat2(1.0);
+
+uniform int       uNumImages;
+uniform vec2      uImagePos[MAX_IMAGES];
+uniform mat2      uImageBasisInv[MAX_IMAGES];
+// Compute shaders have no derivatives, so the level of detail is given.
+uniform float     uImageLod[MAX_IMAGES];
+uniform sampler2D uTextureSamplers[MAX_IMAGES];
+
+vec2 vertex(int i) {
+	return vec2(positions[3 * i], positions[3 * i + 1]);
+}
+
+void main() {
+	ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+	if (any(greaterThanEqual(texel, imageSize(uDomain))))
+		return;
+
+	vec2 uv = (vec2(texel) + 0.5) / vec2(imageSize(uDomain));
+
+	// The first triangle of each symmetry domain covers the bottom half
+	// of the texture, the second one the top half.
+	bool bottom = uv.y <= uv.x;
+
+	vec4 color = uAccumulate ? imageLoad(uDomain, texel) : vec4(0);
+	for (int i = 0; i < uNumImages; ++i) {
+		for (int l = 0; l < uLatticeSide * uLatticeSide; ++l) {
+			vec2 offset = vec2(l % uLatticeSide - uLatticeSide / 2, l / uLatticeSide - uLatticeSide / 2);
+
+			for (int d = 0; d < uNumDomains; ++d) {
+				int  v = 6 * d;
+				vec2 p = bottom
+				       ? vertex(v)     + uv.x * (vertex(v + 1) - vertex(v))     + uv.y * (vertex(v + 2) - vertex(v + 1))
+				       : vertex(v + 5) + uv.x * (vertex(v + 3) - vertex(v + 4)) + uv.y * (vertex(v + 4) - vertex(v + 5));
+
+				vec2 texCoord = uImageBasisInv[i] * (uLatticePos + uLatticeBasis * (p + offset) - uImagePos[i]);
+				vec4 sample_  = textureLod(uTextureSamplers[i], texCoord, uImageLod[i]);
+
+				// Same as glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA).
+				color = sample_ * sample_.a + color * (1 - sample_.a);
+			}
+		}
+	}
+
+	imageStore(uDomain, texel, color);
+}
@@ -5,6 +5,9 @@
 // Declare the input.
 layout(location = 0) in vec3 aPosition;
 
+// The mesh covers one lattice domain; instances cover the rest.
+uniform int  uLatticeSide  = 1;
+
 uniform vec2 uLatticePos   = vec2(0, 0);
 uniform mat2 uLatticeBasis = mat2(1.0);
 
@@ -20,7 +23,11 @@ const vec4 vertexPos[6] = vec4[6](vec4(-1, -1, 0, 1), vec4(1, -1, 0, 1), vec4(1,
                                   vec4(1, 1, 0, 1), vec4(-1, 1, 0, 1), vec4(-1, -1, 0, 1));
 
 void main() {
-	vTexCoord = uLatticePos + uLatticeBasis * aPosition.xy;
+	int  y      = gl_InstanceID / uLatticeSide;
+	int  x      = gl_InstanceID % uLatticeSide;
+	vec2 offset = vec2(x - uLatticeSide / 2, y - uLatticeSide / 2);
+
+	vTexCoord = uLatticePos + uLatticeBasis * (aPosition.xy + offset);
 	vTexCoord = uImageBasisInv * (vTexCoord - uImagePos);
 
 	gl_Position = vertexPos[gl_VertexID % 6];
@@ -4,15 +4,24 @@
 
 in vec4 vInfluence;
 
-uniform vec2 uFramePos = vec2(0, 0);
-uniform vec2 uT1       = vec2(1, 0);
-uniform vec2 uT2       = vec2(0, 1);
+// The lattice of the layer in world coordinates.
+layout(std140) uniform Lattice {
+	vec2 uPos;
+	vec2 uT1;
+	vec2 uT2;
+	int  uLatticeSide;
+	mat2 uBasisInv;
+};
+
 uniform vec2 uImagePos = vec2(0, 0);
 uniform vec2 uImageT1  = vec2(1, 0);
 uniform vec2 uImageT2  = vec2(0, 1);
 
-uniform int uNumSymmetryDomains;
-uniform samplerBuffer uMeshSampler;
+// The symmetry domains of one lattice domain. The rest are offset copies.
+#define MAX_VERTICES 72
+
+uniform int  uNumVertices;
+uniform vec2 uVertices[MAX_VERTICES];
 
 uniform sampler2D uTextureSampler;
 
@@ -20,25 +29,30 @@ layout(location = 0) out vec4 fColor;
 
 void main() {
 	fColor = vec4(0);
-	for (int i = 0; i < uNumSymmetryDomains; ++i)
+	for (int l = 0; l < uLatticeSide * uLatticeSide; ++l)
 	{
-		// 6 and 3?
-		// Every symmetry domain consists of two triangles, i.e. 6 vertices.
-		// vInfluence.w tells us which triangle we're texturing now.
-		vec3 v1 = texelFetch(uMeshSampler, 6*i + 3*int(vInfluence.w) + 0).xyz;
-		vec3 v2 = texelFetch(uMeshSampler, 6*i + 3*int(vInfluence.w) + 1).xyz;
-		vec3 v3 = texelFetch(uMeshSampler, 6*i + 3*int(vInfluence.w) + 2).xyz;
+		vec2 offset = vec2(l % uLatticeSide - uLatticeSide / 2, l / uLatticeSide - uLatticeSide / 2);
+
+		for (int i = 0; i < uNumVertices; i += 6)
+		{
+			// 6 and 3?
+			// Every symmetry domain consists of two triangles, i.e. 6 vertices.
+			// vInfluence.w tells us which triangle we're texturing now.
+			vec2 v1 = uVertices[i + 3*int(vInfluence.w) + 0];
+			vec2 v2 = uVertices[i + 3*int(vInfluence.w) + 1];
+			vec2 v3 = uVertices[i + 3*int(vInfluence.w) + 2];
 
-		// Manual barycentric interpolation.
-		vec2 coord = (mat3(v1, v2, v3) * vInfluence.xyz).xy;
+			// Manual barycentric interpolation.
+			vec2 coord = mat3x2(v1, v2, v3) * vInfluence.xyz + offset;
 
-		coord = uFramePos + uT1 * coord.x + uT2 * coord.y;
-		coord = inverse(mat2(uImageT1, uImageT2)) * (coord - uImagePos);
+			coord = uPos + uT1 * coord.x + uT2 * coord.y;
+			coord = inverse(mat2(uImageT1, uImageT2)) * (coord - uImagePos);
 
-		vec4 sample = texture(uTextureSampler, coord);
+			vec4 sample = texture(uTextureSampler, coord);
 
-		// Manual alpha blending.
-		fColor.xyz = sample.w * sample.xyz + (1.0 - sample.w) * fColor.xyz;
-		fColor.w = sample.w + (1.0 - sample.w) * fColor.w;
+			// Manual alpha blending.
+			fColor.xyz = sample.w * sample.xyz + (1.0 - sample.w) * fColor.xyz;
+			fColor.w = sample.w + (1.0 - sample.w) * fColor.w;
+		}
 	}
 }
@@ -4,22 +4,31 @@
 
 // Declare the inputs.
 layout(location = 0) in vec3 aPosition;
+layout(location = 2) in uint aCorner;
 
 uniform int uNumInstances = 1;
 
-uniform vec2 uFramePos = vec2(0, 0);
-uniform vec2 uT1       = vec2(1, 0);
-uniform vec2 uT2       = vec2(0, 1);
-
-uniform ivec2 uScreenSize;
-uniform vec2  uScreenCenter;
-uniform float uPixelsPerUnit;
+// Shared by all passes. See App::update_uniform_blocks.
+layout(std140) uniform View {
+	ivec4 uViewport;
+	vec2  uScreenCenter;
+	float uPixelsPerUnit;
+};
+
+// The lattice of the layer in world coordinates.
+layout(std140) uniform Lattice {
+	vec2 uPos;
+	vec2 uT1;
+	vec2 uT2;
+	int  uLatticeSide;
+	mat2 uBasisInv;
+};
 
 out vec4 vInfluence;
 
 vec2 NDCPosition(in vec3 pos) {
-	vec2 worldPos = uFramePos + uT1 * pos.x + uT2 * pos.y;
-	return (worldPos - uScreenCenter) * vec2(uPixelsPerUnit) / (0.5 * uScreenSize);
+	vec2 worldPos = uPos + uT1 * pos.x + uT2 * pos.y;
+	return (worldPos - uScreenCenter) * vec2(uPixelsPerUnit) / (0.5 * uViewport.zw);
 }
 
 void main() {
@@ -35,5 +44,5 @@ void main() {
 	const vec4 influence[6] = vec4[6](vec4(1, 0, 0, 0), vec4(0, 1, 0, 0), vec4(0, 0, 1, 0),
 	                                  vec4(1, 0, 0, 1), vec4(0, 1, 0, 1), vec4(0, 0, 1, 1));
 
-	vInfluence = influence[gl_VertexID % 6];
+	vInfluence = influence[aCorner];
 }
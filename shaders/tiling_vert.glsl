@@ -4,16 +4,25 @@
 
 // Declare the inputs.
 layout(location = 0) in vec3 aPosition;
+layout(location = 2) in uint aCorner;
 
 uniform int uNumInstances = 1;
 
-uniform vec2 uPos = vec2(0, 0);
-uniform vec2 uT1  = vec2(1, 0);
-uniform vec2 uT2  = vec2(0, 1);
+// Shared by all passes. See App::update_uniform_blocks.
+layout(std140) uniform View {
+	ivec4 uViewport;
+	vec2  uScreenCenter;
+	float uPixelsPerUnit;
+};
 
-uniform ivec2 uScreenSize;
-uniform vec2  uScreenCenter;
-uniform float uPixelsPerUnit;
+// The lattice of the layer in world coordinates.
+layout(std140) uniform Lattice {
+	vec2 uPos;
+	vec2 uT1;
+	vec2 uT2;
+	int  uLatticeSide;
+	mat2 uBasisInv;
+};
 
 uniform vec2 uTexCoords[6];
 
@@ -26,7 +35,7 @@ out Data {
 
 vec2 NDCPosition(in vec3 pos) {
 	vec2 worldPos = uPos + uT1 * pos.x + uT2 * pos.y;
-	return (worldPos - uScreenCenter) * vec2(uPixelsPerUnit) / (0.5 * uScreenSize);
+	return (worldPos - uScreenCenter) * vec2(uPixelsPerUnit) / (0.5 * uViewport.zw);
 }
 
 void main() {
@@ -38,7 +47,7 @@ void main() {
 	vec3 adjustment = vec3(x - s / 2, y - s / 2, 0);
 	vec3 instancePos = adjustment + aPosition;
 
-	vTexCoord = uTexCoords[gl_VertexID % 6];
+	vTexCoord = uTexCoords[aCorner];
 
 	gl_Position = vec4(NDCPosition(instancePos), 0, 1);
 
@@ -2,12 +2,145 @@
 
 #include "GLFunctions.h"
 #include "GLUtils.h"
+#include "FoldTable.h"
+#include "MemoryReport.h"
+#include "ProgramCache.h"
+#include "Profiler.h"
+#include "Trace.h"
+#include "TextureCache.h"
+#include "Residency.h"
+#include <algorithm>
 #include <cstdio>
 #include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
 
 //--------------------
 
-App::App(int /* argc */, char** /* argv */) :
+// Resolution divisor exponent for domain textures while dragging.
+#define INTERACTION_DOMAIN_LOD 2
+// Idle time before each refinement step, in seconds.
+#define REFINE_INTERVAL 0.1
+// Uniform buffer binding points of the View, Lattice and Image blocks.
+#define VIEW_BINDING    0
+#define LATTICE_BINDING 1
+#define IMAGE_BINDING   2
+
+//--------------------
+
+namespace
+{
+// std140 layouts of the uniform blocks in the shaders.
+struct ViewBlock
+{
+	GLint viewport[4];
+	float screen_center[2];
+	float pixels_per_unit;
+	float padding;
+};
+
+struct LatticeBlock
+{
+	float position[2];
+	float t1[2];
+	float t2[2];
+	GLint lattice_side;
+	GLint padding;
+	float basis_inv[2][4]; // A mat2 is stored as two vec4 columns.
+};
+
+struct ImageBlock
+{
+	float position[2];
+	float t1[2];
+	float t2[2];
+	float padding[2];
+};
+
+// The programs of the passes. All of them are brought in at startup.
+const std::vector<ProgramCache::Stage> TILING_PROGRAM = {
+	{GL_VERTEX_SHADER,   "shaders/tiling_vert.glsl"},
+	{GL_FRAGMENT_SHADER, "shaders/tiling_frag.glsl"}
+};
+
+const std::vector<ProgramCache::Stage> IMAGE_PROGRAM = {
+	{GL_VERTEX_SHADER,   "shaders/image_vert.glsl"},
+	{GL_FRAGMENT_SHADER, "shaders/image_frag.glsl"}
+};
+
+const std::vector<ProgramCache::Stage> TILING_HQ_PROGRAM = {
+	{GL_VERTEX_SHADER,   "shaders/tiling_hq_vert.glsl"},
+	{GL_FRAGMENT_SHADER, "shaders/tiling_hq_frag.glsl"}
+};
+
+const std::vector<ProgramCache::Stage> FRAME_PROGRAM = {
+	{GL_VERTEX_SHADER,   "shaders/frame_vert.glsl"},
+	{GL_FRAGMENT_SHADER, "shaders/frame_frag.glsl"}
+};
+
+const std::vector<ProgramCache::Stage> CROP_PROGRAM = {
+	{GL_VERTEX_SHADER,   "shaders/passthrough_vert.glsl"},
+	{GL_FRAGMENT_SHADER, "shaders/crop_frag.glsl"}
+};
+
+// Constants for shaders/fold_frag.glsl: for each triangle of the
+// symmetry domain mesh, the map from lattice to barycentric coordinates.
+std::string fold_definitions(const Tiling& tiling)
+{
+	auto maps = tiling.barycentric_maps();
+
+	std::ostringstream definitions;
+	definitions << std::setprecision(9);
+	definitions << "#define NUM_TRIANGLES " << maps.size() << "\n"
+	            << "const mat3x2 TRIANGLES[NUM_TRIANGLES] = mat3x2[NUM_TRIANGLES](\n";
+
+	for (size_t i = 0; i < maps.size(); ++i)
+	{
+		const auto& m = maps[i];
+		definitions << "\tmat3x2(" << m[0] << ", " << m[1] << ", " << m[2] << ", "
+		                           << m[3] << ", " << m[4] << ", " << m[5] << ")"
+		            << (i + 1 < maps.size() ? ",\n" : "\n");
+	}
+	definitions << ");\n";
+
+	return definitions.str();
+}
+
+// The fold is compiled in for the group of the tiling, or read from a
+// fold table without one.
+std::vector<ProgramCache::Stage> fold_program(const Tiling* tiling)
+{
+	return {
+		{GL_VERTEX_SHADER,   "shaders/fold_vert.glsl"},
+		{GL_FRAGMENT_SHADER, "shaders/fold_frag.glsl",
+		                     tiling ? fold_definitions(*tiling) : "#define FOLD_TABLE\n"}
+	};
+}
+
+// GLSL 3.30 can't set block bindings in the shader itself.
+void bind_uniform_blocks(GLuint program)
+{
+	const std::pair<const char*, GLuint> blocks[] = {
+		{"View", VIEW_BINDING}, {"Lattice", LATTICE_BINDING}, {"Image", IMAGE_BINDING}
+	};
+
+	for (const auto& block : blocks)
+	{
+		auto index = glGetUniformBlockIndex(program, block.first);
+		if (index != GL_INVALID_INDEX)
+			glUniformBlockBinding(program, index, block.second);
+	}
+}
+
+} // namespace
+
+App::App(const Options& options) :
 	clear_color_           (0.1, 0.1, 0.1),
 	screen_center_         (0.5, 0.5),
 	pixels_per_unit_       (300.0),
@@ -15,6 +148,8 @@ App::App(int /* argc */, char** /* argv */) :
 
 	show_symmetry_frame_   (true),
 	show_result_           (true),
+	fold_analytically_     (false),
+	use_fold_table_        (false),
 
 	show_object_settings_  (true),
 	show_view_settings_    (false),
@@ -22,11 +157,30 @@ App::App(int /* argc */, char** /* argv */) :
 
 	export_width_          (1600),
 	export_height_         (1200),
-
-	window_                (1440, 900, "symmetrifier"),
+	memory_budget_mb_      (Residency::get().budget() / (1024 * 1024)),
+	domain_quality_        (1.0f),
+	full_domain_resolution_(false),
+	show_profiler_         (false),
+	options_               (options),
+	replay_                (options_.replay_file, options_.replay_step),
+	domain_lod_            (0),
+	last_interaction_time_ (0.0),
+
+	window_                (replay_.active() ? replay_.width()  : 1440,
+	                        replay_.active() ? replay_.height() : 900,
+	                        "symmetrifier", !options_.headless()),
 	time_                  ( (glfwSetTime(0), glfwGetTime()) ),
-	gui_                   (window_, layering_)
+	gui_                   (window_, layering_),
+	view_block_            (sizeof(ViewBlock)),
+	lattice_blocks_        (sizeof(LatticeBlock)),
+	image_blocks_          (sizeof(ImageBlock))
 {
+	Trace::set_thread_name("Main");
+
+	// Bring in every program up front, from the binary cache when
+	// possible, so no pass hitches on first use.
+	preload_programs();
+
 	// Load example settings.
 	auto& layer = layering_.current_layer();
 	layer.tiling().set_symmetry_group("333");
@@ -45,11 +199,16 @@ App::App(int /* argc */, char** /* argv */) :
 	gui_.pixels_per_unit_.track(pixels_per_unit_);
 	gui_.frame_visible_.track(show_symmetry_frame_);
 	gui_.result_visible_.track(show_result_);
+	gui_.fold_analytically_.track(fold_analytically_);
+	gui_.use_fold_table_.track(use_fold_table_);
 	gui_.object_settings_visible_.track(show_object_settings_);
 	gui_.view_settings_visible_.track(show_view_settings_);
 	gui_.export_settings_visible_.track(show_export_settings_);
 	gui_.export_width_.track(export_width_);
 	gui_.export_height_.track(export_height_);
+	gui_.memory_budget_mb_.track(memory_budget_mb_);
+	gui_.domain_quality_.track(domain_quality_);
+	gui_.profiler_visible_.track(show_profiler_);
 
 	// Set input callbacks.
 	gui_.set_export_callback          (&App::export_result, this);
@@ -59,58 +218,136 @@ App::App(int /* argc */, char** /* argv */) :
 	window_.add_key_callback          (&App::keyboard_callback, this);
 	window_.add_path_drop_callback    (&App::path_drop_callback, this);
 
+	if (!options_.record_file.empty())
+		window_.record(options_.record_file);
+
 	// Disable vsync.
 	glfwSwapInterval(0);
 
 	// "Enable" depth testing and alpha blending.
-	glEnable(GL_DEPTH_TEST);
+	GL::State::enable_depth_test(true);
 	glDepthFunc(GL_ALWAYS);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	GL::State::enable_blend(true);
+	GL::State::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	// This probably doesn't work, but worth asking anyway. :)
 	glEnable(GL_LINE_SMOOTH);
 }
 
-void App::loop(void)
+int App::loop(void)
 {
+	if (replay_.active())
+		replay_.start(window_);
+
 	while (!glfwWindowShouldClose(window_))
 	{
-		time_ = glfwGetTime();
+		auto frame_begin = Trace::now();
+		render_frame();
 
-		int width, height;
-		glfwGetFramebufferSize(window_, &width, &height);
+		// Poll events. Minimum FPS = 15, or faster while refining.
+		double timeout = domain_lod_ > 0 ? REFINE_INTERVAL : 1 / 15.0;
+		if (replay_.active())
+		{
+			// Frame times include the GPU work, not just submitting it.
+			glFinish();
+			replay_.add_frame_time((Trace::now() - frame_begin) / 1e9);
 
-		// Clear the screen. Dark grey is the new black.
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
-		glClearColor(clear_color_.x(), clear_color_.y(), clear_color_.z(), 0);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			if (!replay_.advance(window_, timeout))
+				break;
+		}
+		else
+			glfwWaitEventsTimeout(timeout);
+	}
 
-		render_scene(gui_.graphics_area());
-		gui_.render(width, height);
+	if (replay_.active())
+		replay_.report();
+
+	return 0;
+}
+
+void App::dump_reports(void)
+{
+	if (!options_.trace_file.empty())
+		dump_trace(options_.trace_file);
+	if (!options_.memory_file.empty())
+		MemoryReport::write(options_.memory_file, layering_);
+}
+
+void App::set_view(const Eigen::Vector2f& center, double pixels_per_unit)
+{
+	screen_center_   = center;
+	pixels_per_unit_ = pixels_per_unit;
+}
+
+void App::set_overlays_visible(bool visible)
+{
+	show_symmetry_frame_  = visible;
+	show_export_settings_ = visible;
+}
+
+// Of every layer, at the resolution it's drawn at.
+void App::rebuild_domains(void)
+{
+	for (size_t i = 0; i < layering_.size(); ++i)
+	{
+		auto& layer = layering_.layer(i);
+		layer.set_inconsistent();
+		layer.domain_texture(domain_resolution(layer));
+	}
+}
+
+void App::render_frame(void)
+{
+	time_ = window_.time();
+
+	// GPU timing costs queries, so it only runs when someone's looking.
+	auto& profiler = Profiler::get();
+	profiler.set_enabled(show_profiler_ || !options_.trace_file.empty());
+	profiler.begin_frame();
+
+	int width, height;
+	glfwGetFramebufferSize(window_, &width, &height);
+
+	// Clear the screen. Dark grey is the new black.
+	GL::State::bind_framebuffer(GL_FRAMEBUFFER, 0);
+	glClearColor(clear_color_.x(), clear_color_.y(), clear_color_.z(), 0);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		// Show the result on screen.
-		glfwSwapBuffers(window_);
+	restore_textures();
+	refine_domain();
 
-		// Poll events. Minimum FPS = 15.
-		glfwWaitEventsTimeout(1 / 15.0);
+	render_scene(gui_.graphics_area());
+	{
+		Profiler::Zone zone("ImGui");
+		gui_.render(width, height);
 	}
+
+	// Show the result on screen.
+	glfwSwapBuffers(window_);
+	GL::State::end_frame();
+	profiler.end_frame();
+
+	enforce_memory_budget();
 }
 
 void App::render_scene(const Rectangle<int>& viewport, GLuint framebuffer)
 {
+	update_uniform_blocks(viewport);
+
 	const auto& current_layer = layering_.current_layer();
 
 	if (show_result_)
 	{
 		for (const auto& layer : layering_)
 		{
-			if (layer.visible())
+			if (layer.visible() && fold_analytically_)
+				render_layer_folded(layer, viewport, framebuffer);
+			else if (layer.visible())
 				render_layer(layer, viewport, framebuffer);
 		}
 
 		if (show_symmetry_frame_)
-			render_symmetry_frame(current_layer.tiling(), viewport, framebuffer);
+			render_symmetry_frame(current_layer, viewport, framebuffer);
 
 		if (show_export_settings_)
 			render_export_frame(viewport, framebuffer);
@@ -124,248 +361,324 @@ void App::render_scene(const Rectangle<int>& viewport, GLuint framebuffer)
 		}
 
 		// Always render frame when not showing the result.
-		render_symmetry_frame(current_layer.tiling(), viewport, framebuffer);
+		render_symmetry_frame(current_layer, viewport, framebuffer);
 	}
 }
 
+void App::update_uniform_blocks(const Rectangle<int>& viewport)
+{
+	ViewBlock view = {
+		{viewport.x, viewport.y, viewport.width, viewport.height},
+		{screen_center_.x(), screen_center_.y()},
+		(float)pixels_per_unit_,
+		0.0f
+	};
+
+	view_block_.clear();
+	view_block_.push(view);
+	view_block_.upload();
+	view_block_.bind(VIEW_BINDING, 0);
+
+	lattice_blocks_.clear();
+	image_blocks_.clear();
+	first_image_block_.clear();
+
+	for (const auto& layer : layering_)
+	{
+		const auto& tiling = layer.tiling();
+
+		Eigen::Vector2f position = layer.to_world(tiling.position());
+		Eigen::Matrix2f basis;
+		basis << layer.to_world_direction(tiling.t1()), layer.to_world_direction(tiling.t2());
+		Eigen::Matrix2f basis_inv = basis.inverse();
+
+		LatticeBlock lattice = {
+			{position.x(), position.y()},
+			{basis(0, 0), basis(1, 0)},
+			{basis(0, 1), basis(1, 1)},
+			tiling.lattice_side(),
+			0,
+			{{basis_inv(0, 0), basis_inv(1, 0), 0.0f, 0.0f},
+			 {basis_inv(0, 1), basis_inv(1, 1), 0.0f, 0.0f}}
+		};
+		lattice_blocks_.push(lattice);
+
+		first_image_block_.push_back(image_blocks_.size());
+		for (const auto& image : layer)
+		{
+			Eigen::Vector2f image_position = layer.to_world(image.position());
+			Eigen::Vector2f image_t1       = layer.to_world_direction(image.t1());
+			Eigen::Vector2f image_t2       = layer.to_world_direction(image.t2());
+
+			ImageBlock block = {
+				{image_position.x(), image_position.y()},
+				{image_t1.x(), image_t1.y()},
+				{image_t2.x(), image_t2.y()},
+				{0.0f, 0.0f}
+			};
+			image_blocks_.push(block);
+		}
+	}
+
+	lattice_blocks_.upload();
+	image_blocks_.upload();
+}
+
+size_t App::layer_index(const Layer& layer) const
+{
+	return &layer - &layering_.layer(0);
+}
+
 void App::render_layer(const Layer& layer, const Rectangle<int>& viewport, GLuint framebuffer)
 {
-	static auto shader = GL::ShaderProgram::from_files(
-		"shaders/tiling_vert.glsl",
-		"shaders/tiling_frag.glsl");
+	Profiler::Zone zone("render_layer", layer_index(layer));
+
+	static const auto& shader = ProgramCache::get().program(TILING_PROGRAM);
 
 	// Find uniform locations once.
 	static GLuint instance_num_uniform;
-	static GLuint position_uniform;
-	static GLuint t1_uniform;
-	static GLuint t2_uniform;
-	static GLuint viewport_size_uniform;
-	static GLuint view_center_uniform;
-	static GLuint pixels_per_unit_uniform;
 	static GLuint texture_coordinate_uniform;
 	static GLuint texture_sampler_uniform;
 	static bool init = [&](){
+		bind_uniform_blocks(shader);
 		instance_num_uniform       = glGetUniformLocation(shader, "uNumInstances");
-		position_uniform           = glGetUniformLocation(shader, "uPos");
-		t1_uniform                 = glGetUniformLocation(shader, "uT1");
-		t2_uniform                 = glGetUniformLocation(shader, "uT2");
-		viewport_size_uniform      = glGetUniformLocation(shader, "uScreenSize");
-		view_center_uniform        = glGetUniformLocation(shader, "uScreenCenter");
-		pixels_per_unit_uniform    = glGetUniformLocation(shader, "uPixelsPerUnit");
 		texture_coordinate_uniform = glGetUniformLocation(shader, "uTexCoords");
 		texture_sampler_uniform    = glGetUniformLocation(shader, "uTextureSampler");
 		return true;
 	}();
 	(void)init; // Suppress unused variable warning.
 
-	const auto& domain_texture = layer.domain_texture();
+	const auto& domain_texture = layer.domain_texture(domain_resolution(layer));
 
-	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	GL::State::bind_framebuffer(GL_FRAMEBUFFER, framebuffer);
 
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, domain_texture);
+	GL::State::active_texture(GL_TEXTURE1);
+	GL::State::bind_texture(GL_TEXTURE_2D, domain_texture);
 
-	glViewport(viewport.x, viewport.y, viewport.width, viewport.height);
+	GL::State::viewport(viewport.x, viewport.y, viewport.width, viewport.height);
 
 	const auto plane_side_length = 10;
 	const auto num_instances = plane_side_length * plane_side_length;
 
 	// Set the shader program and uniforms, and draw.
-	glUseProgram(shader);
-
-	const auto& tiling = layer.tiling();
-
-	const auto& tiling_position = layer.to_world(tiling.position());
-	const auto& tiling_t1       = layer.to_world_direction(tiling.t1());
-	const auto& tiling_t2       = layer.to_world_direction(tiling.t2());
+	GL::State::use_program(shader);
+	lattice_blocks_.bind(LATTICE_BINDING, layer_index(layer));
 
 	glUniform1i  (instance_num_uniform, num_instances);
-	glUniform2fv (position_uniform, 1, tiling_position.data());
-	glUniform2fv (t1_uniform, 1, tiling_t1.data());
-	glUniform2fv (t2_uniform, 1, tiling_t2.data());
-	glUniform2i  (viewport_size_uniform, viewport.width, viewport.height);
-	glUniform2fv (view_center_uniform, 1, screen_center_.data());
-	glUniform1f  (pixels_per_unit_uniform, pixels_per_unit_);
 	glUniform2fv (texture_coordinate_uniform, 6, layer.domain_coordinates()[0].data());
 	glUniform1i  (texture_sampler_uniform, 1);
 
-	const auto& mesh = tiling.mesh();
+	MeshArena::get().draw(layer.tiling().mesh(), num_instances);
+}
 
-	glBindVertexArray(mesh.vao_);
-	glDrawArraysInstanced(mesh.primitive_type_, 0, mesh.num_vertices_, num_instances);
+void App::render_layer_folded(const Layer& layer, const Rectangle<int>& viewport, GLuint framebuffer)
+{
+	Profiler::Zone zone("render_layer_folded", layer_index(layer));
+
+	// The fold is compiled in, so there's a program for each symmetry group,
+	// plus one generic program that fetches the whole fold from a fold table.
+	struct FoldShader
+	{
+		GLuint            program;
+		GLuint            texture_coordinate_uniform;
+		GLuint            texture_sampler_uniform;
+		GLuint            fold_table_uniform;
+		GLuint            jacobians_uniform;
+	};
+	static std::unordered_map<std::string, FoldShader> shaders;
+
+	const auto& tiling = layer.tiling();
+
+	// Group names never start with a '#'.
+	auto key      = use_fold_table_ ? std::string("#table") : tiling.symmetry_group();
+	auto inserted = shaders.emplace(key, FoldShader());
+	auto& shader  = inserted.first->second;
+
+	if (inserted.second)
+	{
+		shader.program = ProgramCache::get().program(fold_program(use_fold_table_ ? nullptr : &tiling));
+
+		// Find uniform locations once.
+		bind_uniform_blocks(shader.program);
+		shader.texture_coordinate_uniform = glGetUniformLocation(shader.program, "uTexCoords");
+		shader.texture_sampler_uniform    = glGetUniformLocation(shader.program, "uTextureSampler");
+		shader.fold_table_uniform         = glGetUniformLocation(shader.program, "uFoldTable");
+		shader.jacobians_uniform          = glGetUniformLocation(shader.program, "uJacobians");
+	}
+
+	const auto& domain_texture = layer.domain_texture(domain_resolution(layer));
+
+	GL::State::bind_framebuffer(GL_FRAMEBUFFER, framebuffer);
+
+	GL::State::active_texture(GL_TEXTURE1);
+	GL::State::bind_texture(GL_TEXTURE_2D, domain_texture);
+
+	GL::State::viewport(viewport.x, viewport.y, viewport.width, viewport.height);
+
+	// Set the shader program and uniforms, and draw.
+	GL::State::use_program(shader.program);
+	lattice_blocks_.bind(LATTICE_BINDING, layer_index(layer));
+
+	glUniform2fv       (shader.texture_coordinate_uniform, 6, layer.domain_coordinates()[0].data());
+	glUniform1i        (shader.texture_sampler_uniform, 1);
+
+	if (use_fold_table_)
+	{
+		const auto& table = FoldTable::get(layer);
+
+		GL::State::active_texture(GL_TEXTURE2);
+		GL::State::bind_texture(GL_TEXTURE_2D, table.texture());
+
+		glUniform1i        (shader.fold_table_uniform, 2);
+		glUniformMatrix2fv (shader.jacobians_uniform, table.num_triangles(), GL_FALSE, table.jacobians()[0].data());
+	}
+
+	// A single triangle covers the viewport; no geometry is needed.
+	GL::State::bind_vao(canvas_.vao_);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	Profiler::get().count_draw(GL_TRIANGLES, 3);
 }
 
 void App::render_layer_images(const Layer& layer, const Rectangle<int>& viewport, GLuint framebuffer)
 {
-	static auto shader = GL::ShaderProgram::from_files(
-		"shaders/image_vert.glsl",
-		"shaders/image_frag.glsl");
+	Profiler::Zone zone("render_layer_images", layer_index(layer));
+
+	static const auto& shader = ProgramCache::get().program(IMAGE_PROGRAM);
 
 	// Find uniform locations once.
-	static GLuint viewport_size_uniform;
-	static GLuint view_center_uniform;
-	static GLuint image_position_uniform;
-	static GLuint image_t1_uniform;
-	static GLuint image_t2_uniform;
-	static GLuint pixels_per_unit_uniform;
 	static GLuint texture_sampler_uniform;
 	static bool init = [&](){
-		viewport_size_uniform   = glGetUniformLocation(shader, "uScreenSize");
-		view_center_uniform     = glGetUniformLocation(shader, "uScreenCenter");
-		image_position_uniform  = glGetUniformLocation(shader, "uImagePos");
-		image_t1_uniform        = glGetUniformLocation(shader, "uImageT1");
-		image_t2_uniform        = glGetUniformLocation(shader, "uImageT2");
-		pixels_per_unit_uniform = glGetUniformLocation(shader, "uPixelsPerUnit");
+		bind_uniform_blocks(shader);
 		texture_sampler_uniform = glGetUniformLocation(shader, "uTextureSampler");
 		return true;
 	}();
 	(void)init; // Suppress unused variable warning.
 
-	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
-	glActiveTexture(GL_TEXTURE1);
+	GL::State::bind_framebuffer(GL_FRAMEBUFFER, framebuffer);
+	GL::State::active_texture(GL_TEXTURE1);
 
-	glViewport(viewport.x, viewport.y, viewport.width, viewport.height);
+	GL::State::viewport(viewport.x, viewport.y, viewport.width, viewport.height);
 
 	// Set the shader program and uniforms, and draw.
-	glUseProgram(shader);
-	glBindVertexArray(canvas_.vao_);
+	GL::State::use_program(shader);
+	GL::State::bind_vao(canvas_.vao_);
 
-	glUniform2i  (viewport_size_uniform, viewport.width, viewport.height);
-	glUniform2fv (view_center_uniform, 1, screen_center_.data());
-	glUniform1f  (pixels_per_unit_uniform, pixels_per_unit_);
 	glUniform1i  (texture_sampler_uniform, 1);
 
+	auto block = first_image_block_[layer_index(layer)];
 	for (const auto& image : layer)
 	{
-		const auto& image_position = layer.to_world(image.position());
-		const auto& image_t1       = layer.to_world_direction(image.t1());
-		const auto& image_t2       = layer.to_world_direction(image.t2());
-
-		glBindTexture(GL_TEXTURE_2D, image.texture());
-
-		glUniform2fv (image_position_uniform, 1, image_position.data());
-		glUniform2fv (image_t1_uniform, 1, image_t1.data());
-		glUniform2fv (image_t2_uniform, 1, image_t2.data());
+		GL::State::bind_texture(GL_TEXTURE_2D, image.texture());
+		image_blocks_.bind(IMAGE_BINDING, block++);
 
 		glDrawArrays(canvas_.primitive_type_, 0, canvas_.num_vertices_);
+		Profiler::get().count_draw(canvas_.primitive_type_, canvas_.num_vertices_);
 	}
 }
 
 void App::render_scene_hq(const Rectangle<int>& viewport, GLuint framebuffer)
 {
-	static auto shader = GL::ShaderProgram::from_files(
-		"shaders/tiling_hq_vert.glsl",
-		"shaders/tiling_hq_frag.glsl");
+	static const auto& shader = ProgramCache::get().program(TILING_HQ_PROGRAM);
 
 	// Find uniform locations once.
 	static GLuint instance_num_uniform;
-	static GLuint frame_position_uniform;
-	static GLuint t1_uniform;
-	static GLuint t2_uniform;
-	static GLuint viewport_size_uniform;
-	static GLuint view_center_uniform;
 	static GLuint image_position_uniform;
 	static GLuint image_t1_uniform;
 	static GLuint image_t2_uniform;
-	static GLuint pixels_per_unit_uniform;
-	static GLuint num_domains_uniform;
-	static GLuint mesh_sampler_uniform;
+	static GLuint num_vertices_uniform;
+	static GLuint vertices_uniform;
 	static GLuint texture_sampler_uniform;
 	static bool init = [&](){
+		bind_uniform_blocks(shader);
 		instance_num_uniform       = glGetUniformLocation(shader, "uNumInstances");
-		frame_position_uniform     = glGetUniformLocation(shader, "uFramePos");
-		t1_uniform                 = glGetUniformLocation(shader, "uT1");
-		t2_uniform                 = glGetUniformLocation(shader, "uT2");
-		viewport_size_uniform      = glGetUniformLocation(shader, "uScreenSize");
-		view_center_uniform        = glGetUniformLocation(shader, "uScreenCenter");
 		image_position_uniform     = glGetUniformLocation(shader, "uImagePos");
 		image_t1_uniform           = glGetUniformLocation(shader, "uImageT1");
 		image_t2_uniform           = glGetUniformLocation(shader, "uImageT2");
-		pixels_per_unit_uniform    = glGetUniformLocation(shader, "uPixelsPerUnit");
-		num_domains_uniform        = glGetUniformLocation(shader, "uNumSymmetryDomains");
-		mesh_sampler_uniform       = glGetUniformLocation(shader, "uMeshSampler");
+		num_vertices_uniform       = glGetUniformLocation(shader, "uNumVertices");
+		vertices_uniform           = glGetUniformLocation(shader, "uVertices");
 		texture_sampler_uniform    = glGetUniformLocation(shader, "uTextureSampler");
 		return true;
 	}();
 	(void)init; // Suppress unused variable warning.
 
-	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	update_uniform_blocks(viewport);
+
+	GL::State::bind_framebuffer(GL_FRAMEBUFFER, framebuffer);
 
-	glViewport(viewport.x, viewport.y, viewport.width, viewport.height);
+	GL::State::viewport(viewport.x, viewport.y, viewport.width, viewport.height);
 
 	const auto plane_side_length = 10;
 	const auto num_instances     = plane_side_length * plane_side_length;
 
-	// Set the shader program and uniforms, and draw.
-	glUseProgram(shader);
-
-	glUniform1i  (instance_num_uniform, num_instances);
-	glUniform2i  (viewport_size_uniform, viewport.width, viewport.height);
-	glUniform2fv (view_center_uniform, 1, screen_center_.data());
-	glUniform1f  (pixels_per_unit_uniform, pixels_per_unit_);
-	glUniform1i  (texture_sampler_uniform, 1);
-	glUniform1i  (mesh_sampler_uniform, 2);
-
 	for (const auto& layer : layering_)
 	{
+		// With a fold table, a layer is a single fetch from its full-resolution
+		// domain texture, as on screen, instead of a walk over the whole orbit.
+		if (fold_analytically_ && use_fold_table_)
+		{
+			render_layer_folded(layer, viewport, framebuffer);
+			continue;
+		}
+
 		const auto& tiling = layer.tiling();
-		const auto& mesh   = tiling.mesh();
+		const auto& info   = Wallpaper::info(tiling.group());
 
-		glBindVertexArray(mesh.vao_);
+		// Set the shader program and uniforms, and draw.
+		GL::State::use_program(shader);
 
-		glActiveTexture(GL_TEXTURE2);
-		glBindTexture(GL_TEXTURE_BUFFER, tiling.mesh_texture());
-		glActiveTexture(GL_TEXTURE1);
+		glUniform1i  (instance_num_uniform, num_instances);
+		glUniform1i  (texture_sampler_uniform, 1);
 
-		const auto& tiling_position = layer.to_world(tiling.position());
-		const auto& tiling_t1       = layer.to_world_direction(tiling.t1());
-		const auto& tiling_t2       = layer.to_world_direction(tiling.t2());
+		GL::State::active_texture(GL_TEXTURE1);
+		lattice_blocks_.bind(LATTICE_BINDING, layer_index(layer));
 
-		glUniform2fv (frame_position_uniform, 1, tiling_position.data());
-		glUniform2fv (t1_uniform, 1, tiling_t1.data());
-		glUniform2fv (t2_uniform, 1, tiling_t2.data());
-		glUniform1i  (num_domains_uniform, tiling.num_symmetry_domains());
+		glUniform1i  (num_vertices_uniform, info.num_vertices);
+		glUniform2fv (vertices_uniform, info.num_vertices, &info.triangles[0].x);
+
+		// Sources are only sampled within the lattice region.
+		Eigen::Matrix2f lattice_basis;
+		lattice_basis << tiling.t1(), tiling.t2();
+
+		auto offsets = tiling.lattice_offsets();
+		Eigen::AlignedBox2f lattice_region(offsets.min(), offsets.max() + Eigen::Vector2f::Ones());
+
+		Eigen::AlignedBox2f region;
+		for (int i = 0; i < 4; ++i)
+			region.extend(tiling.position() + lattice_basis * lattice_region.corner((Eigen::AlignedBox2f::CornerType)i));
+
+		auto texels_per_unit = pixels_per_unit_ * layer.t1().norm();
 
 		for (const auto& image : layer)
 		{
-			const auto& image_position = layer.to_world(image.position());
-			const auto& image_t1       = layer.to_world_direction(image.t1());
-			const auto& image_t2       = layer.to_world_direction(image.t2());
+			auto view = image.view(region, texels_per_unit);
 
-			glBindTexture(GL_TEXTURE_2D, image.texture());
+			const auto& image_position = layer.to_world(view.position);
+			const auto& image_t1       = layer.to_world_direction(view.t1);
+			const auto& image_t2       = layer.to_world_direction(view.t2);
+
+			GL::State::bind_texture(GL_TEXTURE_2D, *view.texture);
 
 			glUniform2fv (image_position_uniform, 1, image_position.data());
 			glUniform2fv (image_t1_uniform, 1, image_t1.data());
 			glUniform2fv (image_t2_uniform, 1, image_t2.data());
 
-			glDrawArraysInstanced(mesh.primitive_type_, 0, mesh.num_vertices_, num_instances);
+			MeshArena::get().draw(tiling.mesh(), num_instances);
 		}
 	}
 }
 
-void App::render_symmetry_frame(const Tiling& tiling, const Rectangle<int>& viewport, GLuint framebuffer)
+void App::render_symmetry_frame(const Layer& layer, const Rectangle<int>& viewport, GLuint framebuffer)
 {
-	static auto shader = GL::ShaderProgram::from_files(
-		"shaders/frame_vert.glsl",
-		"shaders/frame_frag.glsl");
+	Profiler::Zone zone("render_symmetry_frame");
+
+	static const auto& shader = ProgramCache::get().program(FRAME_PROGRAM);
 
 	// Find uniform locations once.
 	static GLuint instance_num_uniform;
-	static GLuint position_uniform;
-	static GLuint t1_uniform;
-	static GLuint t2_uniform;
-	static GLuint viewport_size_uniform;
-	static GLuint view_center_uniform;
-	static GLuint pixels_per_unit_uniform;
 	static GLuint render_overlay_uniform;
 	static bool init = [&](){
+		bind_uniform_blocks(shader);
 		instance_num_uniform    = glGetUniformLocation(shader, "uNumInstances");
-		position_uniform        = glGetUniformLocation(shader, "uPos");
-		t1_uniform              = glGetUniformLocation(shader, "uT1");
-		t2_uniform              = glGetUniformLocation(shader, "uT2");
-		viewport_size_uniform   = glGetUniformLocation(shader, "uScreenSize");
-		view_center_uniform     = glGetUniformLocation(shader, "uScreenCenter");
-		pixels_per_unit_uniform = glGetUniformLocation(shader, "uPixelsPerUnit");
 		render_overlay_uniform  = glGetUniformLocation(shader, "uRenderOverlay");
 		return true;
 	}();
@@ -383,42 +696,37 @@ void App::render_symmetry_frame(const Tiling& tiling, const Rectangle<int>& view
 	}();
 	(void)init_overlay;
 
-	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
-	glViewport(viewport.x, viewport.y, viewport.width, viewport.height);
+	GL::State::bind_framebuffer(GL_FRAMEBUFFER, framebuffer);
+	GL::State::viewport(viewport.x, viewport.y, viewport.width, viewport.height);
+
+	const auto& tiling = layer.tiling();
 
 	const auto plane_side_length = 10;
 	const auto num_instances = show_result_ ? plane_side_length * plane_side_length : tiling.num_lattice_domains();
 
 	// Set the shader program and uniforms, and draw.
-	glUseProgram(shader);
+	GL::State::use_program(shader);
 
 	glUniform1i  (instance_num_uniform, num_instances);
-	glUniform2fv (position_uniform, 1, tiling.position().data());
-	glUniform2fv (t1_uniform, 1, tiling.t1().data());
-	glUniform2fv (t2_uniform, 1, tiling.t2().data());
-	glUniform2i  (viewport_size_uniform, viewport.width, viewport.height);
-	glUniform2fv (view_center_uniform, 1, screen_center_.data());
-	glUniform1f  (pixels_per_unit_uniform, pixels_per_unit_);
 	glUniform1i  (render_overlay_uniform, GL_FALSE);
 
-	const auto& frame = tiling.frame();
+	lattice_blocks_.bind(LATTICE_BINDING, layer_index(layer));
 
-	glBindVertexArray(frame.vao_);
-	glDrawArraysInstanced(GL_LINES, 0, frame.num_vertices_, num_instances);
+	MeshArena::get().draw(tiling.frame(), num_instances);
 
 	glUniform1i  (instance_num_uniform, tiling.num_lattice_domains());
 	glUniform1i  (render_overlay_uniform, GL_TRUE);
 
-	glBindVertexArray(overlay.vao_);
+	GL::State::bind_vao(overlay.vao_);
 	glDrawArraysInstanced(overlay.primitive_type_, 0, overlay.num_vertices_, tiling.num_lattice_domains());
+	Profiler::get().count_draw(overlay.primitive_type_, overlay.num_vertices_, tiling.num_lattice_domains());
 }
 
 void App::render_export_frame(const Rectangle<int>& viewport, GLuint framebuffer)
 {
-	static auto shader = GL::ShaderProgram(
-		GL::ShaderObject::vertex_passthrough(),
-		GL::ShaderObject::from_file(GL_FRAGMENT_SHADER, "shaders/crop_frag.glsl")
-	);
+	Profiler::Zone zone("render_export_frame");
+
+	static const auto& shader = ProgramCache::get().program(CROP_PROGRAM);
 
 	// Find uniform locations once.
 	static GLuint viewport_uniform;
@@ -443,18 +751,72 @@ void App::render_export_frame(const Rectangle<int>& viewport, GLuint framebuffer
 	else
 		stripe_size = viewport.height * crop_AR;
 
-	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	GL::State::bind_framebuffer(GL_FRAMEBUFFER, framebuffer);
 
-	glViewport(viewport.x, viewport.y, viewport.width, viewport.height);
+	GL::State::viewport(viewport.x, viewport.y, viewport.width, viewport.height);
 
-	glUseProgram(shader);
+	GL::State::use_program(shader);
 
 	glUniform4i (viewport_uniform, viewport.x, viewport.y, viewport.width, viewport.height);
 	glUniform1f (stripe_size_uniform, stripe_size);
 	glUniform1i (vertical_crop_uniform, crop_AR > AR);
 
-	glBindVertexArray(canvas_.vao_);
+	GL::State::bind_vao(canvas_.vao_);
 	glDrawArrays(canvas_.primitive_type_, 0, canvas_.num_vertices_);
+	Profiler::get().count_draw(canvas_.primitive_type_, canvas_.num_vertices_);
+}
+
+GL::Texture App::render_export(int export_width, int export_height)
+{
+	const auto& view = gui_.graphics_area();
+
+	// We want to keep the zoom level irrespective of resolution chosen.
+	double ppu_old = pixels_per_unit_;
+	pixels_per_unit_ = std::max(export_width / (float)view.width,
+	                            export_height / (float)view.height) * ppu_old;
+
+	auto texture = render_offscreen(export_width, export_height, true);
+
+	pixels_per_unit_ = ppu_old;
+
+	return texture;
+}
+
+GL::Texture App::render_offscreen(int width, int height, bool hq)
+{
+	auto texture = GL::Texture::empty_2D(width, height, MemoryUsage::EXPORT);
+	auto depth   = GL::Texture::empty_2D_depth(width, height, MemoryUsage::EXPORT);
+	auto fbo     = GL::FBO::simple_C0D(texture, depth);
+
+	// We don't want transparency in the resulting PNG.
+	// Thus we set the clear color alpha to 1 and change our blending function
+	// to prefer destination alpha (this is the clear color alpha, i.e. 1).
+	glClearColor(clear_color_.x(), clear_color_.y(), clear_color_.z(), 1);
+	GL::clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT, fbo);
+	GL::State::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ZERO, GL_ONE);
+
+	if (hq)
+	{
+		// Exports sample every image at full resolution.
+		for (const auto& layer : layering_)
+		{
+			for (const auto& image : layer)
+				image.texture();
+		}
+		restore_textures();
+
+		// Whatever needs a domain texture during export gets it at full resolution.
+		full_domain_resolution_ = true;
+		render_scene_hq({0, 0, width, height}, fbo);
+		full_domain_resolution_ = false;
+	}
+	else
+		render_scene({0, 0, width, height}, fbo);
+
+	// Reset the blending function.
+	GL::State::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	return texture;
 }
 
 void App::mouse_position_callback(double x, double y)
@@ -462,7 +824,7 @@ void App::mouse_position_callback(double x, double y)
 	if (gui_.capturing_mouse())
 		return;
 
-	if (glfwGetMouseButton(window_, GLFW_MOUSE_BUTTON_LEFT) != GLFW_PRESS)
+	if (!window_.mouse_button_down(GLFW_MOUSE_BUTTON_LEFT))
 		return;
 
 	auto& layer = layering_.current_layer();
@@ -472,16 +834,20 @@ void App::mouse_position_callback(double x, double y)
 	const auto& layer_drag = layer.from_world_direction(drag_position);
 
 	// Move object.
-	if (glfwGetKey(window_, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS)
+	if (window_.key_down(GLFW_KEY_LEFT_CONTROL))
 	{
+		mark_interaction();
+
 		if (layer.has_current_image())
 			layer.current_image().set_position(object_static_position_ + layer_drag);
 		else
 			layer.tiling().set_position(object_static_position_ + layer_drag);
 	}
 	// Rotate object.
-	else if (glfwGetKey(window_, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS)
+	else if (window_.key_down(GLFW_KEY_LEFT_SHIFT))
 	{
+		mark_interaction();
+
 		const auto& world_press_position = view_to_world(press_position_);
 		const auto& world_position = screen_to_world(x, y);
 
@@ -516,11 +882,14 @@ void App::mouse_position_callback(double x, double y)
 		}
 	}
 	// Deform object.
-	else if (glfwGetKey(window_, GLFW_KEY_LEFT_ALT) == GLFW_PRESS)
+	else if (window_.key_down(GLFW_KEY_LEFT_ALT))
 	{
 		// TODO: Image deformations.
 		if (!layer.has_current_image())
+		{
+			mark_interaction();
 			layer.tiling().deform(layer_drag);
+		}
 	}
 	// Move view.
 	else
@@ -535,7 +904,7 @@ void App::mouse_button_callback(int /* button */, int action, int /* mods */)
 	auto& layer = layering_.current_layer();
 
 	double x, y;
-	glfwGetCursorPos(window_, &x, &y);
+	window_.cursor_position(x, y);
 	press_position_ = screen_to_view(x, y);
 
 	screen_center_static_position_ = screen_center_;
@@ -561,8 +930,10 @@ void App::mouse_scroll_callback(double /* x_offset */, double y_offset)
 	auto& layer         = layering_.current_layer();
 	const auto& ctiling = layer.as_const().tiling();
 
-	if (glfwGetKey(window_, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS)
+	if (window_.key_down(GLFW_KEY_LEFT_CONTROL))
 	{
+		mark_interaction();
+
 		if (layer.has_current_image())
 		{
 			const auto& cimage = layer.as_const().current_image();
@@ -607,6 +978,8 @@ void App::keyboard_callback(int key, int /* scancode */, int action, int mods)
 		layering_.current_layer().tiling().set_num_lattice_domains(4);
 	else if (key == GLFW_KEY_3)
 		layering_.current_layer().tiling().set_num_lattice_domains(9);
+	else if (key == GLFW_KEY_4)
+		layering_.current_layer().tiling().set_num_lattice_domains(16);
 
 	else if (key == GLFW_KEY_S)
 		show_object_settings_ ^= true;
@@ -619,6 +992,21 @@ void App::keyboard_callback(int key, int /* scancode */, int action, int mods)
 		next_layer_object();
 	else if (key == GLFW_KEY_A)
 		previous_layer_object();
+
+	else if (key == GLFW_KEY_F11)
+	{
+		char name[64];
+		auto now = std::time(nullptr);
+		std::strftime(name, sizeof(name), "memory_%Y%m%d_%H%M%S.json", std::localtime(&now));
+		MemoryReport::write(name, layering_);
+	}
+	else if (key == GLFW_KEY_F12)
+	{
+		char name[64];
+		auto now = std::time(nullptr);
+		std::strftime(name, sizeof(name), "trace_%Y%m%d_%H%M%S.json", std::localtime(&now));
+		dump_trace(name);
+	}
 }
 
 void App::path_drop_callback(int count, const char** paths)
@@ -638,8 +1026,9 @@ void App::load_layer_image(const char* filename)
 	else
 		basename = path.substr(dir_end + 1);
 
+	// Already loaded files are shared instead of decoded and uploaded again.
 	bool successful = false;
-	auto texture = GL::Texture::from_png(path.c_str(), successful);
+	auto texture = TextureCache::get().load_png(path.c_str(), successful);
 
 	if (!successful)
 		basename = "ERROR";
@@ -702,35 +1091,109 @@ void App::previous_layer_object(void)
 // TODO: Add support to larger exports rendered in smaller tiles.
 void App::export_result(int export_width, int export_height, const char* export_filename)
 {
+	Profiler::Zone zone("export_result");
+
 	printf("Exporting...\n");
 
-	const auto& view = gui_.graphics_area();
+	auto texture = render_export(export_width, export_height);
 
-	auto texture = GL::Texture::empty_2D(export_width, export_height);
-	auto depth   = GL::Texture::empty_2D_depth(export_width, export_height);
-	auto fbo     = GL::FBO::simple_C0D(texture, depth);
+	GL::tex_to_png(texture, export_filename);
+	printf("Export finished (%s)\n", export_filename);
+}
 
-	// We don't want transparency in the resulting PNG.
-	// Thus we set the clear color alpha to 1 and change our blending function
-	// to prefer destination alpha (this is the clear color alpha, i.e. 1).
-	glClearColor(clear_color_.x(), clear_color_.y(), clear_color_.z(), 1);
-	GL::clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT, fbo);
-	glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ZERO, GL_ONE);
+void App::preload_programs(void)
+{
+	auto programs = Layer::programs();
+	for (const auto& program : {TILING_PROGRAM, IMAGE_PROGRAM, TILING_HQ_PROGRAM, FRAME_PROGRAM, CROP_PROGRAM})
+		programs.push_back(program);
 
-	// We want to keep the zoom level irrespective of resolution chosen.
-	double ppu_old = pixels_per_unit_;
-	pixels_per_unit_ = std::max(export_width / (float)view.width,
-	                            export_height / (float)view.height) * ppu_old;
+	// One fold program per group, and the one reading fold tables.
+	Tiling tiling;
+	for (int group = 0; group < Wallpaper::NUM_GROUPS; ++group)
+	{
+		tiling.set_symmetry_group((Wallpaper::Group)group);
+		programs.push_back(fold_program(&tiling));
+	}
+	programs.push_back(fold_program(nullptr));
 
-	render_scene_hq({0, 0, export_width, export_height}, fbo);
+	ProgramCache::get().preload(programs);
+}
 
-	pixels_per_unit_ = ppu_old;
+void App::enforce_memory_budget(void)
+{
+	auto& residency = Residency::get();
+	residency.set_budget((size_t)std::max(memory_budget_mb_, 0) * 1024 * 1024);
 
-	// Reset the blending function.
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	// Domain textures of layers that weren't drawn this frame go first.
+	// They are invisible or the result isn't shown at all.
+	for (const auto& layer : layering_)
+	{
+		if (!residency.over_budget())
+			break;
 
-	GL::tex_to_png(texture, export_filename);
-	printf("Export finished (%s)\n", export_filename);
+		if (layer.last_used_frame() != residency.frame())
+			layer.release_domain_texture();
+	}
+
+	// Then downsample source images that haven't been needed for a while.
+	if (residency.over_budget())
+		TextureCache::get().reduce_idle(residency.excess_bytes());
+
+	residency.next_frame();
+}
+
+// The counterpart of enforce_memory_budget: source images used while
+// downsampled are decoded again, and the domain textures built from
+// them are rebuilt. Done before drawing, so no getter reads files.
+void App::restore_textures(void)
+{
+	if (TextureCache::get().restore_used() == 0)
+		return;
+
+	for (const auto& layer : layering_)
+		layer.refresh_reduced();
+}
+
+// The domain texture needs about as many texels along its side as its
+// longest edge covers pixels on screen, scaled by the quality setting.
+unsigned App::domain_resolution(const Layer& layer)
+{
+	if (full_domain_resolution_)
+		return 0;
+
+	auto pixels = layer.domain_footprint() * pixels_per_unit_ * domain_quality_;
+	if (&layer == &layering_.current_layer())
+		pixels = std::ldexp(pixels, -domain_lod_);
+
+	return (unsigned)std::max(std::ceil(pixels), 1.0);
+}
+
+// Editing the current layer rebuilds its domain texture on every event.
+// Keep those rebuilds cheap until the user stops.
+void App::mark_interaction(void)
+{
+	domain_lod_            = INTERACTION_DOMAIN_LOD;
+	last_interaction_time_ = window_.time();
+}
+
+// Steps the domain texture back up to full quality, one level per
+// REFINE_INTERVAL of idle input.
+void App::refine_domain(void)
+{
+	if (domain_lod_ > 0 && time_ - last_interaction_time_ >= REFINE_INTERVAL)
+	{
+		--domain_lod_;
+		last_interaction_time_ = time_;
+	}
+}
+
+void App::dump_trace(const std::string& path)
+{
+	// GPU times are only measured while the profiler is on.
+	if (!Profiler::get().enabled())
+		printf("The profiler is off, so the trace has no GPU times.\n");
+
+	Trace::dump(path, options_.trace_seconds);
 }
 
 Eigen::Vector2f App::screen_to_view(double x, double y)
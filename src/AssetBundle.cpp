@@ -0,0 +1,378 @@
+#include "AssetBundle.h"
+
+#include "stb_image.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace fs = std::filesystem;
+
+// Used when the build directory has no bundle. Relative to the working
+// directory, like the loose assets.
+#define BUNDLE_FILE    "assets.bundle"
+#define BUNDLE_MAGIC   "SYMASST1"
+#define DATA_ALIGNMENT 16u
+
+//--------------------
+
+namespace
+{
+// The file starts with the header, followed by an entry and its name for
+// every asset, followed by the contents of the assets.
+struct FileHeader
+{
+	char     magic[8];
+	uint32_t num_entries;
+	uint32_t padding;
+};
+
+struct EntryHeader
+{
+	uint32_t name_size;
+	uint32_t padding;
+	uint64_t offset;
+	uint64_t size;
+};
+
+// Atlas contents are the header, the images, and the pixels.
+struct AtlasHeader
+{
+	uint32_t width;
+	uint32_t height;
+	uint32_t num_images;
+	uint32_t padding;
+};
+
+struct AtlasImage
+{
+	char     name[24];
+	uint32_t x, y;
+	uint32_t width, height;
+};
+
+template <typename T>
+void append(std::string& bytes, const T& value)
+{
+	bytes.append((const char*)&value, sizeof(T));
+}
+
+std::string serialize(const AssetBundle::Atlas& atlas)
+{
+	std::string bytes;
+	append(bytes, AtlasHeader{(uint32_t)atlas.width, (uint32_t)atlas.height, (uint32_t)atlas.images.size(), 0});
+
+	for (const auto& image : atlas.images)
+	{
+		AtlasImage record = {};
+		std::strncpy(record.name, image.name.c_str(), sizeof(record.name) - 1);
+		record.x      = image.x;
+		record.y      = image.y;
+		record.width  = image.width;
+		record.height = image.height;
+		append(bytes, record);
+	}
+
+	bytes.append((const char*)atlas.pixels, 4 * (size_t)atlas.width * atlas.height);
+
+	return bytes;
+}
+
+// For a directory, the newest of it and its files.
+fs::file_time_type last_write_time(const fs::path& path)
+{
+	std::error_code error;
+	auto time = fs::last_write_time(path, error);
+	if (error)
+		return fs::file_time_type::min();
+
+	if (fs::is_directory(path, error))
+	{
+		for (const auto& entry : fs::directory_iterator(path, error))
+			time = std::max(time, entry.last_write_time(error));
+	}
+
+	return time;
+}
+
+std::string bundle_path(void)
+{
+#ifdef SYMMETRIFIER_ASSET_BUNDLE
+	std::error_code error;
+	if (fs::exists(SYMMETRIFIER_ASSET_BUNDLE, error))
+		return SYMMETRIFIER_ASSET_BUNDLE;
+#endif
+	return BUNDLE_FILE;
+}
+} // namespace
+
+const AssetBundle& AssetBundle::get(void)
+{
+	static AssetBundle bundle(bundle_path());
+	return bundle;
+}
+
+AssetBundle::AssetBundle(const std::string& path) :
+	file_    (path),
+	written_ (last_write_time(path))
+{
+	// Anything malformed drops the whole bundle in favour of the loose files.
+	if (file_.valid() && !parse())
+	{
+		std::fprintf(stderr, "Asset bundle %s is malformed, using the loose files.\n", path.c_str());
+		entries_.clear();
+		file_ = MappedFile();
+	}
+}
+
+bool AssetBundle::pack(const std::string& path, const std::vector<std::string>& files,
+                       const std::vector<std::string>& atlas_directories)
+{
+	std::vector<std::pair<std::string, std::string>> assets;
+
+	for (const auto& file : files)
+	{
+		std::ifstream stream(file, std::ios::binary);
+		if (!stream)
+		{
+			std::fprintf(stderr, "Could not read %s.\n", file.c_str());
+			return false;
+		}
+
+		assets.emplace_back(file, std::string((std::istreambuf_iterator<char>(stream)),
+		                                      std::istreambuf_iterator<char>()));
+	}
+
+	for (const auto& directory : atlas_directories)
+		assets.emplace_back(directory, serialize(pack_atlas(directory)));
+
+	auto align = [](uint64_t offset) { return (offset + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT; };
+
+	FileHeader header = {};
+	std::memcpy(header.magic, BUNDLE_MAGIC, sizeof(header.magic));
+	header.num_entries = (uint32_t)assets.size();
+
+	uint64_t offset = sizeof(header);
+	for (const auto& asset : assets)
+		offset += sizeof(EntryHeader) + asset.first.size();
+
+	std::string table;
+	append(table, header);
+	for (const auto& asset : assets)
+	{
+		offset = align(offset);
+		append(table, EntryHeader{(uint32_t)asset.first.size(), 0, offset, asset.second.size()});
+		table += asset.first;
+		offset += asset.second.size();
+	}
+
+	// Written aside and moved in place, so that a running instance
+	// keeps its mapping of the old bundle intact.
+	auto temporary = path + ".tmp";
+	{
+		std::ofstream stream(temporary, std::ios::binary);
+		stream.write(table.data(), table.size());
+
+		for (const auto& asset : assets)
+		{
+			auto padding = align(stream.tellp()) - (uint64_t)stream.tellp();
+			stream.write("\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0", padding);
+			stream.write(asset.second.data(), asset.second.size());
+		}
+
+		if (!stream)
+		{
+			std::fprintf(stderr, "Could not write %s.\n", temporary.c_str());
+			return false;
+		}
+	}
+
+	std::error_code error;
+	fs::rename(temporary, path, error);
+	if (error)
+	{
+		std::fprintf(stderr, "Could not replace %s: %s\n", path.c_str(), error.message().c_str());
+		return false;
+	}
+
+	return true;
+}
+
+AssetBundle::Atlas AssetBundle::pack_atlas(const std::string& directory)
+{
+	std::vector<fs::path> paths;
+	std::error_code error;
+	for (const auto& entry : fs::directory_iterator(directory, error))
+	{
+		if (entry.is_regular_file())
+			paths.push_back(entry.path());
+	}
+	std::sort(std::begin(paths), std::end(paths));
+
+	struct Decoded
+	{
+		std::string    name;
+		int            width, height;
+		unsigned char* pixels;
+	};
+
+	std::vector<Decoded> decoded;
+	int cell_size = 1;
+	for (const auto& path : paths)
+	{
+		int width, height, channels;
+		auto pixels = stbi_load(path.string().c_str(), &width, &height, &channels, 4);
+		if (!pixels)
+		{
+			std::fprintf(stderr, "PNG loading failed for %s\nError: %s\n",
+			             path.string().c_str(), stbi_failure_reason());
+			continue;
+		}
+
+		decoded.push_back({path.filename().string(), width, height, pixels});
+		while (cell_size < std::max(width, height))
+			cell_size *= 2;
+	}
+
+	Atlas atlas;
+	atlas.width  = 0;
+	atlas.height = 0;
+	atlas.pixels = nullptr;
+
+	if (decoded.empty())
+		return atlas;
+
+	int columns = (int)std::ceil(std::sqrt((double)decoded.size()));
+	int rows    = ((int)decoded.size() + columns - 1) / columns;
+
+	atlas.width  = columns * cell_size;
+	atlas.height = rows * cell_size;
+	atlas.storage.assign(4 * (size_t)atlas.width * atlas.height, 0);
+	atlas.pixels = atlas.storage.data();
+
+	// Cells run left to right and top to bottom, each image in the top left
+	// corner of its cell. Rows are flipped on the way, like in GL::Texture.
+	for (size_t i = 0; i < decoded.size(); ++i)
+	{
+		const auto& image = decoded[i];
+
+		int x = (int)(i % columns) * cell_size;
+		int y = atlas.height - (int)(i / columns) * cell_size - image.height;
+
+		for (int row = 0; row < image.height; ++row)
+		{
+			auto source = image.pixels + 4 * (size_t)image.width * row;
+			auto target = atlas.storage.data() + 4 * ((size_t)atlas.width * (y + image.height - 1 - row) + x);
+			std::copy(source, source + 4 * image.width, target);
+		}
+
+		atlas.images.push_back({image.name, x, y, image.width, image.height});
+		stbi_image_free(image.pixels);
+	}
+
+	return atlas;
+}
+
+bool AssetBundle::find(const std::string& path, const unsigned char*& data, size_t& size) const
+{
+	auto entry = entries_.find(path);
+	if (entry == std::end(entries_))
+		return false;
+
+#ifndef NDEBUG
+	// Edited since the bundle was packed.
+	if (last_write_time(path) > written_)
+		return false;
+#endif
+
+	data = entry->second.data;
+	size = entry->second.size;
+
+	return true;
+}
+
+std::string AssetBundle::read(const std::string& path) const
+{
+	const unsigned char* data;
+	size_t size;
+	if (find(path, data, size))
+		return std::string((const char*)data, size);
+
+	std::ifstream stream(path, std::ios::binary);
+	return std::string((std::istreambuf_iterator<char>(stream)),
+	                   std::istreambuf_iterator<char>());
+}
+
+AssetBundle::Atlas AssetBundle::atlas(const std::string& directory) const
+{
+	const unsigned char* data;
+	size_t size;
+	if (!find(directory, data, size))
+		return pack_atlas(directory);
+
+	AtlasHeader header;
+	if (size < sizeof(header))
+		return pack_atlas(directory);
+
+	std::memcpy(&header, data, sizeof(header));
+
+	size_t images_size = header.num_images * sizeof(AtlasImage);
+	size_t pixels_size = 4 * (size_t)header.width * header.height;
+	if (size - sizeof(header) < images_size || size - sizeof(header) - images_size < pixels_size)
+		return pack_atlas(directory);
+
+	Atlas atlas;
+	atlas.width  = (int)header.width;
+	atlas.height = (int)header.height;
+	atlas.pixels = data + sizeof(header) + images_size;
+
+	for (uint32_t i = 0; i < header.num_images; ++i)
+	{
+		AtlasImage image;
+		std::memcpy(&image, data + sizeof(header) + i * sizeof(image), sizeof(image));
+		image.name[sizeof(image.name) - 1] = '\0';
+
+		atlas.images.push_back({image.name, (int)image.x, (int)image.y, (int)image.width, (int)image.height});
+	}
+
+	return atlas;
+}
+
+bool AssetBundle::parse(void)
+{
+	auto data = file_.data();
+	auto size = file_.size();
+
+	FileHeader header;
+	if (size < sizeof(header))
+		return false;
+
+	std::memcpy(&header, data, sizeof(header));
+	if (std::memcmp(header.magic, BUNDLE_MAGIC, sizeof(header.magic)) != 0)
+		return false;
+
+	size_t position = sizeof(header);
+	for (uint32_t i = 0; i < header.num_entries; ++i)
+	{
+		EntryHeader entry;
+		if (size - position < sizeof(entry))
+			return false;
+
+		std::memcpy(&entry, data + position, sizeof(entry));
+		position += sizeof(entry);
+
+		if (size - position < entry.name_size || entry.offset > size || size - entry.offset < entry.size)
+			return false;
+
+		std::string name((const char*)data + position, entry.name_size);
+		position += entry.name_size;
+
+		entries_[name] = {data + entry.offset, (size_t)entry.size};
+	}
+
+	return true;
+}
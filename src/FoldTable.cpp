@@ -0,0 +1,108 @@
+#include "FoldTable.h"
+
+#include "GLFunctions.h"
+#include "Layer.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
+// Texels per lattice domain side. Points are carried from the texel
+// centers exactly, but a point near a triangle edge may be carried with
+// the neighboring triangle; the domain texture margins are wide enough
+// to hide that at this resolution.
+#define TABLE_SIZE 512
+
+//--------------------
+
+const FoldTable& FoldTable::get(const Layer& layer)
+{
+	static std::unordered_map<std::string, FoldTable> tables;
+
+	auto key = std::string(layer.tiling().symmetry_group()) + "@" + std::to_string(layer.symmetry_scale());
+
+	auto it = tables.find(key);
+	if (it == std::end(tables))
+		it = tables.emplace(key, FoldTable(layer)).first;
+
+	return it->second;
+}
+
+FoldTable::FoldTable(const Layer& layer)
+{
+	const auto  triangles = layer.tiling().barycentric_maps();
+	const auto& corners   = layer.domain_coordinates();
+
+	// Every symmetry domain consists of two triangles, mapped to the
+	// bottom and top halves of the domain texture, as in fold_frag.glsl.
+	auto origin = [&](size_t t) { return corners[3 * (t % 2)]; };
+	auto e1     = [&](size_t t) { return corners[3 * (t % 2) + 1] - corners[3 * (t % 2)]; };
+	auto e2     = [&](size_t t) { return corners[3 * (t % 2) + 2] - corners[3 * (t % 2)]; };
+
+	for (size_t t = 0; t < triangles.size(); ++t)
+	{
+		const auto& m = triangles[t];
+		Eigen::Vector2f column1 = e1(t) * m[0] + e2(t) * m[1];
+		Eigen::Vector2f column2 = e1(t) * m[2] + e2(t) * m[3];
+
+		jacobians_.push_back({column1.x(), column1.y(), column2.x(), column2.y()});
+	}
+
+	// Same rule as the shader search: the triangle the point is deepest inside.
+	std::vector<float> table(3 * TABLE_SIZE * TABLE_SIZE);
+	for (int y = 0; y < TABLE_SIZE; ++y)
+	{
+		for (int x = 0; x < TABLE_SIZE; ++x)
+		{
+			float px = (x + 0.5f) / TABLE_SIZE;
+			float py = (y + 0.5f) / TABLE_SIZE;
+
+			size_t triangle = 0;
+			float  best     = -1e9f;
+			float  b1 = 0.0f, b2 = 0.0f;
+			for (size_t t = 0; t < triangles.size(); ++t)
+			{
+				const auto& m = triangles[t];
+				float c1 = m[0] * px + m[2] * py + m[4];
+				float c2 = m[1] * px + m[3] * py + m[5];
+
+				float inside = std::min({c1, c2, 1.0f - c1 - c2});
+				if (inside > best)
+				{
+					best     = inside;
+					triangle = t;
+					b1       = c1;
+					b2       = c2;
+				}
+			}
+
+			Eigen::Vector2f coordinates = origin(triangle) + b1 * e1(triangle) + b2 * e2(triangle);
+
+			auto texel = &table[3 * (y * TABLE_SIZE + x)];
+			texel[0] = coordinates.x();
+			texel[1] = coordinates.y();
+			texel[2] = (float)triangle;
+		}
+	}
+
+	GLuint old_tex = GL::State::texture(GL_TEXTURE_2D);
+	GL::State::bind_texture(GL_TEXTURE_2D, texture_);
+
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, TABLE_SIZE, TABLE_SIZE, 0,
+	             GL_RGB, GL_FLOAT, table.data());
+	Profiler::get().count_upload(table.size() * sizeof(float));
+
+	// Texels are fetched exactly. The table repeats with the lattice.
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+	GL::State::bind_texture(GL_TEXTURE_2D, old_tex);
+
+	// Owned before it's sized, so the table never counts as OTHER.
+	texture_.width_  = TABLE_SIZE;
+	texture_.height_ = TABLE_SIZE;
+	texture_.set_owner(MemoryUsage::FOLD_TABLE);
+	texture_.set_bytes(GL::internal_format_size(GL_RGB32F) * TABLE_SIZE * TABLE_SIZE);
+}
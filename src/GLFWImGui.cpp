@@ -1,19 +1,24 @@
 #include "GLFWImGui.h"
 
+#include "GLFunctions.h"
+#include "ProgramCache.h"
+#include "Profiler.h"
 #include "Window.h"
 #include "imgui.h"
+#include <cstring>
 
 #define OFFSETOF(TYPE, ELEMENT) ((size_t)&(((TYPE *)0)->ELEMENT))
 
 
 GLFWImGui::GLFWImGui(MainWindow& window) :
 	window_                  (window),
-	shader_                  (GL::ShaderProgram::from_files(
-		                          "shaders/gui_vert.glsl",
-		                          "shaders/gui_frag.glsl")),
+	stream_                  (MemoryUsage::GUI),
+	shader_                  (ProgramCache::get().program({
+		                          {GL_VERTEX_SHADER,   "shaders/gui_vert.glsl"},
+		                          {GL_FRAGMENT_SHADER, "shaders/gui_frag.glsl"}})),
 	display_size_uniform_    (glGetUniformLocation(shader_, "uDisplaySize")),
 	texture_sampler_uniform_ (glGetUniformLocation(shader_, "uTextureSampler")),
-	time_                    (glfwGetTime()),
+	time_                    (window.time()),
 	left_clicked_            (false),
 	right_clicked_           (false),
 	middle_clicked_          (false),
@@ -68,16 +73,12 @@ GLFWImGui::GLFWImGui(MainWindow& window) :
 	io.GetClipboardTextFn = &GLFWImGui::get_clipboard_text;
 	io.ClipboardUserData = (GLFWwindow*)window_;
 
-	glBindVertexArray(vao_);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-
+	// The attribute pointers are set when rendering, since
+	// the vertices are somewhere else in the stream every frame.
+	GL::State::bind_vao(vao_);
 	glEnableVertexAttribArray(0);
 	glEnableVertexAttribArray(1);
 	glEnableVertexAttribArray(2);
-
-	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid*)OFFSETOF(ImDrawVert, pos));
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid*)OFFSETOF(ImDrawVert, uv));
-	glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert), (GLvoid*)OFFSETOF(ImDrawVert, col));
 }
 
 GLFWImGui::~GLFWImGui(void)
@@ -101,22 +102,22 @@ void GLFWImGui::new_frame(void)
 	io.DisplaySize             = {(float)win_width, (float)win_height};
 	io.DisplayFramebufferScale = {scale_width, scale_height};
 
-	auto current_time = glfwGetTime();
+	auto current_time = window_.time();
 	io.DeltaTime      = (float)(current_time - time_);
 	time_             = current_time;
 
-	if (glfwGetWindowAttrib(window_, GLFW_FOCUSED))
+	if (window_.focused())
 	{
 		double mouse_x, mouse_y;
-		glfwGetCursorPos(window_, &mouse_x, &mouse_y);
+		window_.cursor_position(mouse_x, mouse_y);
 		io.MousePos = {(float)mouse_x, (float)mouse_y};
 	}
 	else
 		io.MousePos = {-1, -1};
 
-	io.MouseDown[GLFW_MOUSE_BUTTON_LEFT]   = left_clicked_   || glfwGetMouseButton(window_, GLFW_MOUSE_BUTTON_LEFT);
-	io.MouseDown[GLFW_MOUSE_BUTTON_RIGHT]  = right_clicked_  || glfwGetMouseButton(window_, GLFW_MOUSE_BUTTON_RIGHT);
-	io.MouseDown[GLFW_MOUSE_BUTTON_MIDDLE] = middle_clicked_ || glfwGetMouseButton(window_, GLFW_MOUSE_BUTTON_MIDDLE);
+	io.MouseDown[GLFW_MOUSE_BUTTON_LEFT]   = left_clicked_   || window_.mouse_button_down(GLFW_MOUSE_BUTTON_LEFT);
+	io.MouseDown[GLFW_MOUSE_BUTTON_RIGHT]  = right_clicked_  || window_.mouse_button_down(GLFW_MOUSE_BUTTON_RIGHT);
+	io.MouseDown[GLFW_MOUSE_BUTTON_MIDDLE] = middle_clicked_ || window_.mouse_button_down(GLFW_MOUSE_BUTTON_MIDDLE);
 	left_clicked_ = right_clicked_ = middle_clicked_ = false;
 
 	io.MouseWheel = mouse_wheel_;
@@ -141,49 +142,62 @@ void GLFWImGui::render(int width, int height, GLuint framebuffer)
 
 	draw_data->ScaleClipRects(io.DisplayFramebufferScale);
 
-	// Save previous state.
-	GLboolean old_blend_enabled        = glIsEnabled(GL_BLEND);
-	GLint     old_blend_eq_rgb;          glGetIntegerv(GL_BLEND_EQUATION_RGB, &old_blend_eq_rgb);
-	GLint     old_blend_eq_alpha;        glGetIntegerv(GL_BLEND_EQUATION_ALPHA, &old_blend_eq_alpha);
-	GLint     old_blend_func_src;        glGetIntegerv(GL_BLEND_SRC, &old_blend_func_src);
-	GLint     old_blend_func_dst;        glGetIntegerv(GL_BLEND_DST, &old_blend_func_dst);
-	GLboolean old_cull_face_enabled    = glIsEnabled(GL_CULL_FACE);
-	GLboolean old_depth_test_enabled   = glIsEnabled(GL_DEPTH_TEST);
-	GLboolean old_scissor_test_enabled = glIsEnabled(GL_SCISSOR_TEST);
-	GLint     old_scissor_box[4];        glGetIntegerv(GL_SCISSOR_BOX, old_scissor_box);
-
-	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
-	glActiveTexture(GL_TEXTURE0);
-
-	glEnable(GL_BLEND);
-	glBlendEquation(GL_FUNC_ADD);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glDisable(GL_CULL_FACE);
-	glDisable(GL_DEPTH_TEST);
-	glEnable(GL_SCISSOR_TEST);
+	if (draw_data->TotalVtxCount == 0)
+		return;
+
+	// Upload all command lists at once: vertices first, then indices.
+	size_t vertex_bytes = sizeof(ImDrawVert) * draw_data->TotalVtxCount;
+	size_t index_start  = (vertex_bytes + sizeof(GLuint) - 1) / sizeof(GLuint) * sizeof(GLuint);
+	size_t index_bytes  = sizeof(ImDrawIdx) * draw_data->TotalIdxCount;
+
+	auto data     = (char*)stream_.begin(index_start + index_bytes);
+	auto vertices = (ImDrawVert*)data;
+	auto indices  = (ImDrawIdx*)(data + index_start);
+	for (int n = 0; n < draw_data->CmdListsCount; ++n)
+	{
+		const auto cmd_list = draw_data->CmdLists[n];
+		std::memcpy(vertices, cmd_list->VtxBuffer.Data, sizeof(ImDrawVert) * cmd_list->VtxBuffer.Size);
+		std::memcpy(indices, cmd_list->IdxBuffer.Data, sizeof(ImDrawIdx) * cmd_list->IdxBuffer.Size);
+		vertices += cmd_list->VtxBuffer.Size;
+		indices  += cmd_list->IdxBuffer.Size;
+	}
+	size_t offset = stream_.end();
+
+	// The rest of the application keeps depth testing and alpha blending on,
+	// never culls faces or scissors, and leaves the blend equation at its
+	// default. Everything we change goes through the state shadow, so that
+	// restoring it afterwards costs nothing the next pass wouldn't set anyway.
+	GL::State::bind_framebuffer(GL_FRAMEBUFFER, framebuffer);
+	GL::State::active_texture(GL_TEXTURE0);
+
+	GL::State::enable_blend(true);
+	GL::State::blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	GL::State::enable_depth_test(false);
+	GL::State::enable_scissor_test(true);
 
 	if (framebuffer != 0)
-		glViewport(0, 0, width, height);
+		GL::State::viewport(0, 0, width, height);
 	else
-		glViewport(0, 0, fb_width, fb_height);
+		GL::State::viewport(0, 0, fb_width, fb_height);
 
-	glUseProgram(shader_);
+	GL::State::use_program(shader_);
 
 	glUniform2f(display_size_uniform_, io.DisplaySize.x, io.DisplaySize.y);
 	glUniform1i(texture_sampler_uniform_, 0);
 
-	glBindVertexArray(vao_);
+	GL::State::bind_vao(vao_);
+	glBindBuffer(GL_ARRAY_BUFFER, stream_);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, stream_);
+
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid*)(offset + OFFSETOF(ImDrawVert, pos)));
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid*)(offset + OFFSETOF(ImDrawVert, uv)));
+	glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert), (GLvoid*)(offset + OFFSETOF(ImDrawVert, col)));
 
+	GLint  base_vertex  = 0;
+	size_t index_offset = offset + index_start;
 	for (int n = 0; n < draw_data->CmdListsCount; ++n)
 	{
-		const auto       cmd_list          = draw_data->CmdLists[n];
-		const ImDrawIdx* idx_buffer_offset = 0;
-
-		glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(ImDrawVert) * cmd_list->VtxBuffer.Size, cmd_list->VtxBuffer.Data, GL_STREAM_DRAW);
-
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(ImDrawIdx) * cmd_list->IdxBuffer.Size, cmd_list->IdxBuffer.Data, GL_STREAM_DRAW);
+		const auto cmd_list = draw_data->CmdLists[n];
 
 		for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; ++cmd_i)
 		{
@@ -192,22 +206,22 @@ void GLFWImGui::render(int width, int height, GLuint framebuffer)
 				pcmd->UserCallback(cmd_list, pcmd);
 			else
 			{
-				glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)pcmd->TextureId);
+				GL::State::bind_texture(GL_TEXTURE_2D, (GLuint)(intptr_t)pcmd->TextureId);
 				glScissor((int)pcmd->ClipRect.x, (int)(fb_height - pcmd->ClipRect.w), (int)(pcmd->ClipRect.z - pcmd->ClipRect.x), (int)(pcmd->ClipRect.w - pcmd->ClipRect.y));
-				glDrawElements(GL_TRIANGLES, pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, idx_buffer_offset);
+				glDrawElementsBaseVertex(GL_TRIANGLES, pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
+				                         (GLvoid*)index_offset, base_vertex);
+				Profiler::get().count_draw(GL_TRIANGLES, pcmd->ElemCount);
 			}
-			idx_buffer_offset += pcmd->ElemCount;
+			index_offset += sizeof(ImDrawIdx) * pcmd->ElemCount;
 		}
+		base_vertex += cmd_list->VtxBuffer.Size;
 	}
 
+	stream_.fence();
+
 	// Clean up.
-	glScissor(old_scissor_box[0], old_scissor_box[1], old_scissor_box[2], old_scissor_box[3]);
-    if (old_scissor_test_enabled) glEnable(GL_SCISSOR_TEST); else glDisable(GL_SCISSOR_TEST);
-    if (old_depth_test_enabled) glEnable(GL_DEPTH_TEST); else glDisable(GL_DEPTH_TEST);
-    if (old_cull_face_enabled) glEnable(GL_CULL_FACE); else glDisable(GL_CULL_FACE);
-	glBlendFunc(old_blend_func_src, old_blend_func_dst);
-	glBlendEquationSeparate(old_blend_eq_rgb, old_blend_eq_alpha);
-	if (old_blend_enabled) glEnable(GL_BLEND); else glDisable(GL_BLEND);
+	GL::State::enable_scissor_test(false);
+	GL::State::enable_depth_test(true);
 }
 
 void GLFWImGui::create_fonts_texture(void)
@@ -218,13 +232,16 @@ void GLFWImGui::create_fonts_texture(void)
 
 	io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
 
-	glBindTexture(GL_TEXTURE_2D, fonts_texture_);
+	GL::State::bind_texture(GL_TEXTURE_2D, fonts_texture_);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	Profiler::get().count_upload(4 * (size_t)width * height);
 
 	fonts_texture_.width_  = width;
 	fonts_texture_.height_ = height;
+	fonts_texture_.set_owner(MemoryUsage::GUI);
+	fonts_texture_.set_bytes(GL::internal_format_size(GL_RGBA8) * width * height);
 
 	io.Fonts->TexID = (void*)(intptr_t)(GLuint)fonts_texture_;
 }
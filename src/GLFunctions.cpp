@@ -1,20 +1,18 @@
 #include "GLFunctions.h"
 
+#include "Profiler.h"
 #include <cassert>
 #include <vector>
 #include "stb_image_write.h"
 
 //--------------------
 
-void GL::tex_to_png(const GL::Texture& texture, const char* filename) {
-	assert(filename != nullptr);
+std::vector<unsigned char> GL::tex_to_pixels(const GL::Texture& texture) {
+	GLuint old_tex = GL::State::texture(GL_TEXTURE_2D);
+	GL::State::bind_texture(GL_TEXTURE_2D, texture);
 
-	GLint old_tex; glGetIntegerv(GL_TEXTURE_BINDING_2D, &old_tex);
-	glBindTexture(GL_TEXTURE_2D, texture);
-
-	int width = 0, height = 0;
-	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
-	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+	int width  = texture.width_;
+	int height = texture.height_;
 
 	auto image_data = std::vector<unsigned char>(width * height * 4);
 	glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, &image_data[0]);
@@ -27,10 +25,20 @@ void GL::tex_to_png(const GL::Texture& texture, const char* filename) {
 	}
 	file_data.insert(file_data.end(), image_data.begin(), image_data.begin() + (4*width));
 
-	// TODO: Failure reporting and output without alpha.
-	stbi_write_png(filename, width, height, 4, &file_data[0], 0);
+	GL::State::bind_texture(GL_TEXTURE_2D, old_tex);
+
+	return file_data;
+}
+
+void GL::tex_to_png(const GL::Texture& texture, const char* filename) {
+	assert(filename != nullptr);
+
+	Profiler::Zone zone("tex_to_png");
 
-	glBindTexture(GL_TEXTURE_2D, old_tex);
+	auto file_data = tex_to_pixels(texture);
+
+	// TODO: Failure reporting and output without alpha.
+	stbi_write_png(filename, texture.width_, texture.height_, 4, &file_data[0], 0);
 }
 
 size_t GL::internal_format_size(GLenum format)
@@ -91,6 +99,16 @@ size_t GL::internal_format_size(GLenum format)
 		case GL_RGBA32F:
 			size = sizeof(GLfloat);
 			break;
+		case GL_DEPTH_COMPONENT16:
+			size = sizeof(GLushort);
+			break;
+		// Drivers pad 24-bit depth to 32 bits.
+		case GL_DEPTH_COMPONENT24:
+		case GL_DEPTH_COMPONENT32:
+		case GL_DEPTH_COMPONENT32F:
+		case GL_DEPTH24_STENCIL8:
+			size = sizeof(GLuint);
+			break;
 	}
 
 	switch (format)
@@ -1,9 +1,10 @@
 #include "GLObjects.h"
 
 #include "GLFunctions.h"
+#include "AssetBundle.h"
+#include "Profiler.h"
 #include <vector>
-#include <fstream>
-#include <sstream>
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <stdexcept>
@@ -11,17 +12,28 @@
 #include "stb_image.h"
 #include <climits>
 
+// Texture units whose bindings are shadowed.
+#define STATE_TEXTURE_UNITS 32u
+
 //--------------------
 
 namespace GL
 {
 // Buffer
-Buffer::Buffer(void)
+Buffer::Buffer(void) :
+	Buffer(MemoryUsage::OTHER)
+{}
+
+Buffer::Buffer(MemoryUsage::Owner owner) :
+	bytes_ (0u),
+	owner_ (owner)
 {
 	glGenBuffers(1, &buffer_);
 }
 
-Buffer::Buffer(const Buffer& other)
+Buffer::Buffer(const Buffer& other) :
+	bytes_ (0u),
+	owner_ (other.owner_)
 {
 	glGenBuffers(1, &buffer_);
 
@@ -37,17 +49,23 @@ Buffer::Buffer(const Buffer& other)
 
 	glBindBuffer(GL_COPY_READ_BUFFER, 0);
 	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	set_bytes(size);
 }
 
 Buffer::Buffer(Buffer&& other)
-:	buffer_(other.buffer_)
+:	buffer_ (other.buffer_),
+	bytes_  (other.bytes_),
+	owner_  (other.owner_)
 {
 	other.buffer_ = 0;
+	other.bytes_ = 0;
 }
 
 Buffer::~Buffer(void)
 {
 	glDeleteBuffers(1, &buffer_);
+	set_bytes(0);
 }
 
 Buffer& Buffer::operator=(const Buffer& other)
@@ -71,6 +89,7 @@ Buffer& Buffer::operator=(const Buffer& other)
 		{
 			glBufferData(GL_COPY_WRITE_BUFFER, read_size, nullptr, read_usage);
 			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, read_size);
+			set_bytes(read_size);
 		}
 
 		glBindBuffer(GL_COPY_READ_BUFFER, 0);
@@ -87,13 +106,35 @@ Buffer& Buffer::operator=(Buffer&& other)
 		glDeleteBuffers(1, &buffer_);
 		buffer_ = other.buffer_;
 		other.buffer_ = 0;
+
+		set_bytes(0);
+		owner_ = other.owner_;
+		bytes_ = other.bytes_;
+		other.bytes_ = 0;
 	}
 
 	return *this;
 }
 
+void Buffer::set_bytes(size_t bytes)
+{
+	MemoryUsage::get().resize(MemoryUsage::GPU, owner_, bytes_, bytes);
+	bytes_ = bytes;
+}
+
+void Buffer::set_owner(MemoryUsage::Owner owner)
+{
+	auto& usage = MemoryUsage::get();
+	usage.resize(MemoryUsage::GPU, owner_, bytes_, 0);
+	owner_ = owner;
+	usage.resize(MemoryUsage::GPU, owner_, 0, bytes_);
+}
+
 // Texture
+
 Texture::Texture(void) :
+	bytes_  (0u),
+	owner_  (MemoryUsage::OTHER),
 	width_  (0u),
 	height_ (0u)
 {
@@ -102,27 +143,38 @@ Texture::Texture(void) :
 
 Texture::Texture(Texture&& other)
 :	texture_ (other.texture_),
+	bytes_   (other.bytes_),
+	owner_   (other.owner_),
 	width_   (other.width_),
 	height_  (other.height_)
 {
 	other.texture_ = 0;
+	other.bytes_ = 0;
 	other.width_ = 0;
 	other.height_ = 0;
 }
 
 Texture::~Texture(void)
 {
+	State::forget_texture(texture_);
 	glDeleteTextures(1, &texture_);
+	set_bytes(0);
 }
 
 Texture& Texture::operator=(Texture&& other)
 {
 	if (this != &other)
 	{
+		State::forget_texture(texture_);
 		glDeleteTextures(1, &texture_);
 		texture_ = other.texture_;
 		other.texture_ = 0;
 
+		set_bytes(0);
+		owner_ = other.owner_;
+		bytes_ = other.bytes_;
+		other.bytes_ = 0;
+
 		width_ = other.width_;
 		height_ = other.height_;
 		other.width_ = 0;
@@ -132,146 +184,255 @@ Texture& Texture::operator=(Texture&& other)
 	return *this;
 }
 
-Texture Texture::from_png(const char* filename, bool& successful)
+void Texture::set_bytes(size_t bytes)
 {
-	assert(filename != nullptr);
-
-	int width, height, channels;
-	unsigned char* ud_image = stbi_load(filename, &width, &height, &channels, 4);
+	MemoryUsage::get().resize(MemoryUsage::GPU, owner_, bytes_, bytes);
+	bytes_ = bytes;
+}
 
-	std::vector<unsigned char> image;
-	if (ud_image != NULL)
-	{
-		successful = true;
-		image.resize(4 * width * height);
+void Texture::set_owner(MemoryUsage::Owner owner)
+{
+	auto& usage = MemoryUsage::get();
+	usage.resize(MemoryUsage::GPU, owner_, bytes_, 0);
+	owner_ = owner;
+	usage.resize(MemoryUsage::GPU, owner_, 0, bytes_);
+}
 
-		for (size_t i = 0; i < height; ++i)
-		{
-			for (size_t j = 0; j < 4 * width; ++j)
-				image[4 * width * i + j] = ud_image[4 * width * (height - (1 + i)) + j];
-		}
-	}
-	else
+// Flips the decoded image rows for OpenGL and uploads them, or returns
+// the error checkerboard if decoding failed.
+static Texture upload_png(unsigned char* ud_image, int width, int height,
+                          const char* name, bool mipmaps, bool& successful, MemoryUsage::Owner owner)
+{
+	if (ud_image == NULL)
 	{
 		successful = false;
-		width = height = 4;
-		image = { 255,   0, 255, 255,    0, 255,   0, 255,  255,   0, 255, 255,    0, 255,   0, 255,
-		            0, 255,   0, 255,  255,   0, 255, 255,    0, 255,   0, 255,  255,   0, 255, 255,
-		          255,   0, 255, 255,    0, 255,   0, 255,  255,   0, 255, 255,    0, 255,   0, 255,
-		            0, 255,   0, 255,  255,   0, 255, 255,    0, 255,   0, 255,  255,   0, 255, 255 };
-		std::cerr << "PNG loading failed for " << filename << std::endl
+		std::cerr << "PNG loading failed for " << name << std::endl
 		          << "Error: " << stbi_failure_reason() << std::endl;
+		return Texture::checkerboard(owner);
+	}
+
+	successful = true;
+
+	std::vector<unsigned char> image(4 * width * height);
+	for (int i = 0; i < height; ++i)
+	{
+		for (int j = 0; j < 4 * width; ++j)
+			image[4 * width * i + j] = ud_image[4 * width * (height - (1 + i)) + j];
 	}
 	stbi_image_free(ud_image);
 
+	return Texture::from_pixels(&image[0], width, height, mipmaps, owner);
+}
+
+Texture Texture::from_png(const char* filename, bool& successful, MemoryUsage::Owner owner)
+{
+	assert(filename != nullptr);
+
+	Profiler::Zone zone("from_png");
+
+	int width, height, channels;
+	unsigned char* ud_image = stbi_load(filename, &width, &height, &channels, 4);
+
+	return upload_png(ud_image, width, height, filename, true, successful, owner);
+}
+
+Texture Texture::from_png(const char* filename)
+{
+	bool unused_status;
+	return from_png(filename, unused_status);
+}
+
+Texture Texture::from_png_memory(const unsigned char* data, size_t size, const char* name,
+                                 bool& successful, bool mipmaps, MemoryUsage::Owner owner)
+{
+	assert(data != nullptr && name != nullptr);
+
+	int width, height, channels;
+	unsigned char* ud_image = stbi_load_from_memory(data, (int)size, &width, &height, &channels, 4);
+
+	return upload_png(ud_image, width, height, name, mipmaps, successful, owner);
+}
+
+Texture Texture::from_pixels(const unsigned char* pixels, int width, int height, bool mipmaps,
+                             MemoryUsage::Owner owner)
+{
 	Texture texture;
+	texture.owner_ = owner;
 
-	GLint old_tex; glGetIntegerv(GL_TEXTURE_BINDING_2D, &old_tex);
-	glBindTexture(GL_TEXTURE_2D, texture);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, &image[0]);
+	GLuint old_tex = State::texture(GL_TEXTURE_2D);
+	State::bind_texture(GL_TEXTURE_2D, texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	Profiler::get().count_upload(4 * (size_t)width * height);
 
-	if (successful)
+	if (mipmaps)
 	{
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glGenerateMipmap(GL_TEXTURE_2D);
 	}
 	else
-	{
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	}
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 
-	glGenerateMipmap(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, old_tex);
+	State::bind_texture(GL_TEXTURE_2D, old_tex);
 
 	texture.width_ = width;
 	texture.height_ = height;
 
+	// A full mip chain adds a third on top of the base level.
+	size_t base_bytes = internal_format_size(GL_RGBA8) * width * height;
+	texture.set_bytes(mipmaps ? base_bytes + base_bytes / 3 : base_bytes);
+
 	return texture;
 }
 
-Texture Texture::from_png(const char* filename)
+Texture Texture::checkerboard(MemoryUsage::Owner owner)
 {
-	bool unused_status;
-	return from_png(filename, unused_status);
+	const int width = 4, height = 4;
+	const unsigned char image[] = {
+		255,   0, 255, 255,    0, 255,   0, 255,  255,   0, 255, 255,    0, 255,   0, 255,
+		  0, 255,   0, 255,  255,   0, 255, 255,    0, 255,   0, 255,  255,   0, 255, 255,
+		255,   0, 255, 255,    0, 255,   0, 255,  255,   0, 255, 255,    0, 255,   0, 255,
+		  0, 255,   0, 255,  255,   0, 255, 255,    0, 255,   0, 255,  255,   0, 255, 255
+	};
+
+	Texture texture;
+	texture.owner_ = owner;
+
+	GLuint old_tex = State::texture(GL_TEXTURE_2D);
+	State::bind_texture(GL_TEXTURE_2D, texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	State::bind_texture(GL_TEXTURE_2D, old_tex);
+
+	texture.width_ = width;
+	texture.height_ = height;
+
+	texture.set_bytes(internal_format_size(GL_RGBA8) * width * height);
+
+	return texture;
 }
 
-Texture Texture::empty_2D(int width, int height)
+Texture Texture::empty_2D(int width, int height, MemoryUsage::Owner owner)
 {
 	Texture texture;
+	texture.owner_ = owner;
 
-	GLint old_tex; glGetIntegerv(GL_TEXTURE_BINDING_2D, &old_tex);
-	glBindTexture(GL_TEXTURE_2D, texture);
+	GLuint old_tex = State::texture(GL_TEXTURE_2D);
+	State::bind_texture(GL_TEXTURE_2D, texture);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_FLOAT, 0);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glBindTexture(GL_TEXTURE_2D, old_tex);
+	State::bind_texture(GL_TEXTURE_2D, old_tex);
+
+	texture.width_ = width;
+	texture.height_ = height;
+
+	texture.set_bytes(internal_format_size(GL_RGBA8) * width * height);
+
+	return texture;
+}
+
+Texture Texture::empty_2D_mipmap(int width, int height, MemoryUsage::Owner owner)
+{
+	Texture texture;
+	texture.owner_ = owner;
+
+	GLuint old_tex = State::texture(GL_TEXTURE_2D);
+	State::bind_texture(GL_TEXTURE_2D, texture);
+
+	// Allocate every level up front; contents come from glGenerateMipmap.
+	int levels = 1;
+	for (int w = width, h = height; w > 1 || h > 1; w = std::max(w / 2, 1), h = std::max(h / 2, 1))
+	{
+		glTexImage2D(GL_TEXTURE_2D, levels - 1, GL_RGBA8, w, h, 0, GL_RGBA, GL_FLOAT, 0);
+		++levels;
+	}
+	glTexImage2D(GL_TEXTURE_2D, levels - 1, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_FLOAT, 0);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	State::bind_texture(GL_TEXTURE_2D, old_tex);
 
 	texture.width_ = width;
 	texture.height_ = height;
 
+	size_t base_bytes = internal_format_size(GL_RGBA8) * width * height;
+	texture.set_bytes(base_bytes + base_bytes / 3);
+
 	return texture;
 }
 
-Texture Texture::empty_2D_multisample(int width, int height, int num_samples)
+Texture Texture::empty_2D_multisample(int width, int height, int num_samples, MemoryUsage::Owner owner)
 {
 	Texture texture;
+	texture.owner_ = owner;
 
-	GLint old_tex; glGetIntegerv(GL_TEXTURE_BINDING_2D_MULTISAMPLE, &old_tex);
-	glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, texture);
+	GLuint old_tex = State::texture(GL_TEXTURE_2D_MULTISAMPLE);
+	State::bind_texture(GL_TEXTURE_2D_MULTISAMPLE, texture);
 	glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, num_samples, GL_RGBA, width, height, false);
 	glTexParameteri(GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, old_tex);
+	State::bind_texture(GL_TEXTURE_2D_MULTISAMPLE, old_tex);
 
 	texture.width_ = width;
 	texture.height_ = height;
 
+	texture.set_bytes(internal_format_size(GL_RGBA8) * width * height * num_samples);
+
 	return texture;
 }
 
-Texture Texture::empty_2D_multisample_depth(int width, int height, int num_samples)
+Texture Texture::empty_2D_multisample_depth(int width, int height, int num_samples, MemoryUsage::Owner owner)
 {
 	Texture depth;
+	depth.owner_ = owner;
 
-	GLint old_tex; glGetIntegerv(GL_TEXTURE_BINDING_2D_MULTISAMPLE, &old_tex);
-	glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, depth);
+	GLuint old_tex = State::texture(GL_TEXTURE_2D_MULTISAMPLE);
+	State::bind_texture(GL_TEXTURE_2D_MULTISAMPLE, depth);
 	glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, num_samples, GL_DEPTH_COMPONENT, width, height, false);
 	glTexParameteri(GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, old_tex);
+	State::bind_texture(GL_TEXTURE_2D_MULTISAMPLE, old_tex);
 
 	depth.width_ = width;
 	depth.height_ = height;
 
+	depth.set_bytes(internal_format_size(GL_DEPTH_COMPONENT24) * width * height * num_samples);
+
 	return depth;
 }
 
-Texture Texture::empty_2D_depth(int width, int height)
+Texture Texture::empty_2D_depth(int width, int height, MemoryUsage::Owner owner)
 {
 	Texture depth;
+	depth.owner_ = owner;
 
-	GLint old_tex; glGetIntegerv(GL_TEXTURE_BINDING_2D, &old_tex);
-	glBindTexture(GL_TEXTURE_2D, depth);
+	GLuint old_tex = State::texture(GL_TEXTURE_2D);
+	State::bind_texture(GL_TEXTURE_2D, depth);
 
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, 0);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 
-	glBindTexture(GL_TEXTURE_2D, old_tex);
+	State::bind_texture(GL_TEXTURE_2D, old_tex);
 
 	depth.width_ = width;
 	depth.height_ = height;
 
+	depth.set_bytes(internal_format_size(GL_DEPTH_COMPONENT24) * width * height);
+
 	return depth;
 }
 
-Texture Texture::empty_cube(int resolution)
+Texture Texture::empty_cube(int resolution, MemoryUsage::Owner owner)
 {
 	Texture texture;
+	texture.owner_ = owner;
 
-	GLint old_tex; glGetIntegerv(GL_TEXTURE_BINDING_CUBE_MAP, &old_tex);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
+	GLuint old_tex = State::texture(GL_TEXTURE_CUBE_MAP);
+	State::bind_texture(GL_TEXTURE_CUBE_MAP, texture);
 
 	for (int i = 0; i < 6; ++i)
 	{
@@ -285,19 +446,22 @@ Texture Texture::empty_cube(int resolution)
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 
-	glBindTexture(GL_TEXTURE_CUBE_MAP, old_tex);
+	State::bind_texture(GL_TEXTURE_CUBE_MAP, old_tex);
 
 	texture.width_ = texture.height_ = resolution;
 
+	texture.set_bytes(6 * internal_format_size(GL_RGBA8) * resolution * resolution);
+
 	return texture;
 }
 
-Texture Texture::empty_cube_depth(int resolution)
+Texture Texture::empty_cube_depth(int resolution, MemoryUsage::Owner owner)
 {
 	Texture depth;
+	depth.owner_ = owner;
 
-	GLint old_tex; glGetIntegerv(GL_TEXTURE_BINDING_CUBE_MAP, &old_tex);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, depth);
+	GLuint old_tex = State::texture(GL_TEXTURE_CUBE_MAP);
+	State::bind_texture(GL_TEXTURE_CUBE_MAP, depth);
 
 	for (int i = 0; i < 6; ++i)
 	{
@@ -311,10 +475,12 @@ Texture Texture::empty_cube_depth(int resolution)
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 
-	glBindTexture(GL_TEXTURE_CUBE_MAP, old_tex);
+	State::bind_texture(GL_TEXTURE_CUBE_MAP, old_tex);
 
 	depth.width_ = depth.height_ = resolution;
 
+	depth.set_bytes(6 * internal_format_size(GL_DEPTH_COMPONENT24) * resolution * resolution);
+
 	return depth;
 }
 
@@ -322,17 +488,16 @@ Texture Texture::buffer_texture(const Buffer& buffer, GLenum format)
 {
 	Texture texture;
 
-	GLint old_tex; glGetIntegerv(GL_TEXTURE_BINDING_BUFFER, &old_tex);
-	glBindTexture(GL_TEXTURE_BUFFER, texture);
+	GLuint old_tex = State::texture(GL_TEXTURE_BUFFER);
+	State::bind_texture(GL_TEXTURE_BUFFER, texture);
 	glTexBuffer(GL_TEXTURE_BUFFER, format, buffer);
-	glBindTexture(GL_TEXTURE_BUFFER, old_tex);
+	State::bind_texture(GL_TEXTURE_BUFFER, old_tex);
 
-	GLint old_arr; glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &old_arr);
-	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	glBindBuffer(GL_COPY_READ_BUFFER, buffer);
 
 	GLint size;
-	glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &size);
-	glBindBuffer(GL_ARRAY_BUFFER, old_arr);
+	glGetBufferParameteriv(GL_COPY_READ_BUFFER, GL_BUFFER_SIZE, &size);
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
 
 	texture.width_  = size / GL::internal_format_size(format);
 	texture.height_ = 1;
@@ -354,6 +519,7 @@ VAO::VAO(VAO&& other)
 
 VAO::~VAO(void)
 {
+	State::forget_vao(vao_);
 	glDeleteVertexArrays(1, &vao_);
 }
 
@@ -361,6 +527,7 @@ VAO& VAO::operator=(VAO&& other)
 {
 	if (this != &other)
 	{
+		State::forget_vao(vao_);
 		glDeleteVertexArrays(1, &vao_);
 		vao_ = other.vao_;
 		other.vao_ = 0;
@@ -383,6 +550,7 @@ FBO::FBO(FBO&& other)
 
 FBO::~FBO(void)
 {
+	State::forget_framebuffer(fbo_);
 	glDeleteFramebuffers(1, &fbo_);
 }
 
@@ -390,6 +558,7 @@ FBO& FBO::operator=(FBO&& other)
 {
 	if (this != &other)
 	{
+		State::forget_framebuffer(fbo_);
 		glDeleteFramebuffers(1, &fbo_);
 		fbo_ = other.fbo_;
 		other.fbo_ = 0;
@@ -402,8 +571,8 @@ FBO FBO::simple_C0(const Texture& color)
 {
 	FBO framebuffer;
 
-	GLint old_fbo; glGetIntegerv(GL_FRAMEBUFFER_BINDING, &old_fbo);
-	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	GLuint old_fbo = State::framebuffer(GL_FRAMEBUFFER);
+	State::bind_framebuffer(GL_FRAMEBUFFER, framebuffer);
 
 	glClearColor(0, 0, 0, 0);
 
@@ -415,12 +584,12 @@ FBO FBO::simple_C0(const Texture& color)
 	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
 	if (status != GL_FRAMEBUFFER_COMPLETE)
 	{
-		glBindFramebuffer(GL_FRAMEBUFFER, old_fbo);
+		State::bind_framebuffer(GL_FRAMEBUFFER, old_fbo);
 		std::cerr << "Framebuffer incomplete." << std::endl;
 		throw std::runtime_error("Framebuffer incomplete.");
 	}
 
-	glBindFramebuffer(GL_FRAMEBUFFER, old_fbo);
+	State::bind_framebuffer(GL_FRAMEBUFFER, old_fbo);
 
 	return framebuffer;
 }
@@ -429,8 +598,8 @@ FBO FBO::simple_C0D(const Texture& color, const Texture& depth)
 {
 	FBO framebuffer;
 
-	GLint old_fbo; glGetIntegerv(GL_FRAMEBUFFER_BINDING, &old_fbo);
-	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	GLuint old_fbo = State::framebuffer(GL_FRAMEBUFFER);
+	State::bind_framebuffer(GL_FRAMEBUFFER, framebuffer);
 
 	glEnable(GL_DEPTH_TEST);
 	glClearColor(0, 0, 0, 0);
@@ -444,12 +613,12 @@ FBO FBO::simple_C0D(const Texture& color, const Texture& depth)
 	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
 	if (status != GL_FRAMEBUFFER_COMPLETE)
 	{
-		glBindFramebuffer(GL_FRAMEBUFFER, old_fbo);
+		State::bind_framebuffer(GL_FRAMEBUFFER, old_fbo);
 		std::cerr << "Framebuffer incomplete." << std::endl;
 		throw std::runtime_error("Framebuffer incomplete.");
 	}
 
-	glBindFramebuffer(GL_FRAMEBUFFER, old_fbo);
+	State::bind_framebuffer(GL_FRAMEBUFFER, old_fbo);
 
 	return framebuffer;
 }
@@ -458,8 +627,8 @@ FBO FBO::multisample_C0(const Texture& color)
 {
 	FBO framebuffer;
 
-	GLint old_fbo; glGetIntegerv(GL_FRAMEBUFFER_BINDING, &old_fbo);
-	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	GLuint old_fbo = State::framebuffer(GL_FRAMEBUFFER);
+	State::bind_framebuffer(GL_FRAMEBUFFER, framebuffer);
 
 	glClearColor(0, 0, 0, 0);
 
@@ -471,12 +640,12 @@ FBO FBO::multisample_C0(const Texture& color)
 	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
 	if (status != GL_FRAMEBUFFER_COMPLETE)
 	{
-		glBindFramebuffer(GL_FRAMEBUFFER, old_fbo);
+		State::bind_framebuffer(GL_FRAMEBUFFER, old_fbo);
 		std::cerr << "Framebuffer incomplete." << std::endl;
 		throw std::runtime_error("Framebuffer incomplete.");
 	}
 
-	glBindFramebuffer(GL_FRAMEBUFFER, old_fbo);
+	State::bind_framebuffer(GL_FRAMEBUFFER, old_fbo);
 
 	return framebuffer;
 }
@@ -485,8 +654,8 @@ FBO FBO::multisample_C0D(const Texture& color, const Texture& depth)
 {
 	FBO framebuffer;
 
-	GLint old_fbo; glGetIntegerv(GL_FRAMEBUFFER_BINDING, &old_fbo);
-	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	GLuint old_fbo = State::framebuffer(GL_FRAMEBUFFER);
+	State::bind_framebuffer(GL_FRAMEBUFFER, framebuffer);
 
 	glEnable(GL_DEPTH_TEST);
 	glClearColor(0, 0, 0, 0);
@@ -500,12 +669,12 @@ FBO FBO::multisample_C0D(const Texture& color, const Texture& depth)
 	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
 	if (status != GL_FRAMEBUFFER_COMPLETE)
 	{
-		glBindFramebuffer(GL_FRAMEBUFFER, old_fbo);
+		State::bind_framebuffer(GL_FRAMEBUFFER, old_fbo);
 		std::cerr << "Framebuffer incomplete." << std::endl;
 		throw std::runtime_error("Framebuffer incomplete.");
 	}
 
-	glBindFramebuffer(GL_FRAMEBUFFER, old_fbo);
+	State::bind_framebuffer(GL_FRAMEBUFFER, old_fbo);
 
 	return framebuffer;
 }
@@ -586,11 +755,19 @@ ShaderObject ShaderObject::from_file(GLenum shader_type, const char* source_file
 {
 	assert(source_file != nullptr);
 
-	std::ifstream source_stream(source_file);
-	std::stringstream source_buffer;
-	source_buffer << source_stream.rdbuf();
+	return ShaderObject(shader_type, AssetBundle::get().read(source_file).c_str());
+}
+
+ShaderObject ShaderObject::from_file(GLenum shader_type, const char* source_file,
+                                     const std::string& definitions)
+{
+	assert(source_file != nullptr);
 
-	return ShaderObject(shader_type, source_buffer.str().c_str());
+	auto source = AssetBundle::get().read(source_file);
+	auto version_end = source.find('\n');
+	source.insert(version_end == std::string::npos ? source.size() : version_end + 1, definitions);
+
+	return ShaderObject(shader_type, source.c_str());
 }
 
 ShaderObject ShaderObject::vertex_passthrough(void)
@@ -656,6 +833,19 @@ ShaderProgram::ShaderProgram(const ShaderObject& vertex_shader, const ShaderObje
 	}
 }
 
+ShaderProgram::ShaderProgram(const ShaderObject& compute_shader)
+{
+	shader_program_ = glCreateProgram();
+
+	glAttachShader(shader_program_, compute_shader);
+
+	if (!link())
+	{
+		std::cerr << "Shader program linking failed. Info log:" << std::endl << get_info_log();
+		throw std::runtime_error("Shader program linking failed.");
+	}
+}
+
 ShaderProgram::ShaderProgram(ShaderProgram&& other)
 :	shader_program_(other.shader_program_)
 {
@@ -717,8 +907,253 @@ ShaderProgram ShaderProgram::from_files(const char* vertex_file, const char* geo
 	return ShaderProgram(vertex_shader, geometry_shader, fragment_shader);
 }
 
+ShaderProgram ShaderProgram::from_file(const char* compute_file)
+{
+	return ShaderProgram(ShaderObject::from_file(GL_COMPUTE_SHADER, compute_file));
+}
+
 ShaderProgram ShaderProgram::simple(void)
 {
 	return ShaderProgram::from_files("shaders/simple_vert.glsl", "shaders/simple_frag.glsl");
 }
+
+// State
+namespace
+{
+// Texture targets whose bindings are shadowed.
+const GLenum texture_targets[] = {
+	GL_TEXTURE_2D, GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_BUFFER
+};
+const size_t num_texture_targets = sizeof(texture_targets) / sizeof(texture_targets[0]);
+
+struct Shadow
+{
+	GLuint program           = 0;
+	GLuint vao               = 0;
+	GLuint read_framebuffer  = 0;
+	GLuint draw_framebuffer  = 0;
+	GLenum active_texture    = GL_TEXTURE0;
+	GLuint textures[STATE_TEXTURE_UNITS][num_texture_targets] = {};
+
+	// The initial viewport depends on the window, so the first call always goes through.
+	bool   viewport_known    = false;
+	GLint  viewport[4]       = {};
+
+	bool   blend             = false;
+	bool   depth_test        = false;
+	bool   scissor_test      = false;
+	GLenum blend_func[4]     = {GL_ONE, GL_ZERO, GL_ONE, GL_ZERO};
+
+	size_t saved_calls       = 0;
+	size_t saved_last_frame  = 0;
+};
+
+// The defaults of a fresh context.
+Shadow shadow;
+
+// Returns num_texture_targets for targets that aren't shadowed.
+size_t target_index(GLenum target)
+{
+	return std::find(texture_targets, texture_targets + num_texture_targets, target) - texture_targets;
+}
+
+GLuint* texture_binding(GLenum target)
+{
+	size_t unit   = shadow.active_texture - GL_TEXTURE0;
+	size_t index  = target_index(target);
+	if (unit >= STATE_TEXTURE_UNITS || index == num_texture_targets)
+		return nullptr;
+
+	return &shadow.textures[unit][index];
+}
+
+void set_capability(GLenum capability, bool& shadowed, bool enabled)
+{
+	if (shadowed == enabled)
+	{
+		++shadow.saved_calls;
+		return;
+	}
+
+	if (enabled)
+		glEnable(capability);
+	else
+		glDisable(capability);
+	shadowed = enabled;
+}
+} // namespace
+
+void State::use_program(GLuint program)
+{
+	if (shadow.program == program)
+	{
+		++shadow.saved_calls;
+		return;
+	}
+
+	glUseProgram(program);
+	shadow.program = program;
+}
+
+void State::bind_vao(GLuint vao)
+{
+	if (shadow.vao == vao)
+	{
+		++shadow.saved_calls;
+		return;
+	}
+
+	glBindVertexArray(vao);
+	shadow.vao = vao;
+}
+
+void State::bind_framebuffer(GLenum target, GLuint framebuffer)
+{
+	bool read = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+	bool draw = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+
+	if ((!read || shadow.read_framebuffer == framebuffer) &&
+	    (!draw || shadow.draw_framebuffer == framebuffer))
+	{
+		++shadow.saved_calls;
+		return;
+	}
+
+	glBindFramebuffer(target, framebuffer);
+	if (read) shadow.read_framebuffer = framebuffer;
+	if (draw) shadow.draw_framebuffer = framebuffer;
+}
+
+void State::active_texture(GLenum unit)
+{
+	if (shadow.active_texture == unit)
+	{
+		++shadow.saved_calls;
+		return;
+	}
+
+	glActiveTexture(unit);
+	shadow.active_texture = unit;
+}
+
+void State::bind_texture(GLenum target, GLuint texture)
+{
+	auto binding = texture_binding(target);
+	if (binding && *binding == texture)
+	{
+		++shadow.saved_calls;
+		return;
+	}
+
+	glBindTexture(target, texture);
+	if (binding)
+		*binding = texture;
+}
+
+void State::viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	auto& v = shadow.viewport;
+	if (shadow.viewport_known && v[0] == x && v[1] == y && v[2] == width && v[3] == height)
+	{
+		++shadow.saved_calls;
+		return;
+	}
+
+	glViewport(x, y, width, height);
+	v[0] = x; v[1] = y; v[2] = width; v[3] = height;
+	shadow.viewport_known = true;
+}
+
+void State::enable_blend(bool enabled)
+{
+	set_capability(GL_BLEND, shadow.blend, enabled);
+}
+
+void State::enable_depth_test(bool enabled)
+{
+	set_capability(GL_DEPTH_TEST, shadow.depth_test, enabled);
+}
+
+void State::enable_scissor_test(bool enabled)
+{
+	set_capability(GL_SCISSOR_TEST, shadow.scissor_test, enabled);
+}
+
+void State::blend_func(GLenum source, GLenum destination)
+{
+	blend_func(source, destination, source, destination);
+}
+
+void State::blend_func(GLenum source_rgb, GLenum destination_rgb,
+                       GLenum source_alpha, GLenum destination_alpha)
+{
+	auto& f = shadow.blend_func;
+	if (f[0] == source_rgb && f[1] == destination_rgb && f[2] == source_alpha && f[3] == destination_alpha)
+	{
+		++shadow.saved_calls;
+		return;
+	}
+
+	glBlendFuncSeparate(source_rgb, destination_rgb, source_alpha, destination_alpha);
+	f[0] = source_rgb; f[1] = destination_rgb; f[2] = source_alpha; f[3] = destination_alpha;
+}
+
+GLuint State::program(void)
+{
+	return shadow.program;
+}
+
+GLuint State::vao(void)
+{
+	return shadow.vao;
+}
+
+GLuint State::framebuffer(GLenum target)
+{
+	return target == GL_READ_FRAMEBUFFER ? shadow.read_framebuffer : shadow.draw_framebuffer;
+}
+
+GLenum State::active_texture(void)
+{
+	return shadow.active_texture;
+}
+
+GLuint State::texture(GLenum target)
+{
+	auto binding = texture_binding(target);
+	assert(binding != nullptr && "Texture target or unit not shadowed.");
+
+	return binding ? *binding : 0;
+}
+
+void State::forget_texture(GLuint texture)
+{
+	for (auto& unit : shadow.textures)
+		std::replace(std::begin(unit), std::end(unit), texture, 0u);
+}
+
+void State::forget_vao(GLuint vao)
+{
+	if (shadow.vao == vao)
+		shadow.vao = 0;
+}
+
+void State::forget_framebuffer(GLuint framebuffer)
+{
+	if (shadow.read_framebuffer == framebuffer)
+		shadow.read_framebuffer = 0;
+	if (shadow.draw_framebuffer == framebuffer)
+		shadow.draw_framebuffer = 0;
+}
+
+void State::end_frame(void)
+{
+	shadow.saved_last_frame = shadow.saved_calls;
+	shadow.saved_calls      = 0;
+}
+
+size_t State::saved_calls(void)
+{
+	return shadow.saved_last_frame;
+}
 } // namespace GL
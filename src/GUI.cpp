@@ -2,7 +2,13 @@
 
 #include "Window.h"
 #include "Layering.h"
+#include "Residency.h"
+#include "AssetBundle.h"
+#include "Profiler.h"
 #include "imgui.h"
+#include <algorithm>
+#include <cfloat>
+#include <cstdio>
 
 GUI::GUI(MainWindow& window, Layering& layering) :
 	// Sensible defaults.
@@ -11,6 +17,8 @@ GUI::GUI(MainWindow& window, Layering& layering) :
 	pixels_per_unit_         (500.0),
 	frame_visible_           (true),
 	result_visible_          (true),
+	fold_analytically_       (false),
+	use_fold_table_          (false),
 	menu_bar_visible_        (true),
 	settings_window_visible_ (true),
 	usage_window_visible_    (false),
@@ -19,6 +27,9 @@ GUI::GUI(MainWindow& window, Layering& layering) :
 	export_settings_visible_ (false),
 	export_width_            (1600),
 	export_height_           (1200),
+	memory_budget_mb_        ((int)(Residency::DEFAULT_BUDGET / (1024 * 1024))),
+	domain_quality_          (1.0f),
+	profiler_visible_       (false),
 
 	implementation_ (window),
 	window_         (window),
@@ -77,7 +88,18 @@ GUI::GUI(MainWindow& window, Layering& layering) :
 	// Set default GUI font.
 	auto& io = ImGui::GetIO();
 	io.Fonts->Clear();
-	io.Fonts->AddFontFromFileTTF("res/DroidSans.ttf", 18.0f, NULL, io.Fonts->GetGlyphRangesCyrillic());
+	const unsigned char* font_data;
+	size_t font_size;
+	if (AssetBundle::get().find("res/DroidSans.ttf", font_data, font_size))
+	{
+		// The bundle stays mapped, so the atlas can use the data in place.
+		ImFontConfig font_config;
+		font_config.FontDataOwnedByAtlas = false;
+		io.Fonts->AddFontFromMemoryTTF((void*)font_data, (int)font_size, 18.0f, &font_config,
+		                               io.Fonts->GetGlyphRangesCyrillic());
+	}
+	else
+		io.Fonts->AddFontFromFileTTF("res/DroidSans.ttf", 18.0f, NULL, io.Fonts->GetGlyphRangesCyrillic());
 	implementation_.create_fonts_texture();
 
 	populate_thumbnail_map();
@@ -99,6 +121,9 @@ void GUI::render(int width, int height, GLuint framebuffer)
 	if (*usage_window_visible_)
 		draw_usage_window();
 
+	if (*profiler_visible_)
+		draw_performance_overlay();
+
 	auto horizontal_margin = left_margin_   + right_margin_;
 	auto vertical_margin   = bottom_margin_ + top_margin_;
 
@@ -248,20 +273,20 @@ void GUI::draw_symmetry_settings_old(void)
 	ImGui::PopTextWrapPos();
 
 	ImGui::BeginGroup();
-	if (ImGui::Selectable("o", !strncmp(ctiling.symmetry_group(), "o", 8), 0, {110, 0}))
-		layer.tiling().set_symmetry_group("o");
+	if (ImGui::Selectable("o", ctiling.group() == Wallpaper::Group::P1, 0, {110, 0}))
+		layer.tiling().set_symmetry_group(Wallpaper::Group::P1);
 	ImGui::SameLine(25); ImGui::Text("(p1)");
-	if (ImGui::Selectable("xx", !strncmp(ctiling.symmetry_group(), "xx", 8), 0, {110, 0}))
-		layer.tiling().set_symmetry_group("xx");
+	if (ImGui::Selectable("xx", ctiling.group() == Wallpaper::Group::PG, 0, {110, 0}))
+		layer.tiling().set_symmetry_group(Wallpaper::Group::PG);
 	ImGui::SameLine(25); ImGui::Text("(pg)");
 	ImGui::EndGroup();                      ImGui::SameLine(215);
 
 	ImGui::BeginGroup();
-	if (ImGui::Selectable("**", !strncmp(ctiling.symmetry_group(), "**", 8), 0, {110, 0}))
-		layer.tiling().set_symmetry_group("**");
+	if (ImGui::Selectable("**", ctiling.group() == Wallpaper::Group::PM, 0, {110, 0}))
+		layer.tiling().set_symmetry_group(Wallpaper::Group::PM);
 	ImGui::SameLine(25); ImGui::Text("(pm)");
-	if (ImGui::Selectable("*x", !strncmp(ctiling.symmetry_group(), "*x", 8), 0, {110, 0}))
-		layer.tiling().set_symmetry_group("*x");
+	if (ImGui::Selectable("*x", ctiling.group() == Wallpaper::Group::CM, 0, {110, 0}))
+		layer.tiling().set_symmetry_group(Wallpaper::Group::CM);
 	ImGui::SameLine(25); ImGui::Text("(cm)");
 	ImGui::EndGroup();
 	ImGui::Spacing();
@@ -272,23 +297,23 @@ void GUI::draw_symmetry_settings_old(void)
 	ImGui::PopTextWrapPos();
 
 	ImGui::BeginGroup();
-	if (ImGui::Selectable("2222", !strncmp(ctiling.symmetry_group(), "2222", 8), 0, {110, 0}))
-		layer.tiling().set_symmetry_group("2222");
+	if (ImGui::Selectable("2222", ctiling.group() == Wallpaper::Group::P2, 0, {110, 0}))
+		layer.tiling().set_symmetry_group(Wallpaper::Group::P2);
 	ImGui::SameLine(45); ImGui::Text("(p2)");
-	if (ImGui::Selectable("22x", !strncmp(ctiling.symmetry_group(), "22x", 8), 0, {110, 0}))
-		layer.tiling().set_symmetry_group("22x");
+	if (ImGui::Selectable("22x", ctiling.group() == Wallpaper::Group::PGG, 0, {110, 0}))
+		layer.tiling().set_symmetry_group(Wallpaper::Group::PGG);
 	ImGui::SameLine(45); ImGui::Text("(pgg)");
 	ImGui::EndGroup();                      ImGui::SameLine(215);
 
 	ImGui::BeginGroup();
-	if (ImGui::Selectable("*2222", !strncmp(ctiling.symmetry_group(), "*2222", 8), 0, {110, 0}))
-		layer.tiling().set_symmetry_group("*2222");
+	if (ImGui::Selectable("*2222", ctiling.group() == Wallpaper::Group::PMM, 0, {110, 0}))
+		layer.tiling().set_symmetry_group(Wallpaper::Group::PMM);
 	ImGui::SameLine(55); ImGui::Text("(pmm)");
-	if (ImGui::Selectable("2*22", !strncmp(ctiling.symmetry_group(), "2*22", 8), 0, {110, 0}))
-		layer.tiling().set_symmetry_group("2*22");
+	if (ImGui::Selectable("2*22", ctiling.group() == Wallpaper::Group::CMM, 0, {110, 0}))
+		layer.tiling().set_symmetry_group(Wallpaper::Group::CMM);
 	ImGui::SameLine(55); ImGui::Text("(cmm)");
-	if (ImGui::Selectable("22*", !strncmp(ctiling.symmetry_group(), "22*", 8), 0, {110, 0}))
-		layer.tiling().set_symmetry_group("22*");
+	if (ImGui::Selectable("22*", ctiling.group() == Wallpaper::Group::PMG, 0, {110, 0}))
+		layer.tiling().set_symmetry_group(Wallpaper::Group::PMG);
 	ImGui::SameLine(55); ImGui::Text("(pmg)");
 	ImGui::EndGroup();
 	ImGui::Spacing();
@@ -299,17 +324,17 @@ void GUI::draw_symmetry_settings_old(void)
 	ImGui::PopTextWrapPos();
 
 	ImGui::BeginGroup();
-	if (ImGui::Selectable("333", !strncmp(ctiling.symmetry_group(), "333", 8), 0, {110, 0}))
-		layer.tiling().set_symmetry_group("333");
+	if (ImGui::Selectable("333", ctiling.group() == Wallpaper::Group::P3, 0, {110, 0}))
+		layer.tiling().set_symmetry_group(Wallpaper::Group::P3);
 	ImGui::SameLine(35); ImGui::Text("(p3)");
 	ImGui::EndGroup();                      ImGui::SameLine(215);
 
 	ImGui::BeginGroup();
-	if (ImGui::Selectable("*333", !strncmp(ctiling.symmetry_group(), "*333", 8), 0, {110, 0}))
-		layer.tiling().set_symmetry_group("*333");
+	if (ImGui::Selectable("*333", ctiling.group() == Wallpaper::Group::P3M1, 0, {110, 0}))
+		layer.tiling().set_symmetry_group(Wallpaper::Group::P3M1);
 	ImGui::SameLine(45); ImGui::Text("(p3m1)");
-	if (ImGui::Selectable("3*3", !strncmp(ctiling.symmetry_group(), "3*3", 8), 0, {110, 0}))
-		layer.tiling().set_symmetry_group("3*3");
+	if (ImGui::Selectable("3*3", ctiling.group() == Wallpaper::Group::P31M, 0, {110, 0}))
+		layer.tiling().set_symmetry_group(Wallpaper::Group::P31M);
 	ImGui::SameLine(45); ImGui::Text("(p31m)");
 	ImGui::EndGroup();
 	ImGui::Spacing();
@@ -320,17 +345,17 @@ void GUI::draw_symmetry_settings_old(void)
 	ImGui::PopTextWrapPos();
 
 	ImGui::BeginGroup();
-	if (ImGui::Selectable("442", !strncmp(ctiling.symmetry_group(), "442", 8), 0, {110, 0}))
-		layer.tiling().set_symmetry_group("442");
+	if (ImGui::Selectable("442", ctiling.group() == Wallpaper::Group::P4, 0, {110, 0}))
+		layer.tiling().set_symmetry_group(Wallpaper::Group::P4);
 	ImGui::SameLine(35); ImGui::Text("(p4)");
 	ImGui::EndGroup();                      ImGui::SameLine(215);
 
 	ImGui::BeginGroup();
-	if (ImGui::Selectable("*442", !strncmp(ctiling.symmetry_group(), "*442", 8), 0, {110, 0}))
-		layer.tiling().set_symmetry_group("*442");
+	if (ImGui::Selectable("*442", ctiling.group() == Wallpaper::Group::P4M, 0, {110, 0}))
+		layer.tiling().set_symmetry_group(Wallpaper::Group::P4M);
 	ImGui::SameLine(45); ImGui::Text("(p4m)");
-	if (ImGui::Selectable("4*2", !strncmp(ctiling.symmetry_group(), "4*2", 8), 0, {110, 0}))
-		layer.tiling().set_symmetry_group("4*2");
+	if (ImGui::Selectable("4*2", ctiling.group() == Wallpaper::Group::P4G, 0, {110, 0}))
+		layer.tiling().set_symmetry_group(Wallpaper::Group::P4G);
 	ImGui::SameLine(45); ImGui::Text("(p4g)");
 	ImGui::EndGroup();
 	ImGui::Spacing();
@@ -341,14 +366,14 @@ void GUI::draw_symmetry_settings_old(void)
 	ImGui::PopTextWrapPos();
 
 	ImGui::BeginGroup();
-	if (ImGui::Selectable("632", !strncmp(ctiling.symmetry_group(), "632", 8), 0, {110, 0}))
-		layer.tiling().set_symmetry_group("632");
+	if (ImGui::Selectable("632", ctiling.group() == Wallpaper::Group::P6, 0, {110, 0}))
+		layer.tiling().set_symmetry_group(Wallpaper::Group::P6);
 	ImGui::SameLine(35); ImGui::Text("(p6)");
 	ImGui::EndGroup();                      ImGui::SameLine(215);
 
 	ImGui::BeginGroup();
-	if (ImGui::Selectable("*632", !strncmp(ctiling.symmetry_group(), "*632", 8), 0, {110, 0}))
-		layer.tiling().set_symmetry_group("*632");
+	if (ImGui::Selectable("*632", ctiling.group() == Wallpaper::Group::P6M, 0, {110, 0}))
+		layer.tiling().set_symmetry_group(Wallpaper::Group::P6M);
 	ImGui::SameLine(45); ImGui::Text("(p6m)");
 	ImGui::EndGroup();
 }
@@ -570,7 +595,7 @@ void GUI::draw_symmetry_settings(void)
 	ImGui::Dummy({0, 0}); ImGui::SameLine(label_offset);
 	ImGui::Text(current_group);
 	ImGui::PushID("Group choice");
-	if (ImGui::ImageButton((ImTextureID)(uintptr_t)thumbnail_map_[current_group], {120, 120}, {0, 1}, {1, 0}, 5))
+	if (thumbnail_button(current_group, 5))
 		ImGui::OpenPopup("Choose a symmetry group");
 
 	auto modal_flags = ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoMove;
@@ -600,7 +625,7 @@ void GUI::draw_symmetry_modal(void)
 		ImGui::Dummy({0, 0}); ImGui::SameLine(label_offset);
 		ImGui::Text(symmetry_group);
 		ImGui::PushID(symmetry_group);
-		if (ImGui::ImageButton((ImTextureID)(uintptr_t)thumbnail_map_[symmetry_group], {120, 120}, {0, 1}, {1, 0}, 10))
+		if (thumbnail_button(symmetry_group, 10))
 		{
 			layer.tiling().set_symmetry_group(symmetry_group);
 			modal_should_close = true;
@@ -723,6 +748,64 @@ void GUI::draw_view_settings(void)
 		// 	ImGui::EndTooltip();
 		// }
 
+		ImGui::AlignFirstTextHeightToWidgets();
+		ImGui::Text("Fold per pixel:"); ImGui::SameLine(130);
+		ImGui::Checkbox("##Fold per pixel", fold_analytically_);
+		if (ImGui::IsItemHovered())
+		{
+			ImGui::BeginTooltip();
+			ImGui::Text("Render the result with one full-screen pass per layer.");
+			ImGui::EndTooltip();
+		}
+
+		ImGui::Text("Fold table:"); ImGui::SameLine(130);
+		ImGui::Checkbox("##Fold table", use_fold_table_);
+		if (ImGui::IsItemHovered())
+		{
+			ImGui::BeginTooltip();
+			ImGui::Text("When folding per pixel, fetch the fold from a precomputed\ntable instead of searching for it. Exports use it too.");
+			ImGui::EndTooltip();
+		}
+
+		ImGui::Text("Domain quality:"); ImGui::SameLine(130);
+		ImGui::PushItemWidth(-65.0f);
+		ImGui::SliderFloat("##Domain quality", domain_quality_, 0.25f, 4.0f, "%.2fx");
+		ImGui::PopItemWidth();
+		ImGui::SameLine();
+		if (ImGui::Button("Reset##Reset domain quality"))
+			domain_quality_.reset();
+		if (ImGui::IsItemHovered())
+		{
+			ImGui::BeginTooltip();
+			ImGui::Text("Texels per screen pixel in the symmetrified domain.");
+			ImGui::EndTooltip();
+		}
+
+		int budget = *memory_budget_mb_;
+		ImGui::Text("Memory budget:"); ImGui::SameLine(130);
+		ImGui::PushItemWidth(-65.0f);
+		if (ImGui::DragInt("##Memory budget", &budget, 8.0f, 0, 65536, budget > 0 ? "%.0f MB" : "Unlimited"))
+			*memory_budget_mb_ = std::max(budget, 0);
+		ImGui::PopItemWidth();
+		ImGui::SameLine();
+		if (ImGui::Button("Reset##Reset memory budget"))
+			memory_budget_mb_.reset();
+
+		ImGui::Dummy({0, 0}); ImGui::SameLine(130);
+		ImGui::Text("%.1f MB of GPU memory", Residency::get().resident_bytes() / (1024.0 * 1024.0));
+		ImGui::Dummy({0, 0}); ImGui::SameLine(130);
+		ImGui::Text("%zu redundant GL calls skipped", GL::State::saved_calls());
+
+		ImGui::AlignFirstTextHeightToWidgets();
+		ImGui::Text("Performance:"); ImGui::SameLine(130);
+		ImGui::Checkbox("##Performance overlay", profiler_visible_);
+		if (ImGui::IsItemHovered())
+		{
+			ImGui::BeginTooltip();
+			ImGui::Text("Show CPU and GPU times of each pass, and frame counters.");
+			ImGui::EndTooltip();
+		}
+
 		ImGui::Spacing();
 		ImGui::Spacing();
 		ImGui::Spacing();
@@ -823,7 +906,8 @@ void GUI::draw_current_frame_settings(void)
 	ImGui::Text("Domains:"); ImGui::SameLine(140);
 	domains_changed |= ImGui::RadioButton("1##Domains 1", &num_domains, 1); ImGui::SameLine();
 	domains_changed |= ImGui::RadioButton("4##Domains 2", &num_domains, 4); ImGui::SameLine();
-	// domains_changed |= ImGui::RadioButton("9##Domains 3", &num_domains, 9); ImGui::SameLine();
+	domains_changed |= ImGui::RadioButton("9##Domains 3", &num_domains, 9); ImGui::SameLine();
+	domains_changed |= ImGui::RadioButton("16##Domains 4", &num_domains, 16);
 	if (domains_changed)
 		layer.tiling().set_num_lattice_domains(num_domains);
 }
@@ -958,27 +1042,117 @@ void GUI::draw_export_settings(void)
 		*export_settings_visible_ = was_open_last_frame = false;
 }
 
+void GUI::draw_performance_overlay(void)
+{
+	const auto& profiler = Profiler::get();
+
+	auto flags = ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove |
+	             ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoInputs;
+	ImGui::SetNextWindowPos({left_margin_ + 10, top_margin_ + 10});
+	if (ImGui::Begin("Performance", NULL, {360, 0}, 0.6f, flags | ImGuiWindowFlags_AlwaysAutoResize))
+	{
+		const auto& times = profiler.frame_times();
+
+		float average = 0.0f, maximum = 0.0f;
+		for (auto time : times)
+		{
+			average += time / times.size();
+			maximum  = std::max(maximum, time);
+		}
+
+		char overlay[64];
+		std::snprintf(overlay, sizeof(overlay), "avg %.2f ms, max %.2f ms", average, maximum);
+		ImGui::PlotHistogram("##Frame times", times.data(), (int)times.size(), (int)profiler.frame_time_offset(),
+		                     overlay, 0.0f, FLT_MAX, {344, 60});
+
+		ImGui::Columns(3, "Passes", false);
+		ImGui::SetColumnOffset(1, 200);
+		ImGui::SetColumnOffset(2, 280);
+		ImGui::TextDisabled("Pass"); ImGui::NextColumn();
+		ImGui::TextDisabled("CPU ms"); ImGui::NextColumn();
+		ImGui::TextDisabled("GPU ms"); ImGui::NextColumn();
+
+		for (const auto& pass : profiler.passes())
+		{
+			if (pass.calls > 1)
+				ImGui::Text("%*s%s (%d)", 2 * pass.depth, "", pass.name.c_str(), pass.calls);
+			else
+				ImGui::Text("%*s%s", 2 * pass.depth, "", pass.name.c_str());
+			ImGui::NextColumn();
+			ImGui::Text("%.3f", pass.cpu_ms); ImGui::NextColumn();
+			ImGui::Text("%.3f", pass.gpu_ms); ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+
+		const auto& counters = profiler.counters();
+		ImGui::Separator();
+		ImGui::Text("%zu draw calls, %zu triangles", counters.draw_calls, counters.triangles);
+		ImGui::Text("%zu texture uploads, %.2f MB", counters.texture_uploads,
+		            counters.upload_bytes / (1024.0 * 1024.0));
+
+		// Owners that never held anything are left out.
+		const auto& memory = MemoryUsage::get();
+		const double megabyte = 1024.0 * 1024.0;
+		ImGui::Separator();
+		ImGui::Columns(4, "Memory", false);
+		ImGui::SetColumnOffset(1, 160);
+		ImGui::SetColumnOffset(2, 230);
+		ImGui::SetColumnOffset(3, 300);
+		ImGui::TextDisabled("Memory"); ImGui::NextColumn();
+		ImGui::TextDisabled("MB"); ImGui::NextColumn();
+		ImGui::TextDisabled("Peak"); ImGui::NextColumn();
+		ImGui::TextDisabled("Objects"); ImGui::NextColumn();
+
+		for (int pool = 0; pool < MemoryUsage::NUM_POOLS; ++pool)
+		{
+			const auto& total = memory.total((MemoryUsage::Pool)pool);
+			ImGui::Text("%s", pool == MemoryUsage::GPU ? "GPU" : "Host"); ImGui::NextColumn();
+			ImGui::Text("%.1f", total.bytes / megabyte); ImGui::NextColumn();
+			ImGui::Text("%.1f", total.peak / megabyte); ImGui::NextColumn();
+			ImGui::Text("%zu", total.objects); ImGui::NextColumn();
+
+			for (int owner = 0; owner < MemoryUsage::NUM_OWNERS; ++owner)
+			{
+				const auto& part = memory.total((MemoryUsage::Pool)pool, (MemoryUsage::Owner)owner);
+				if (part.peak == 0)
+					continue;
+
+				ImGui::Text("  %s", MemoryUsage::name((MemoryUsage::Owner)owner)); ImGui::NextColumn();
+				ImGui::Text("%.1f", part.bytes / megabyte); ImGui::NextColumn();
+				ImGui::Text("%.1f", part.peak / megabyte); ImGui::NextColumn();
+				ImGui::Text("%zu", part.objects); ImGui::NextColumn();
+			}
+		}
+		ImGui::Columns(1);
+		ImGui::TextDisabled("F11 writes the details by layer and image.");
+	}
+	ImGui::End();
+}
+
 void GUI::populate_thumbnail_map(void)
 {
-	thumbnail_map_["o"]     = GL::Texture::from_png("res/thumbnails/o");
-	thumbnail_map_["xx"]    = GL::Texture::from_png("res/thumbnails/xx");
-	thumbnail_map_["*x"]    = GL::Texture::from_png("res/thumbnails/_x");
-	thumbnail_map_["**"]    = GL::Texture::from_png("res/thumbnails/__");
-
-	thumbnail_map_["2222"]  = GL::Texture::from_png("res/thumbnails/2222");
-	thumbnail_map_["22x"]   = GL::Texture::from_png("res/thumbnails/22x");
-	thumbnail_map_["22*"]   = GL::Texture::from_png("res/thumbnails/22_");
-	thumbnail_map_["2*22"]  = GL::Texture::from_png("res/thumbnails/2_22");
-	thumbnail_map_["*2222"] = GL::Texture::from_png("res/thumbnails/_2222");
-
-	thumbnail_map_["333"]   = GL::Texture::from_png("res/thumbnails/333");
-	thumbnail_map_["3*3"]   = GL::Texture::from_png("res/thumbnails/3_3");
-	thumbnail_map_["*333"]  = GL::Texture::from_png("res/thumbnails/_333");
-
-	thumbnail_map_["442"]   = GL::Texture::from_png("res/thumbnails/442");
-	thumbnail_map_["4*2"]   = GL::Texture::from_png("res/thumbnails/4_2");
-	thumbnail_map_["*442"]  = GL::Texture::from_png("res/thumbnails/_442");
-
-	thumbnail_map_["632"]   = GL::Texture::from_png("res/thumbnails/632");
-	thumbnail_map_["*632"]  = GL::Texture::from_png("res/thumbnails/_632");
+	// One upload for all of them, straight from the bundle.
+	auto atlas = AssetBundle::get().atlas("res/thumbnails");
+	if (atlas.images.empty())
+		return;
+
+	thumbnail_atlas_ = GL::Texture::from_pixels(atlas.pixels, atlas.width, atlas.height, true, MemoryUsage::GUI);
+
+	// File names have underscores in place of asterisks.
+	for (const auto& image : atlas.images)
+	{
+		auto symmetry_group = image.name;
+		std::replace(std::begin(symmetry_group), std::end(symmetry_group), '_', '*');
+
+		thumbnail_map_[symmetry_group] = {(float)image.x / atlas.width, (float)image.y / atlas.height,
+		                                  (float)image.width / atlas.width, (float)image.height / atlas.height};
+	}
+}
+
+bool GUI::thumbnail_button(const char* symmetry_group, int frame_padding)
+{
+	// Textures are upside down, hence the flipped texture coordinates.
+	const auto& uv = thumbnail_map_[symmetry_group];
+	return ImGui::ImageButton((ImTextureID)(uintptr_t)thumbnail_atlas_, {120, 120},
+	                          {uv.x, uv.y + uv.height}, {uv.x + uv.width, uv.y}, frame_padding);
 }
@@ -0,0 +1,186 @@
+#include "GoldenCheck.h"
+
+#include "App.h"
+#include "GLFunctions.h"
+#include "Profiler.h"
+#include "stb_image.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iterator>
+
+// The size and zoom of the golden images, and how much a render may differ.
+// Pixels differ when their colour distance is above the colour tolerance,
+// and a render fails when the differing fraction is above the pixel one.
+#define GOLDEN_WIDTH            640
+#define GOLDEN_HEIGHT           480
+#define GOLDEN_PIXELS_PER_UNIT  200.0
+#define GOLDEN_COLOUR_TOLERANCE 24.0
+#define GOLDEN_PIXEL_TOLERANCE  0.001
+#define GOLDEN_RENDERS          5
+
+//--------------------
+
+namespace
+{
+// Every group gets one of these, in turn.
+const char* const GOLDEN_IMAGES[] = {
+	"res/examples/kissa.png",      "res/examples/butterfly.png", "res/examples/flower.png",
+	"res/examples/botanic1.png",   "res/examples/iris.png",      "res/examples/sun.png",
+	"res/examples/fan.png",        "res/examples/skeleton.png",  "res/examples/botanic2.png",
+	"res/examples/butterfly2.png", "res/examples/botanic3.png",  "res/examples/butterfly3.png"
+};
+
+// The "redmean" approximation of perceived colour distance. Identical
+// colours are at zero, black and white at about 765.
+double colour_distance(const unsigned char* a, const unsigned char* b)
+{
+	double red_mean = (a[0] + b[0]) / 2.0;
+	double dr = a[0] - b[0], dg = a[1] - b[1], db = a[2] - b[2];
+
+	return std::sqrt((2.0 + red_mean / 256.0) * dr * dr + 4.0 * dg * dg
+	                 + (2.0 + (255.0 - red_mean) / 256.0) * db * db);
+}
+
+// Fraction of pixels that differ visibly from the golden image at the path,
+// or a negative value if there is no such image of the same size.
+double golden_difference(const std::vector<unsigned char>& pixels, int width, int height,
+                         const std::string& path)
+{
+	int golden_width, golden_height, channels;
+	auto* golden = stbi_load(path.c_str(), &golden_width, &golden_height, &channels, 4);
+	if (!golden)
+		return -1.0;
+
+	double difference = -1.0;
+	if (golden_width == width && golden_height == height)
+	{
+		size_t differing = 0;
+		for (size_t i = 0; i < pixels.size(); i += 4)
+		{
+			if (colour_distance(&pixels[i], &golden[i]) > GOLDEN_COLOUR_TOLERANCE)
+				++differing;
+		}
+
+		difference = differing / (double)(width * height);
+	}
+
+	stbi_image_free(golden);
+	return difference;
+}
+
+// Orbifold names, with the mirrors that file names can't have as
+// underscores, as for the thumbnails.
+std::string golden_name(Wallpaper::Group group)
+{
+	std::string name = Wallpaper::info(group).name;
+	std::replace(std::begin(name), std::end(name), '*', '_');
+
+	return name;
+}
+} // namespace
+
+GoldenCheck::GoldenCheck(App& app, const std::string& report, bool update) :
+	app_    (app),
+	report_ (report),
+	update_ (update)
+{}
+
+// The first interactive render includes building the domain texture; the
+// others are timed without it.
+bool GoldenCheck::run(const std::string& directory)
+{
+	app_.set_overlays_visible(false);
+
+	FILE* report = nullptr;
+	if (!report_.empty())
+	{
+		report = std::fopen(report_.c_str(), "w");
+		if (!report)
+			std::fprintf(stderr, "Could not write the golden report to %s.\n", report_.c_str());
+		else
+			std::fprintf(report, "[");
+	}
+
+	int num_failed = 0;
+	for (int i = 0; i < Wallpaper::NUM_GROUPS; ++i)
+	{
+		auto group = (Wallpaper::Group)i;
+		auto image = GOLDEN_IMAGES[i % std::size(GOLDEN_IMAGES)];
+
+		auto& layering = app_.layering();
+		layering = Layering();
+
+		auto& layer = layering.current_layer();
+		layer.tiling().set_symmetry_group(group);
+		layer.tiling().set_center({0.5f, 0.5f});
+		layer.tiling().set_scale(1.0f);
+
+		app_.load_layer_image(image);
+		layer.current_image().set_center({0.5f, 0.5f});
+
+		app_.set_view({0.5f, 0.5f}, GOLDEN_PIXELS_PER_UNIT);
+
+		GL::Texture render, render_hq;
+		auto first   = Profiler::time_runs(1, [&](){
+			render = app_.render_offscreen(GOLDEN_WIDTH, GOLDEN_HEIGHT, false);
+		});
+		auto renders = Profiler::time_runs(GOLDEN_RENDERS, [&](){
+			render = app_.render_offscreen(GOLDEN_WIDTH, GOLDEN_HEIGHT, false);
+		});
+		auto hq      = Profiler::time_runs(GOLDEN_RENDERS, [&](){
+			render_hq = app_.render_offscreen(GOLDEN_WIDTH, GOLDEN_HEIGHT, true);
+		});
+
+		auto path    = directory + "/" + golden_name(group) + ".png";
+		auto path_hq = directory + "/" + golden_name(group) + "_hq.png";
+
+		double difference = 0.0, difference_hq = 0.0;
+		if (update_)
+		{
+			GL::tex_to_png(render, path.c_str());
+			GL::tex_to_png(render_hq, path_hq.c_str());
+		}
+		else
+		{
+			difference    = golden_difference(GL::tex_to_pixels(render), GOLDEN_WIDTH, GOLDEN_HEIGHT, path);
+			difference_hq = golden_difference(GL::tex_to_pixels(render_hq), GOLDEN_WIDTH, GOLDEN_HEIGHT, path_hq);
+		}
+
+		// Missing golden images fail too.
+		bool passed = difference >= 0.0 && difference <= GOLDEN_PIXEL_TOLERANCE &&
+		              difference_hq >= 0.0 && difference_hq <= GOLDEN_PIXEL_TOLERANCE;
+		if (!passed)
+			++num_failed;
+
+		const char* name      = Wallpaper::info(group).name;
+		double      first_ms  = first.front();
+		double      render_ms = Profiler::percentile(renders, 0.5);
+		double      hq_ms     = Profiler::percentile(hq, 0.5);
+
+		std::printf("%-5s %-28s %s  differing %6.3f%%, HQ %6.3f%%  first %7.2f ms, render %7.2f ms, HQ %7.2f ms\n",
+		            name, image, passed ? "pass" : "FAIL", 100.0 * difference, 100.0 * difference_hq,
+		            first_ms, render_ms, hq_ms);
+
+		if (report)
+			std::fprintf(report, "%s\n{\"group\":\"%s\",\"image\":\"%s\",\"passed\":%s,\"differing\":%.6f,"
+			             "\"differing_hq\":%.6f,\"first_ms\":%.3f,\"render_ms\":%.3f,\"hq_ms\":%.3f}",
+			             i ? "," : "", name, image, passed ? "true" : "false",
+			             difference, difference_hq, first_ms, render_ms, hq_ms);
+	}
+
+	if (report)
+	{
+		std::fprintf(report, "\n]\n");
+		std::fclose(report);
+	}
+
+	if (update_)
+	{
+		std::printf("Wrote the golden images to %s.\n", directory.c_str());
+		return true;
+	}
+
+	std::printf("%d of %d groups failed.\n", num_failed, Wallpaper::NUM_GROUPS);
+	return num_failed == 0;
+}
@@ -0,0 +1,90 @@
+#include "InputEvent.h"
+
+#include <iomanip>
+#include <istream>
+#include <limits>
+#include <ostream>
+
+//--------------------
+
+namespace
+{
+const char* const TYPE_NAMES[] = {"key", "char", "button", "cursor", "scroll", "drop"};
+} // namespace
+
+std::ostream& operator<<(std::ostream& out, const InputEvent& event)
+{
+	out << std::setprecision(std::numeric_limits<double>::max_digits10)
+	    << event.time << ' ' << TYPE_NAMES[event.type];
+
+	switch (event.type)
+	{
+	case InputEvent::KEY:
+		out << ' ' << event.code << ' ' << event.scancode << ' ' << event.action << ' ' << event.mods;
+		break;
+	case InputEvent::CHAR:
+		out << ' ' << event.character;
+		break;
+	case InputEvent::MOUSE_BUTTON:
+		out << ' ' << event.code << ' ' << event.action << ' ' << event.mods;
+		break;
+	case InputEvent::MOUSE_POS:
+	case InputEvent::SCROLL:
+		out << ' ' << event.x << ' ' << event.y;
+		break;
+	case InputEvent::PATH_DROP:
+		out << ' ' << event.paths.size();
+		for (const auto& path : event.paths)
+			out << '\n' << path;
+		break;
+	}
+
+	return out << '\n';
+}
+
+std::istream& operator>>(std::istream& in, InputEvent& event)
+{
+	std::string type;
+	if (!(in >> event.time >> type))
+		return in;
+
+	event = InputEvent{event.time, InputEvent::KEY, 0, 0, 0, 0, 0, 0.0, 0.0, {}};
+
+	int index = 0;
+	while (index < 6 && type != TYPE_NAMES[index])
+		++index;
+
+	switch (index)
+	{
+	case InputEvent::KEY:
+		in >> event.code >> event.scancode >> event.action >> event.mods;
+		break;
+	case InputEvent::CHAR:
+		in >> event.character;
+		break;
+	case InputEvent::MOUSE_BUTTON:
+		in >> event.code >> event.action >> event.mods;
+		break;
+	case InputEvent::MOUSE_POS:
+	case InputEvent::SCROLL:
+		in >> event.x >> event.y;
+		break;
+	case InputEvent::PATH_DROP:
+	{
+		size_t count = 0;
+		in >> count;
+		in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+		event.paths.resize(count);
+		for (auto& path : event.paths)
+			std::getline(in, path);
+		break;
+	}
+	default:
+		in.setstate(std::ios::failbit);
+		return in;
+	}
+
+	event.type = (InputEvent::Type)index;
+	return in;
+}
@@ -0,0 +1,98 @@
+#include "InputReplay.h"
+
+#include "Profiler.h"
+#include "Window.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+//--------------------
+
+InputReplay::InputReplay(const std::string& path, double step) :
+	active_     (!path.empty()),
+	width_      (0),
+	height_     (0),
+	step_       (step),
+	next_event_ (0),
+	start_time_ (0.0),
+	clock_      (0.0)
+{
+	if (!active_)
+		return;
+
+	std::ifstream file(path);
+	std::string magic;
+	int version = 0;
+	if (!(file >> magic >> version >> width_ >> height_) || magic != "symmetrifier-input" || version != 1)
+		throw std::runtime_error("Could not read the input recording " + path + ".");
+
+	InputEvent event;
+	while (file >> event)
+		events_.push_back(std::move(event));
+
+	if (!file.eof())
+		std::fprintf(stderr, "Stopped reading %s at an invalid event.\n", path.c_str());
+}
+
+void InputReplay::start(MainWindow& window)
+{
+	window.begin_replay();
+	start_time_ = glfwGetTime();
+	clock_      = 0.0;
+}
+
+bool InputReplay::advance(MainWindow& window, double timeout)
+{
+	if (next_event_ == events_.size())
+		return false;
+
+	// The window still has to answer the window system.
+	if (step_ > 0.0)
+	{
+		glfwPollEvents();
+		clock_ += step_;
+	}
+	else
+	{
+		double wait = std::min(timeout, events_[next_event_].time - clock_);
+		if (wait > 0.0)
+			glfwWaitEventsTimeout(wait);
+		else
+			glfwPollEvents();
+
+		clock_ = glfwGetTime() - start_time_;
+	}
+
+	window.set_replay_time(clock_);
+
+	while (next_event_ < events_.size() && events_[next_event_].time <= clock_)
+		window.replay(events_[next_event_++]);
+
+	return true;
+}
+
+void InputReplay::add_frame_time(double seconds)
+{
+	frame_times_.push_back(seconds);
+}
+
+void InputReplay::report(void) const
+{
+	if (frame_times_.empty())
+		return;
+
+	auto times = frame_times_;
+	std::sort(std::begin(times), std::end(times));
+
+	double total = 0.0;
+	for (auto time : times)
+		total += time;
+
+	std::printf("Replayed %zu events in %zu frames, %.2f s of replay time.\n",
+	            events_.size(), times.size(), clock_);
+	std::printf("Frame times: mean %.2f ms, p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms.\n",
+	            1000.0 * total / times.size(), 1000.0 * Profiler::percentile(times, 0.5),
+	            1000.0 * Profiler::percentile(times, 0.9), 1000.0 * Profiler::percentile(times, 0.99),
+	            1000.0 * times.back());
+}
@@ -1,17 +1,45 @@
 #include "Layer.h"
 
 #include "GLFunctions.h"
+#include "ProgramCache.h"
+#include "Profiler.h"
+#include "Residency.h"
+#include <cmath>
 
 #define SCALE 0.98f
+#define MIN_DOMAIN_RESOLUTION 64u
+// The full resolution when the source images are smaller than this.
+#define BASE_DOMAIN_RESOLUTION 512u
+
+// Must match symmetrify_comp.glsl.
+#define COMPUTE_GROUP_SIZE 16u
+#define COMPUTE_MAX_IMAGES 16
+
+//--------------------
+
+namespace
+{
+const std::vector<ProgramCache::Stage> SYMMETRIFY_GRAPHICS_PROGRAM = {
+	{GL_VERTEX_SHADER,   "shaders/symmetrify_vert.glsl"},
+	{GL_FRAGMENT_SHADER, "shaders/symmetrify_frag.glsl"}
+};
+
+const std::vector<ProgramCache::Stage> SYMMETRIFY_COMPUTE_PROGRAM = {
+	{GL_COMPUTE_SHADER, "shaders/symmetrify_comp.glsl"}
+};
+} // namespace
 
 Layer::Layer(void) :
-	current_index_  (0),
-	position_       (0.0f, 0.0f),
-	t1_             (1.0f, 0.0f),
-	visible_        (true),
-	consistent_     (false),
-	symmetry_scale_ (SCALE),
-	error_image_    ("ERROR", GL::Texture::from_png("NONEXISTENT_FILE_ERROR"))
+	current_index_       (0),
+	position_            (0.0f, 0.0f),
+	t1_                  (1.0f, 0.0f),
+	visible_             (true),
+	consistent_          (false),
+	symmetry_scale_      (SCALE),
+	symmetry_mesh_group_ (tiling_.group()),
+	error_image_         ("ERROR", TextureCache::get().error_texture()),
+	domain_from_reduced_ (false),
+	last_used_frame_     (0)
 {
 	const Eigen::Vector2f bottom_centroid = {2.0f / 3.0f, 1.0f / 3.0f};
 	const Eigen::Vector2f top_centroid    = {1.0f / 3.0f, 2.0f / 3.0f};
@@ -26,6 +54,15 @@ Layer::Layer(void) :
 	};
 }
 
+std::vector<std::vector<ProgramCache::Stage>> Layer::programs(void)
+{
+	// Compute shaders need GL 4.3. Older contexts rasterize instead.
+	if (GLEW_VERSION_4_3)
+		return {SYMMETRIFY_COMPUTE_PROGRAM};
+	else
+		return {SYMMETRIFY_GRAPHICS_PROGRAM};
+}
+
 Layer::Layer(const std::string& image_name, GL::Texture&& texture) :
 	Layer()
 {
@@ -53,14 +90,49 @@ LayerImage& Layer::image(size_t index)
 	return const_cast<LayerImage&>(static_cast<const Layer&>(*this).image(index));
 }
 
-const GL::Texture& Layer::domain_texture(void) const
+const GL::Texture& Layer::domain_texture(unsigned resolution) const
 {
-	if (!consistent_)
-		symmetrify();
+	last_used_frame_ = Residency::get().frame();
+
+	auto dimension = domain_resolution(resolution);
+	if (!consistent_ || domain_texture_.width_ != dimension)
+		symmetrify(dimension);
 
 	return domain_texture_;
 }
 
+float Layer::domain_footprint(void) const
+{
+	const auto& info = Wallpaper::info(tiling_.group());
+	const auto  t1   = to_world_direction(tiling_.t1());
+	const auto  t2   = to_world_direction(tiling_.t2());
+
+	float longest = 0.0f;
+	for (int i = 0; i + 2 < info.num_vertices; i += 3)
+	{
+		for (int j = 0; j < 3; ++j)
+		{
+			const auto& a = info.triangles[i + j];
+			const auto& b = info.triangles[i + (j+1) % 3];
+			longest = std::max(longest, (t1 * (b.x - a.x) + t2 * (b.y - a.y)).norm());
+		}
+	}
+
+	return longest;
+}
+
+void Layer::release_domain_texture(void) const
+{
+	domain_texture_ = GL::Texture();
+	consistent_     = false;
+}
+
+void Layer::refresh_reduced(void) const
+{
+	if (domain_from_reduced_)
+		consistent_ = false;
+}
+
 Eigen::Vector2f Layer::to_world(const Eigen::Vector2f& v) const
 {
 	Eigen::Matrix2f basis;
@@ -128,19 +200,95 @@ void Layer::remove_image(size_t index)
 	remove_image(std::move(image(index)));
 }
 
-void Layer::symmetrify(void) const
+// Full resolution matches the largest source image, but is never below
+// the base resolution nor above the largest texture size. Hinted resolutions
+// are rounded up to a power of two so that small changes in zoom don't
+// cause rebuilds, and never exceed the full resolution.
+unsigned Layer::domain_resolution(unsigned hint) const
+{
+	static const unsigned max_texture_size = [](){
+		GLint size; glGetIntegerv(GL_MAX_TEXTURE_SIZE, &size);
+		return (unsigned)size;
+	}();
+
+	auto full = BASE_DOMAIN_RESOLUTION;
+	for (const auto& image : images_)
+		full = std::max({full, image.width(), image.height()});
+	full = std::min(full, max_texture_size);
+
+	if (hint == 0)
+		return full;
+
+	auto dimension = MIN_DOMAIN_RESOLUTION;
+	while (dimension < hint && dimension < full)
+		dimension *= 2;
+
+	return std::min(dimension, full);
+}
+
+void Layer::symmetrify(unsigned dimension) const
+{
+	Profiler::Zone zone("symmetrify");
+
+	// Compute shaders need GL 4.3. Older contexts rasterize instead.
+	static const bool use_compute = GLEW_VERSION_4_3;
+
+	// Set up the symmetrified texture.
+	if (domain_texture_.width_ != dimension)
+		domain_texture_ = GL::Texture::empty_2D_mipmap(dimension, dimension, MemoryUsage::DOMAIN_TEXTURE);
+
+	const auto& mesh = symmetry_mesh();
+	Eigen::Matrix2f lattice_basis;
+	lattice_basis << tiling_.t1(), tiling_.t2();
+
+	// Only this region of the images is sampled, at this density.
+	Eigen::AlignedBox2f domain;
+	for (const auto& p : mesh.positions_)
+		domain.extend(p.head<2>());
+
+	auto offsets = tiling_.lattice_offsets();
+	Eigen::AlignedBox2f lattice_region(domain.min() + offsets.min(), domain.max() + offsets.max());
+
+	Eigen::AlignedBox2f region;
+	for (int i = 0; i < 4; ++i)
+		region.extend(tiling_.position() + lattice_basis * lattice_region.corner((Eigen::AlignedBox2f::CornerType)i));
+
+	auto footprint       = domain_footprint();
+	auto texels_per_unit = footprint > 0.0f ? dimension * t1_.norm() / footprint : 0.0f;
+
+	std::vector<LayerImage::View> views;
+	domain_from_reduced_ = false;
+	for (const auto& image : images_)
+	{
+		views.push_back(image.view(region, texels_per_unit));
+		domain_from_reduced_ |= image.reduced();
+	}
+
+	if (use_compute)
+		symmetrify_compute(views, texels_per_unit);
+	else
+		symmetrify_graphics(views);
+
+	// The domain texture is minified when zoomed out.
+	GL::State::bind_texture(GL_TEXTURE_2D, domain_texture_);
+	glGenerateMipmap(GL_TEXTURE_2D);
+
+	consistent_ = true;
+}
+
+void Layer::symmetrify_graphics(const std::vector<LayerImage::View>& views) const
 {
-	static auto shader = GL::ShaderProgram::from_files(
-		"shaders/symmetrify_vert.glsl",
-		"shaders/symmetrify_frag.glsl");
+	static const auto& shader = ProgramCache::get().program(SYMMETRIFY_GRAPHICS_PROGRAM);
 
 	// Find uniform locations once.
+	static GLuint lattice_side_uniform;
 	static GLuint lattice_position_uniform;
 	static GLuint lattice_basis_uniform;
 	static GLuint image_position_uniform;
 	static GLuint image_basis_inv_uniform;
 	static GLuint sampler_uniform;
 	static bool init = [&](){
+		lattice_side_uniform     = glGetUniformLocation(shader, "uLatticeSide");
 		lattice_position_uniform = glGetUniformLocation(shader, "uLatticePos");
 		lattice_basis_uniform    = glGetUniformLocation(shader, "uLatticeBasis");
 		image_position_uniform   = glGetUniformLocation(shader, "uImagePos");
@@ -150,75 +298,160 @@ void Layer::symmetrify(void) const
 	}();
 	(void)init; // Suppress unused variable warning.
 
-	// Find the maximum image dimension.
-	auto dimension = 512u;
-	for (const auto& image : images_)
-	{
-		const auto& t = image.texture();
-		dimension = std::max({dimension, t.width_, t.height_});
-	}
-
-	// Set up the symmetrified texture.
-	if (domain_texture_.width_ != dimension)
-		domain_texture_ = GL::Texture::empty_2D(dimension, dimension);
 	auto fbo = GL::FBO::simple_C0(domain_texture_);
 
-	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	GL::State::bind_framebuffer(GL_FRAMEBUFFER, fbo);
 	glClearColor(0, 0, 0, 0);
 	glClear(GL_COLOR_BUFFER_BIT);
 
-	glActiveTexture(GL_TEXTURE1);
+	GL::State::active_texture(GL_TEXTURE1);
 
-	glViewport(0, 0, dimension, dimension);
+	GL::State::viewport(0, 0, domain_texture_.width_, domain_texture_.height_);
 
 	const auto& mesh = symmetry_mesh();
 	Eigen::Matrix2f lattice_basis;
 	lattice_basis << tiling_.t1(), tiling_.t2();
 
 	// Set the shader program, uniforms and texture parameters, and draw.
-	glUseProgram(shader);
-	glBindVertexArray(mesh.vao_);
+	GL::State::use_program(shader);
+	GL::State::bind_vao(mesh.vao_);
 
+	glUniform1i        (lattice_side_uniform, tiling_.lattice_side());
 	glUniform2fv       (lattice_position_uniform, 1, tiling_.position().data());
 	glUniformMatrix2fv (lattice_basis_uniform, 1, GL_FALSE, lattice_basis.data());
 	glUniform1i        (sampler_uniform, 1);
 
-	for (const auto& image : images_)
+	// Instances are drawn in order, so lattice domains blend in order too.
+	for (const auto& view : views)
 	{
-		Eigen::Matrix2f image_basis_inv = (Eigen::Matrix2f() << image.t1(), image.t2())
+		Eigen::Matrix2f image_basis_inv = (Eigen::Matrix2f() << view.t1, view.t2)
 		                                  .finished().inverse();
 
-		glBindTexture      (GL_TEXTURE_2D, image.texture());
-		glUniform2fv       (image_position_uniform, 1, image.position().data());
-		glUniformMatrix2fv (image_basis_inv_uniform, 1, GL_FALSE, image_basis_inv.data());
+		GL::State::bind_texture (GL_TEXTURE_2D, *view.texture);
+		glUniform2fv            (image_position_uniform, 1, view.position.data());
+		glUniformMatrix2fv      (image_basis_inv_uniform, 1, GL_FALSE, image_basis_inv.data());
 
-		glDrawArrays(mesh.primitive_type_, 0, mesh.num_vertices_);
+		glDrawArraysInstanced(mesh.primitive_type_, 0, mesh.num_vertices_, tiling_.num_lattice_domains());
+		Profiler::get().count_draw(mesh.primitive_type_, mesh.num_vertices_, tiling_.num_lattice_domains());
 	}
-
-	consistent_ = true;
 }
 
-const Mesh& Layer::symmetry_mesh(void) const
+// Writes the domain texture directly, without a framebuffer. The symmetry
+// mesh of one lattice domain is read from its position buffer and replicated
+// in the shader. Up to COMPUTE_MAX_IMAGES images
+// are sampled per dispatch, so a layer normally takes a single dispatch.
+void Layer::symmetrify_compute(const std::vector<LayerImage::View>& views, float texels_per_unit) const
 {
-	static const char* prev_symmetry_group = "";
-	const char*        curr_symmetry_group = tiling_.symmetry_group();
+	static const auto& shader = ProgramCache::get().program(SYMMETRIFY_COMPUTE_PROGRAM);
 
-	static int prev_lattice_domains = -1;
-	int        curr_lattice_domains = tiling_.num_lattice_domains();
+	// Find uniform locations once.
+	static GLuint num_domains_uniform;
+	static GLuint lattice_side_uniform;
+	static GLuint accumulate_uniform;
+	static GLuint lattice_position_uniform;
+	static GLuint lattice_basis_uniform;
+	static GLuint num_images_uniform;
+	static GLuint image_position_uniform;
+	static GLuint image_basis_inv_uniform;
+	static GLuint image_lod_uniform;
+	static GLuint sampler_uniform;
+	static bool init = [&](){
+		num_domains_uniform      = glGetUniformLocation(shader, "uNumDomains");
+		lattice_side_uniform     = glGetUniformLocation(shader, "uLatticeSide");
+		accumulate_uniform       = glGetUniformLocation(shader, "uAccumulate");
+		lattice_position_uniform = glGetUniformLocation(shader, "uLatticePos");
+		lattice_basis_uniform    = glGetUniformLocation(shader, "uLatticeBasis");
+		num_images_uniform       = glGetUniformLocation(shader, "uNumImages");
+		image_position_uniform   = glGetUniformLocation(shader, "uImagePos");
+		image_basis_inv_uniform  = glGetUniformLocation(shader, "uImageBasisInv");
+		image_lod_uniform        = glGetUniformLocation(shader, "uImageLod");
+		sampler_uniform          = glGetUniformLocation(shader, "uTextureSamplers");
+		return true;
+	}();
+	(void)init; // Suppress unused variable warning.
 
-	// If the symmetry group or the number of lattice domains has changed,
-	// the dilated symmetrification mesh must be updated.
-	if (strncmp(prev_symmetry_group, curr_symmetry_group, 8) ||
-	    prev_lattice_domains != curr_lattice_domains)
+	const auto& mesh = symmetry_mesh();
+	Eigen::Matrix2f lattice_basis;
+	lattice_basis << tiling_.t1(), tiling_.t2();
+
+	GL::State::use_program(shader);
+
+	glBindBufferBase   (GL_SHADER_STORAGE_BUFFER, 0, mesh.position_buffer_);
+	glBindImageTexture (0, domain_texture_, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA8);
+
+	glUniform1i        (num_domains_uniform, mesh.num_vertices_ / 6);
+	glUniform1i        (lattice_side_uniform, tiling_.lattice_side());
+	glUniform2fv       (lattice_position_uniform, 1, tiling_.position().data());
+	glUniformMatrix2fv (lattice_basis_uniform, 1, GL_FALSE, lattice_basis.data());
+
+	GLint units[COMPUTE_MAX_IMAGES];
+	for (int i = 0; i < COMPUTE_MAX_IMAGES; ++i)
+		units[i] = i;
+	glUniform1iv(sampler_uniform, COMPUTE_MAX_IMAGES, units);
+
+	auto groups = (domain_texture_.width_ + COMPUTE_GROUP_SIZE - 1) / COMPUTE_GROUP_SIZE;
+
+	// An empty layer still clears the texture.
+	size_t first = 0;
+	do
 	{
-		symmetry_mesh_   = Mesh();
-		const auto& mesh = tiling_.total_mesh();
+		auto count = std::min(views.size() - first, (size_t)COMPUTE_MAX_IMAGES);
+
+		Eigen::Vector2f positions[COMPUTE_MAX_IMAGES];
+		Eigen::Matrix2f basis_invs[COMPUTE_MAX_IMAGES];
+		float           lods[COMPUTE_MAX_IMAGES];
+		for (size_t i = 0; i < count; ++i)
+		{
+			const auto& view = views[first + i];
+			positions[i]  = view.position;
+			basis_invs[i] = (Eigen::Matrix2f() << view.t1, view.t2).finished().inverse();
+
+			// Source texels per domain texel, as the graphics path gets from derivatives.
+			auto source_texels = view.texture->width_ / view.t1.norm();
+			lods[i] = texels_per_unit > 0.0f ? std::max(0.0f, std::log2(source_texels / texels_per_unit)) : 0.0f;
+
+			GL::State::active_texture(GL_TEXTURE0 + i);
+			GL::State::bind_texture(GL_TEXTURE_2D, *view.texture);
+		}
+
+		glUniform1i        (accumulate_uniform, first > 0);
+		glUniform1i        (num_images_uniform, count);
+		glUniform2fv       (image_position_uniform, count, positions[0].data());
+		glUniformMatrix2fv (image_basis_inv_uniform, count, GL_FALSE, basis_invs[0].data());
+		glUniform1fv       (image_lod_uniform, count, lods);
+
+		glDispatchCompute(groups, groups, 1);
+
+		// The next batch reads what this one wrote.
+		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+		first += count;
+	} while (first < views.size());
+
+	glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT);
+
+	// Leave unit 1 active, as the graphics path does.
+	GL::State::active_texture(GL_TEXTURE1);
+}
+
+const Mesh& Layer::symmetry_mesh(void) const
+{
+	// If the symmetry group has changed, the dilated symmetrification mesh
+	// must be updated. It covers one lattice domain; the others are instances.
+	if (symmetry_mesh_.positions_.empty() || symmetry_mesh_group_ != tiling_.group())
+	{
+		const auto& info = Wallpaper::info(tiling_.group());
+		auto vertex      = [&info](int i){ return Eigen::Vector3f(info.triangles[i].x, info.triangles[i].y, 0.0f); };
+
+		// Rebuild in place, keeping the storage of the vectors and buffers.
+		symmetry_mesh_.clear();
+		symmetry_mesh_.positions_.reserve(info.num_vertices);
 
-		for (size_t i = 0; i < mesh.positions_.size(); i += 3)
+		for (int i = 0; i < info.num_vertices; i += 3)
 		{
-			const Eigen::Vector3f& a        = mesh.positions_[i];
-			const Eigen::Vector3f& b        = mesh.positions_[i+1];
-			const Eigen::Vector3f& c        = mesh.positions_[i+2];
+			const Eigen::Vector3f  a        = vertex(i);
+			const Eigen::Vector3f  b        = vertex(i+1);
+			const Eigen::Vector3f  c        = vertex(i+2);
 			const Eigen::Vector3f  centroid = (a + b + c) / 3.0f;
 
 			symmetry_mesh_.positions_.push_back(centroid + 1.0f / symmetry_scale_ * (a - centroid));
@@ -227,8 +460,7 @@ const Mesh& Layer::symmetry_mesh(void) const
 		}
 
 		symmetry_mesh_.update_buffers();
-		prev_symmetry_group = curr_symmetry_group;
-		prev_lattice_domains = curr_lattice_domains;
+		symmetry_mesh_group_ = tiling_.group();
 	}
 
 	return symmetry_mesh_;
@@ -1,6 +1,12 @@
 #include "LayerImage.h"
 
 LayerImage::LayerImage(const std::string& name, GL::Texture&& texture) :
+	LayerImage(name, std::make_shared<GL::Texture>(std::move(texture)))
+{}
+
+LayerImage::LayerImage(const std::string& name, TextureCache::Handle texture) :
+	width_    (0),
+	height_   (0),
 	position_ (0.0f, 0.0f),
 	t1_       (1.0f, 0.0f),
 	name_     (name)
@@ -8,6 +14,39 @@ LayerImage::LayerImage(const std::string& name, GL::Texture&& texture) :
 	set_texture(std::move(texture));
 }
 
+const GL::Texture& LayerImage::texture(void) const
+{
+	TextureCache::get().touch(texture_);
+	return *texture_;
+}
+
+LayerImage::View LayerImage::view(const Eigen::AlignedBox2f& region, float texels_per_unit) const
+{
+	// Counts as a use of the whole texture, even if only tiles are drawn.
+	texture();
+
+	auto tiles = TextureCache::get().tiles(texture_);
+	if (!tiles)
+		return {texture_, position_, t1_, t2()};
+
+	// Find the region in the unit square of the image.
+	Eigen::Matrix2f basis_inv = (Eigen::Matrix2f() << t1_, t2()).finished().inverse();
+	Eigen::AlignedBox2f image_region;
+	for (int i = 0; i < 4; ++i)
+	{
+		auto corner = region.corner((Eigen::AlignedBox2f::CornerType)i);
+		image_region.extend(basis_inv * (corner - position_));
+	}
+
+	auto window = tiles->window(image_region.min(), image_region.max(), texels_per_unit * scale());
+	Eigen::Vector2f size = window.max - window.min;
+
+	return {window.texture,
+	        position_ + window.min.x() * t1_ + window.min.y() * t2(),
+	        size.x() * t1_,
+	        size.y() * t2()};
+}
+
 Eigen::Vector2f LayerImage::center(void) const
 {
 	return position_ + (t1_ + t2()) / 2.0f;
@@ -16,7 +55,7 @@ Eigen::Vector2f LayerImage::center(void) const
 Eigen::Vector2f LayerImage::t2(void) const
 {
 	Eigen::Vector2f orthogonal = { -t1_.y(), t1_.x() };
-	orthogonal *= texture_.height_ / (float)texture_.width_;
+	orthogonal *= height_ / (float)width_;
 
 	return orthogonal;
 }
@@ -27,18 +66,41 @@ float LayerImage::rotation(void) const
 }
 
 void LayerImage::set_texture(GL::Texture&& texture)
+{
+	set_texture(std::make_shared<GL::Texture>(std::move(texture)));
+}
+
+void LayerImage::set_texture(TextureCache::Handle texture)
 {
 	texture_ = std::move(texture);
+	set_sampling_parameters(*texture_);
+
+	// Cached textures are brought back to full resolution when handed out,
+	// so these are the source dimensions even if the texture is reduced later.
+	width_  = texture_->width_;
+	height_ = texture_->height_;
+}
 
-	// We'll use nearest neighbor filtering.
-	glBindTexture(GL_TEXTURE_2D, texture_);
+void LayerImage::set_sampling_parameters(const GL::Texture& texture)
+{
+	GLuint old_tex = GL::State::texture(GL_TEXTURE_2D);
+
+	// We'll use nearest neighbor filtering, except through the mipmaps
+	// when minified, so that small domain textures don't alias.
+	// Shared textures are always used the same way, so this is fine for them too.
+	GL::State::bind_texture(GL_TEXTURE_2D, texture);
+
+	GLint mip_width = 0;
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 1, GL_TEXTURE_WIDTH, &mip_width);
 
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mip_width > 0 ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST);
 
 	// Sensible wrapping parameters.
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+
+	GL::State::bind_texture(GL_TEXTURE_2D, old_tex);
 }
 
 void LayerImage::set_center(const Eigen::Vector2f& center)
@@ -0,0 +1,115 @@
+#include "MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+//--------------------
+
+MappedFile::MappedFile(void) :
+	data_  (nullptr),
+	size_  (0),
+	owner_ (MemoryUsage::OTHER)
+{}
+
+MappedFile::MappedFile(const std::string& path, MemoryUsage::Owner owner) :
+	MappedFile()
+{
+	owner_ = owner;
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+	                          OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return;
+
+	LARGE_INTEGER size;
+	if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+	{
+		// The view keeps the mapping alive, so the handles can be closed.
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping != NULL)
+		{
+			data_ = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			size_ = data_ ? (size_t)size.QuadPart : 0;
+			CloseHandle(mapping);
+		}
+	}
+	CloseHandle(file);
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return;
+
+	struct stat info;
+	if (fstat(fd, &info) == 0 && info.st_size > 0)
+	{
+		// The mapping stays valid after the descriptor is closed.
+		void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		if (data != MAP_FAILED)
+		{
+			data_ = (const unsigned char*)data;
+			size_ = info.st_size;
+		}
+	}
+	close(fd);
+#endif
+
+	MemoryUsage::get().resize(MemoryUsage::HOST, owner_, 0, size_);
+}
+
+MappedFile::MappedFile(MappedFile&& other) :
+	data_  (other.data_),
+	size_  (other.size_),
+	owner_ (other.owner_)
+{
+	other.data_ = nullptr;
+	other.size_ = 0;
+}
+
+MappedFile::~MappedFile(void)
+{
+	unmap();
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other)
+{
+	if (this != &other)
+	{
+		unmap();
+		data_  = other.data_;
+		size_  = other.size_;
+		owner_ = other.owner_;
+
+		other.data_ = nullptr;
+		other.size_ = 0;
+	}
+
+	return *this;
+}
+
+void MappedFile::unmap(void)
+{
+	if (data_ == nullptr)
+		return;
+
+	MemoryUsage::get().resize(MemoryUsage::HOST, owner_, size_, 0);
+
+#ifdef _WIN32
+	UnmapViewOfFile(data_);
+#else
+	munmap(const_cast<unsigned char*>(data_), size_);
+#endif
+
+	data_ = nullptr;
+	size_ = 0;
+}
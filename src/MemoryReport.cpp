@@ -0,0 +1,66 @@
+#include "MemoryReport.h"
+
+#include "Layering.h"
+#include "MemoryUsage.h"
+#include <cstdio>
+
+//--------------------
+
+namespace
+{
+// For names in JSON output. Control characters are dropped.
+std::string json_escape(const std::string& string)
+{
+	std::string escaped;
+	for (char c : string)
+	{
+		if (c == '"' || c == '\\')
+			escaped += '\\';
+		if ((unsigned char)c >= 0x20)
+			escaped += c;
+	}
+
+	return escaped;
+}
+} // namespace
+
+bool MemoryReport::write(const std::string& path, const Layering& layering)
+{
+	FILE* file = std::fopen(path.c_str(), "w");
+	if (!file)
+	{
+		std::fprintf(stderr, "Could not write the memory usage to %s.\n", path.c_str());
+		return false;
+	}
+
+	std::fprintf(file, "{\"pools\":");
+	MemoryUsage::get().write_json(file);
+
+	std::fprintf(file, ",\n\"layers\":[");
+	for (size_t i = 0; i < layering.size(); ++i)
+	{
+		const auto& layer = layering.layer(i);
+		std::fprintf(file, "%s\n{\"domain_texture\":%zu,\"images\":[", i ? "," : "",
+		             layer.domain_texture_bytes());
+
+		bool first = true;
+		for (const auto& image : layer)
+		{
+			std::fprintf(file, "%s{\"name\":\"%s\",\"width\":%u,\"height\":%u,"
+			             "\"resident_width\":%u,\"resident_height\":%u,\"bytes\":%zu}",
+			             first ? "" : ",", json_escape(image.name()).c_str(), image.width(), image.height(),
+			             image.resident().width_, image.resident().height_, image.bytes());
+			first = false;
+		}
+		std::fprintf(file, "]}");
+	}
+	std::fprintf(file, "\n]}\n");
+
+	bool successful = std::ferror(file) == 0;
+	std::fclose(file);
+
+	if (successful)
+		std::printf("Wrote the memory usage to %s.\n", path.c_str());
+
+	return successful;
+}
@@ -0,0 +1,87 @@
+#include "MemoryUsage.h"
+
+#include <algorithm>
+
+//--------------------
+
+namespace
+{
+void apply(MemoryUsage::Total& total, size_t old_bytes, size_t new_bytes)
+{
+	total.bytes = total.bytes - old_bytes + new_bytes;
+	total.peak  = std::max(total.peak, total.bytes);
+
+	if (old_bytes == 0 && new_bytes > 0)
+		total.objects += 1;
+	else if (old_bytes > 0 && new_bytes == 0)
+		total.objects -= 1;
+}
+
+void write_total(FILE* file, const MemoryUsage::Total& total)
+{
+	std::fprintf(file, "{\"bytes\":%zu,\"peak\":%zu,\"objects\":%zu}",
+	             total.bytes, total.peak, total.objects);
+}
+} // namespace
+
+// Never destroyed, so that objects held by other singletons
+// can still report their release when those are destroyed.
+MemoryUsage& MemoryUsage::get(void)
+{
+	static MemoryUsage* usage = new MemoryUsage();
+	return *usage;
+}
+
+MemoryUsage::MemoryUsage(void)
+{
+	for (auto& pool : totals_)
+		pool.fill({0, 0, 0});
+
+	pool_totals_.fill({0, 0, 0});
+}
+
+const char* MemoryUsage::name(Owner owner)
+{
+	switch (owner)
+	{
+		case SOURCE_IMAGE:   return "source_image";
+		case DOMAIN_TEXTURE: return "domain_texture";
+		case MESH:           return "mesh";
+		case FOLD_TABLE:     return "fold_table";
+		case EXPORT:         return "export";
+		case GUI:            return "gui";
+		default:             return "other";
+	}
+}
+
+const char* MemoryUsage::name(Pool pool)
+{
+	return pool == GPU ? "gpu" : "host";
+}
+
+void MemoryUsage::resize(Pool pool, Owner owner, size_t old_bytes, size_t new_bytes)
+{
+	if (old_bytes == new_bytes)
+		return;
+
+	apply(totals_[pool][owner], old_bytes, new_bytes);
+	apply(pool_totals_[pool], old_bytes, new_bytes);
+}
+
+void MemoryUsage::write_json(FILE* file) const
+{
+	std::fprintf(file, "{");
+	for (int pool = 0; pool < NUM_POOLS; ++pool)
+	{
+		std::fprintf(file, "%s\"%s\":{\"total\":", pool ? "," : "", name((Pool)pool));
+		write_total(file, pool_totals_[pool]);
+
+		for (int owner = 0; owner < NUM_OWNERS; ++owner)
+		{
+			std::fprintf(file, ",\"%s\":", name((Owner)owner));
+			write_total(file, totals_[pool][owner]);
+		}
+		std::fprintf(file, "}");
+	}
+	std::fprintf(file, "}");
+}
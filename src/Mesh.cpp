@@ -1,6 +1,7 @@
 #include "Mesh.h"
 
 #include <iostream>
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 
@@ -9,30 +10,50 @@ using namespace Eigen;
 
 //--------------------
 
+namespace {
+// Reuses the storage of the buffer when the data fits. Storage grows
+// geometrically, so a mesh rebuilt over and over settles at a size
+// and stops reallocating.
+void upload(GL::Buffer& buffer, size_t& capacity, const void* data, size_t size) {
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+	if (size > capacity) {
+		capacity = std::max(size, 2 * capacity);
+		glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STATIC_DRAW);
+		buffer.set_bytes(capacity);
+	}
+
+	glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+}
+} // namespace
+
+void Mesh::clear(void) {
+	positions_.clear();
+	normals_.clear();
+	texcoords_.clear();
+}
+
 void Mesh::update_buffers(void) {
-	glBindVertexArray(vao_);
+	GL::State::bind_vao(vao_);
 
 	glDisableVertexAttribArray(0);
 	glDisableVertexAttribArray(1);
 	glDisableVertexAttribArray(2);
 
 	if (!positions_.empty()) {
-		glBindBuffer(GL_ARRAY_BUFFER, position_buffer_);
+		upload(position_buffer_, position_capacity_, positions_[0].data(), sizeof(Vector3f) * positions_.size());
 		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vector3f), (GLvoid*)0);
 		glEnableVertexAttribArray(0);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(Vector3f) * positions_.size(), positions_[0].data(), GL_STATIC_DRAW);
 
 		if (normals_.size() == positions_.size()) {
-			glBindBuffer(GL_ARRAY_BUFFER, normal_buffer_);
+			upload(normal_buffer_, normal_capacity_, normals_[0].data(), sizeof(Vector3f) * normals_.size());
 			glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vector3f), (GLvoid*)0);
 			glEnableVertexAttribArray(1);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(Vector3f) * normals_.size(), normals_[0].data(), GL_STATIC_DRAW);
 		}
 		if (texcoords_.size() == positions_.size()) {
-			glBindBuffer(GL_ARRAY_BUFFER, texcoord_buffer_);
+			upload(texcoord_buffer_, texcoord_capacity_, texcoords_[0].data(), sizeof(Vector2f) * texcoords_.size());
 			glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vector2f), (GLvoid*)0);
 			glEnableVertexAttribArray(2);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(Vector2f) * texcoords_.size(), texcoords_[0].data(), GL_STATIC_DRAW);
 		}
 	}
 
@@ -256,22 +277,25 @@ Mesh Mesh::cube(void) {
 	}
 
 	// Store in the VAO all the info necessary for drawing sequential vertices.
-	glBindVertexArray(mesh.vao_);
+	GL::State::bind_vao(mesh.vao_);
 
 	// Bind the VBO to store the cube's vertices.
 	glBindBuffer(GL_ARRAY_BUFFER, mesh.position_buffer_);
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vector3f), (GLvoid*)0);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(Vector3f) * position_buffer_data.size(), position_buffer_data[0].data(), GL_STATIC_DRAW);
+	mesh.position_buffer_.set_bytes(sizeof(Vector3f) * position_buffer_data.size());
 
 	// Bind the VBO to store the cube's normals.
 	glBindBuffer(GL_ARRAY_BUFFER, mesh.normal_buffer_);
 	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vector3f), (GLvoid*)0);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(Vector3f) * normal_buffer_data.size(), normal_buffer_data[0].data(), GL_STATIC_DRAW);
+	mesh.normal_buffer_.set_bytes(sizeof(Vector3f) * normal_buffer_data.size());
 
 	// Bind the VBO to store the cube's texcoords.
 	glBindBuffer(GL_ARRAY_BUFFER, mesh.texcoord_buffer_);
 	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vector2f), (GLvoid*)0);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(texcoords), texcoords[0].data(), GL_STATIC_DRAW);
+	mesh.texcoord_buffer_.set_bytes(sizeof(texcoords));
 
 	glEnableVertexAttribArray(0);
 	glEnableVertexAttribArray(1);
@@ -0,0 +1,123 @@
+#include "MeshArena.h"
+
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+//--------------------
+
+namespace
+{
+struct Builder
+{
+	std::vector<MeshArena::Vertex> vertices;
+	std::vector<GLushort>          indices;
+
+	// Starts a new range. Its vertices are indexed from zero.
+	MeshArena::Range begin(GLenum primitive_type)
+	{
+		first_vertex_ = vertices.size();
+		return {primitive_type, 0, indices.size() * sizeof(GLushort), (GLint)first_vertex_};
+	}
+
+	// Adds a vertex to the current range, reusing an identical one if there is one.
+	void add(const MeshArena::Vertex& vertex, MeshArena::Range& range)
+	{
+		auto same = [&vertex](const MeshArena::Vertex& v){ return !std::memcmp(&v, &vertex, sizeof(vertex)); };
+		auto it   = std::find_if(std::begin(vertices) + first_vertex_, std::end(vertices), same);
+
+		indices.push_back(it - std::begin(vertices) - first_vertex_);
+		if (it == std::end(vertices))
+			vertices.push_back(vertex);
+
+		++range.num_indices;
+	}
+
+private:
+	size_t first_vertex_ = 0;
+};
+
+GLushort normalized(float coordinate)
+{
+	return std::lround(coordinate * 65535.0f);
+}
+
+std::array<GLubyte, 3> line_color(Wallpaper::LineType type)
+{
+	switch (type)
+	{
+		case Wallpaper::LineType::Mirror:
+			return {26, 153, 255};
+		case Wallpaper::LineType::Rotation:
+			return {26, 255, 153};
+		default:
+			return {255, 153, 26};
+	}
+}
+} // namespace
+
+const MeshArena& MeshArena::get(void)
+{
+	static MeshArena arena;
+	return arena;
+}
+
+MeshArena::MeshArena(void)
+{
+	Builder builder;
+
+	for (int group = 0; group < Wallpaper::NUM_GROUPS; ++group)
+	{
+		const auto& info = Wallpaper::info((Wallpaper::Group)group);
+
+		auto& domain = domains_[group] = builder.begin(GL_TRIANGLES);
+		for (int i = 0; i < info.num_vertices; ++i)
+		{
+			const auto& p = info.triangles[i];
+			builder.add({normalized(p.x), normalized(p.y), 0, 0, 0, (GLubyte)(i % 6)}, domain);
+		}
+
+		auto& frame = frames_[group] = builder.begin(GL_LINES);
+		for (int i = 0; i < info.num_frame_lines; ++i)
+		{
+			const auto& line  = info.frame[i];
+			const auto  color = line_color(line.type);
+
+			for (const auto& p : {line.a, line.b})
+				builder.add({normalized(p.x), normalized(p.y), color[0], color[1], color[2], 0}, frame);
+		}
+	}
+
+	GL::State::bind_vao(vao_);
+
+	glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_);
+	glBufferData(GL_ARRAY_BUFFER, builder.vertices.size() * sizeof(Vertex), builder.vertices.data(), GL_STATIC_DRAW);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, builder.indices.size() * sizeof(GLushort), builder.indices.data(), GL_STATIC_DRAW);
+
+	vertex_buffer_.set_owner(MemoryUsage::MESH);
+	vertex_buffer_.set_bytes(builder.vertices.size() * sizeof(Vertex));
+	index_buffer_.set_owner(MemoryUsage::MESH);
+	index_buffer_.set_bytes(builder.indices.size() * sizeof(GLushort));
+
+	glVertexAttribPointer  (0, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(Vertex), (GLvoid*)offsetof(Vertex, x));
+	glVertexAttribPointer  (1, 3, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (GLvoid*)offsetof(Vertex, r));
+	glVertexAttribIPointer (2, 1, GL_UNSIGNED_BYTE, sizeof(Vertex), (GLvoid*)offsetof(Vertex, corner));
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+	glEnableVertexAttribArray(2);
+
+	GL::State::bind_vao(0);
+}
+
+void MeshArena::draw(const Range& range, GLsizei num_instances) const
+{
+	GL::State::bind_vao(vao_);
+	glDrawElementsInstancedBaseVertex(range.primitive_type, range.num_indices, GL_UNSIGNED_SHORT,
+	                                  (GLvoid*)range.index_offset, num_instances, range.base_vertex);
+	Profiler::get().count_draw(range.primitive_type, range.num_indices, num_instances);
+}
@@ -0,0 +1,46 @@
+#include "Options.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// How much of the latest activity a trace covers, in seconds.
+#define TRACE_SECONDS 10.0
+
+//--------------------
+
+Options Options::parse(int argc, char* argv[])
+{
+	Options options{"", TRACE_SECONDS, "", "", "", 0.0, "", "", "", false};
+
+	// [--trace <file>] [--trace-seconds <seconds>] [--memory <file>]
+	// [--record <file> | --replay <file> [--replay-step <seconds>] | --scene-benchmark <file> |
+	//  --golden <directory> [--golden-report <file>] [--golden-update]]
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+			options.trace_file = argv[++i];
+		else if (std::strcmp(argv[i], "--trace-seconds") == 0 && i + 1 < argc)
+			options.trace_seconds = std::atof(argv[++i]);
+		else if (std::strcmp(argv[i], "--memory") == 0 && i + 1 < argc)
+			options.memory_file = argv[++i];
+		else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+			options.record_file = argv[++i];
+		else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+			options.replay_file = argv[++i];
+		else if (std::strcmp(argv[i], "--replay-step") == 0 && i + 1 < argc)
+			options.replay_step = std::atof(argv[++i]);
+		else if (std::strcmp(argv[i], "--scene-benchmark") == 0 && i + 1 < argc)
+			options.benchmark_file = argv[++i];
+		else if (std::strcmp(argv[i], "--golden") == 0 && i + 1 < argc)
+			options.golden_directory = argv[++i];
+		else if (std::strcmp(argv[i], "--golden-report") == 0 && i + 1 < argc)
+			options.golden_report = argv[++i];
+		else if (std::strcmp(argv[i], "--golden-update") == 0)
+			options.update_golden = true;
+		else
+			std::fprintf(stderr, "Unknown argument %s.\n", argv[i]);
+	}
+
+	return options;
+}
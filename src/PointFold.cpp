@@ -0,0 +1,259 @@
+#include "PointFold.h"
+
+#include "Layer.h"
+#include "Tiling.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define POINTFOLD_SSE2
+	#include <emmintrin.h>
+#endif
+
+//--------------------
+
+namespace
+{
+// One point at a time. Also handles the leftovers of the vector kernels.
+struct ScalarLanes
+{
+	using Float = float;
+	using Mask  = bool;
+
+	static const int width = 1;
+
+	static Float set       (float a)                 { return a; }
+	static Float load      (const float* p)          { return *p; }
+	static void  store     (float* p, Float a)       { *p = a; }
+	static void  store_int (int32_t* p, Float a)     { *p = (int32_t)a; }
+
+	static Float add       (Float a, Float b)        { return a + b; }
+	static Float sub       (Float a, Float b)        { return a - b; }
+	static Float mul       (Float a, Float b)        { return a * b; }
+	static Float min       (Float a, Float b)        { return a < b ? a : b; }
+	static Float floor     (Float a)                 { return std::floor(a); }
+	static Mask  greater   (Float a, Float b)        { return a > b; }
+	static Float select    (Mask m, Float a, Float b) { return m ? a : b; }
+};
+
+#if defined(__AVX2__)
+struct VectorLanes
+{
+	using Float = __m256;
+	using Mask  = __m256;
+
+	static const int width = 8;
+
+	static Float set       (float a)                 { return _mm256_set1_ps(a); }
+	static Float load      (const float* p)          { return _mm256_loadu_ps(p); }
+	static void  store     (float* p, Float a)       { _mm256_storeu_ps(p, a); }
+	static void  store_int (int32_t* p, Float a)     { _mm256_storeu_si256((__m256i*)p, _mm256_cvttps_epi32(a)); }
+
+	static Float add       (Float a, Float b)        { return _mm256_add_ps(a, b); }
+	static Float sub       (Float a, Float b)        { return _mm256_sub_ps(a, b); }
+	static Float mul       (Float a, Float b)        { return _mm256_mul_ps(a, b); }
+	static Float min       (Float a, Float b)        { return _mm256_min_ps(a, b); }
+	static Float floor     (Float a)                 { return _mm256_floor_ps(a); }
+	static Mask  greater   (Float a, Float b)        { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	static Float select    (Mask m, Float a, Float b) { return _mm256_blendv_ps(b, a, m); }
+};
+#elif defined(POINTFOLD_SSE2)
+struct VectorLanes
+{
+	using Float = __m128;
+	using Mask  = __m128;
+
+	static const int width = 4;
+
+	static Float set       (float a)                 { return _mm_set1_ps(a); }
+	static Float load      (const float* p)          { return _mm_loadu_ps(p); }
+	static void  store     (float* p, Float a)       { _mm_storeu_ps(p, a); }
+	static void  store_int (int32_t* p, Float a)     { _mm_storeu_si128((__m128i*)p, _mm_cvttps_epi32(a)); }
+
+	static Float add       (Float a, Float b)        { return _mm_add_ps(a, b); }
+	static Float sub       (Float a, Float b)        { return _mm_sub_ps(a, b); }
+	static Float mul       (Float a, Float b)        { return _mm_mul_ps(a, b); }
+	static Float min       (Float a, Float b)        { return _mm_min_ps(a, b); }
+	static Mask  greater   (Float a, Float b)        { return _mm_cmpgt_ps(a, b); }
+	static Float select    (Mask m, Float a, Float b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+
+	// SSE2 has no rounding instructions. Truncate and fix up negative values.
+	static Float floor(Float a)
+	{
+		Float t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+		return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1.0f)));
+	}
+};
+#else
+using VectorLanes = ScalarLanes;
+#endif
+} // namespace
+
+// NumTriangles is known at compile time for every group, so the search
+// over the triangles of the lattice domain is fully unrolled.
+// Zero means a runtime count.
+template <typename Lanes, int NumTriangles>
+struct FoldKernel
+{
+	using Float = typename Lanes::Float;
+	using Mask  = typename Lanes::Mask;
+
+	static void run(const PointFold& fold, const float* x, const float* y,
+	                size_t begin, size_t end, PointFold::Result& result)
+	{
+		const Float m00 = Lanes::set(fold.to_lattice_(0, 0));
+		const Float m01 = Lanes::set(fold.to_lattice_(0, 1));
+		const Float m10 = Lanes::set(fold.to_lattice_(1, 0));
+		const Float m11 = Lanes::set(fold.to_lattice_(1, 1));
+		const Float o0  = Lanes::set(fold.offset_.x());
+		const Float o1  = Lanes::set(fold.offset_.y());
+		const Float sc  = Lanes::set(fold.scale_);
+
+		const Float zero  = Lanes::set(0.0f);
+		const Float half  = Lanes::set(0.5f);
+		const Float one   = Lanes::set(1.0f);
+		const Float two   = Lanes::set(2.0f);
+		const Float third = Lanes::set(1.0f / 3.0f);
+
+		const int count = NumTriangles > 0 ? NumTriangles : fold.num_triangles_;
+
+		size_t i = begin;
+		for (; i + Lanes::width <= end; i += Lanes::width)
+		{
+			Float px = Lanes::load(x + i);
+			Float py = Lanes::load(y + i);
+
+			Float lx = Lanes::add(Lanes::add(Lanes::mul(m00, px), Lanes::mul(m01, py)), o0);
+			Float ly = Lanes::add(Lanes::add(Lanes::mul(m10, px), Lanes::mul(m11, py)), o1);
+
+			// Translations fold away.
+			Float cell_x = Lanes::floor(lx);
+			Float cell_y = Lanes::floor(ly);
+			Float fx     = Lanes::sub(lx, cell_x);
+			Float fy     = Lanes::sub(ly, cell_y);
+
+			// The triangle the point is deepest inside contains it.
+			Float best  = Lanes::set(-1e9f);
+			Float b1    = zero;
+			Float b2    = zero;
+			Float index = zero;
+			for (int t = 0; t < count; ++t)
+			{
+				const auto& T = fold.triangles_[t];
+
+				Float c1 = Lanes::add(Lanes::add(Lanes::mul(Lanes::set(T[0]), fx),
+				                                 Lanes::mul(Lanes::set(T[2]), fy)), Lanes::set(T[4]));
+				Float c2 = Lanes::add(Lanes::add(Lanes::mul(Lanes::set(T[1]), fx),
+				                                 Lanes::mul(Lanes::set(T[3]), fy)), Lanes::set(T[5]));
+
+				Float inside = Lanes::min(Lanes::min(c1, c2), Lanes::sub(one, Lanes::add(c1, c2)));
+				Mask  deeper = Lanes::greater(inside, best);
+
+				best  = Lanes::select(deeper, inside, best);
+				b1    = Lanes::select(deeper, c1, b1);
+				b2    = Lanes::select(deeper, c2, b2);
+				index = Lanes::select(deeper, Lanes::set((float)t), index);
+			}
+
+			// Each symmetry domain is two triangles: the even one maps to the
+			// bottom half of the domain texture, the odd one to the top half.
+			Float domain = Lanes::floor(Lanes::mul(index, half));
+			Float top    = Lanes::sub(index, Lanes::mul(domain, two));
+
+			// Bottom: (b1 + b2, b2). Top: (1 - b1 - b2, 1 - b2).
+			Float s = Lanes::add(b1, b2);
+			Float u = Lanes::add(s,  Lanes::mul(top, Lanes::sub(one, Lanes::mul(two, s))));
+			Float v = Lanes::add(b2, Lanes::mul(top, Lanes::sub(one, Lanes::mul(two, b2))));
+
+			// Centroids: (2/3, 1/3) at the bottom, (1/3, 2/3) at the top.
+			Float cu = Lanes::sub(Lanes::mul(two, third), Lanes::mul(top, third));
+			Float cv = Lanes::add(third, Lanes::mul(top, third));
+			u = Lanes::add(cu, Lanes::mul(sc, Lanes::sub(u, cu)));
+			v = Lanes::add(cv, Lanes::mul(sc, Lanes::sub(v, cv)));
+
+			Lanes::store     (&result.u[i], u);
+			Lanes::store     (&result.v[i], v);
+			Lanes::store_int (&result.lattice_x[i], cell_x);
+			Lanes::store_int (&result.lattice_y[i], cell_y);
+			Lanes::store_int (&result.domain[i], domain);
+		}
+
+		// Leftovers one at a time.
+		if (Lanes::width > 1 && i < end)
+			FoldKernel<ScalarLanes, NumTriangles>::run(fold, x, y, i, end, result);
+	}
+};
+
+void PointFold::Result::resize(size_t n)
+{
+	u.resize(n);
+	v.resize(n);
+	lattice_x.resize(n);
+	lattice_y.resize(n);
+	domain.resize(n);
+}
+
+PointFold::PointFold(const Tiling& tiling)
+{
+	Eigen::Matrix2f basis;
+	basis << tiling.t1(), tiling.t2();
+
+	set_up(tiling, basis, tiling.position(), 1.0f);
+}
+
+PointFold::PointFold(const Layer& layer)
+{
+	const auto& tiling = layer.tiling();
+
+	Eigen::Matrix2f basis;
+	basis << layer.to_world_direction(tiling.t1()), layer.to_world_direction(tiling.t2());
+
+	set_up(tiling, basis, layer.to_world(tiling.position()), layer.symmetry_scale());
+}
+
+void PointFold::fold(const float* x, const float* y, size_t n, Result& result) const
+{
+	result.resize(n);
+	kernel_(*this, x, y, 0, n, result);
+}
+
+const char* PointFold::instruction_set(void)
+{
+#if defined(__AVX2__)
+	return "AVX2";
+#elif defined(POINTFOLD_SSE2)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
+
+void PointFold::set_up(const Tiling& tiling, const Eigen::Matrix2f& basis, const Eigen::Vector2f& position,
+                       float scale)
+{
+	to_lattice_ = basis.inverse();
+	offset_     = -to_lattice_ * position;
+	scale_      = scale;
+
+	// The same barycentric maps as in shaders/fold_frag.glsl.
+	auto maps      = tiling.barycentric_maps();
+	num_triangles_ = std::min<int>(maps.size(), MAX_TRIANGLES);
+
+	for (int t = 0; t < num_triangles_; ++t)
+		std::copy(std::begin(maps[t]), std::end(maps[t]), triangles_[t]);
+
+	// Every group has one of these triangle counts.
+	switch (num_triangles_)
+	{
+	case 2:  kernel_ = &FoldKernel<VectorLanes, 2>::run;  break;
+	case 4:  kernel_ = &FoldKernel<VectorLanes, 4>::run;  break;
+	case 6:  kernel_ = &FoldKernel<VectorLanes, 6>::run;  break;
+	case 8:  kernel_ = &FoldKernel<VectorLanes, 8>::run;  break;
+	case 12: kernel_ = &FoldKernel<VectorLanes, 12>::run; break;
+	case 16: kernel_ = &FoldKernel<VectorLanes, 16>::run; break;
+	case 24: kernel_ = &FoldKernel<VectorLanes, 24>::run; break;
+	default: kernel_ = &FoldKernel<VectorLanes, 0>::run;
+	}
+}
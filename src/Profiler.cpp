@@ -0,0 +1,277 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+// Weight of the newest frame in the smoothed timings.
+#define SMOOTHING 0.1
+
+//--------------------
+
+namespace
+{
+double milliseconds(std::chrono::steady_clock::duration duration)
+{
+	return std::chrono::duration<double, std::milli>(duration).count();
+}
+} // namespace
+
+Profiler::Zone::Zone(const char* name) :
+	trace_  (name),
+	active_ (false)
+{
+	auto& profiler = Profiler::get();
+
+	// Zones outside of a frame aren't part of any pass.
+	active_ = profiler.enabled_ && !profiler.open_.empty();
+	if (active_)
+		profiler.begin(name);
+}
+
+Profiler::Zone::Zone(const char* name, size_t index) :
+	Zone((std::string(name) + " #" + std::to_string(index)).c_str())
+{}
+
+Profiler::Zone::~Zone(void)
+{
+	if (active_)
+		Profiler::get().end();
+}
+
+Profiler& Profiler::get(void)
+{
+	static Profiler profiler;
+	return profiler;
+}
+
+double Profiler::percentile(const std::vector<double>& sorted, double p)
+{
+	auto rank = (size_t)std::ceil(p * sorted.size());
+	return sorted[std::min(std::max(rank, (size_t)1), sorted.size()) - 1];
+}
+
+std::vector<double> Profiler::time_runs(int runs, const std::function<void(void)>& function)
+{
+	std::vector<double> times;
+	for (int i = 0; i < runs; ++i)
+	{
+		auto start = std::chrono::steady_clock::now();
+		function();
+		glFinish();
+		auto end   = std::chrono::steady_clock::now();
+
+		times.push_back(milliseconds(end - start));
+	}
+
+	std::sort(std::begin(times), std::end(times));
+	return times;
+}
+
+Profiler::Profiler(void) :
+	enabled_           (false),
+	enable_next_frame_ (false),
+	frame_             (0),
+	frame_begin_       (0),
+	counters_          (),
+	frame_counters_    (),
+	frame_time_offset_ (0)
+{
+	for (auto& frame : frames_)
+	{
+		frame.num_queries = 0;
+		frame.pending     = false;
+		frame.gpu_offset  = 0;
+	}
+
+	frame_times_.fill(0.0f);
+}
+
+Profiler::~Profiler(void)
+{
+	for (auto& frame : frames_)
+	{
+		if (!frame.queries.empty())
+			glDeleteQueries((GLsizei)frame.queries.size(), frame.queries.data());
+	}
+}
+
+void Profiler::begin_frame(void)
+{
+	frame_counters_ = Counters();
+	frame_begin_    = Trace::now();
+
+	// Results from before disabling would be stale by the time they're shown.
+	if (enabled_ != enable_next_frame_)
+	{
+		for (auto& frame : frames_)
+			frame.pending = false;
+
+		passes_.clear();
+		smoothed_.clear();
+	}
+
+	enabled_ = enable_next_frame_;
+	if (!enabled_)
+		return;
+
+	frame_ = (frame_ + 1) % FRAME_LATENCY;
+	auto& frame = frames_[frame_];
+
+	// Only if the GPU is a whole ring of frames behind.
+	if (frame.pending)
+		resolve(frame);
+
+	frame.samples.clear();
+	frame.num_queries = 0;
+
+	// Both clocks at once, to put the GPU times on the CPU timeline.
+	GLint64 gpu_time;
+	glGetInteger64v(GL_TIMESTAMP, &gpu_time);
+	frame.gpu_offset = Trace::now() - gpu_time;
+
+	begin("Frame");
+}
+
+void Profiler::end_frame(void)
+{
+	counters_ = frame_counters_;
+	Trace::record("Frame", frame_begin_, Trace::now());
+
+	if (!enabled_ || open_.empty())
+		return;
+
+	while (!open_.empty())
+		end();
+
+	auto& frame   = frames_[frame_];
+	frame.pending = true;
+
+	const auto& root = frame.samples.front();
+	frame_times_[frame_time_offset_] = (float)milliseconds(root.cpu_end - root.cpu_begin);
+	frame_time_offset_ = (frame_time_offset_ + 1) % FRAME_HISTORY;
+
+	// Oldest first, so that the smoothing sees the frames in order.
+	for (size_t i = 1; i <= FRAME_LATENCY; ++i)
+	{
+		auto& older = frames_[(frame_ + i) % FRAME_LATENCY];
+		if (!older.pending)
+			continue;
+		if (!available(older))
+			break;
+
+		resolve(older);
+	}
+}
+
+void Profiler::count_draw(GLenum mode, GLsizei vertices, GLsizei instances)
+{
+	size_t triangles = 0;
+	if (mode == GL_TRIANGLES)
+		triangles = vertices / 3;
+	else if ((mode == GL_TRIANGLE_STRIP || mode == GL_TRIANGLE_FAN) && vertices > 2)
+		triangles = vertices - 2;
+
+	frame_counters_.draw_calls += 1;
+	frame_counters_.triangles  += triangles * instances;
+}
+
+void Profiler::count_upload(size_t bytes)
+{
+	frame_counters_.texture_uploads += 1;
+	frame_counters_.upload_bytes    += bytes;
+}
+
+void Profiler::begin(std::string name)
+{
+	auto& frame = frames_[frame_];
+
+	Sample sample;
+	sample.key       = open_.empty() ? name : frame.samples[open_.back()].key + '/' + name;
+	sample.name      = std::move(name);
+	sample.depth     = (int)open_.size();
+	sample.cpu_begin = Clock::now();
+	sample.gpu_begin = timestamp();
+	sample.gpu_end   = sample.gpu_begin;
+
+	open_.push_back(frame.samples.size());
+	frame.samples.push_back(std::move(sample));
+}
+
+void Profiler::end(void)
+{
+	auto& sample = frames_[frame_].samples[open_.back()];
+	open_.pop_back();
+
+	sample.gpu_end = timestamp();
+	sample.cpu_end = Clock::now();
+}
+
+size_t Profiler::timestamp(void)
+{
+	auto& frame = frames_[frame_];
+	if (frame.num_queries == frame.queries.size())
+	{
+		GLuint query;
+		glGenQueries(1, &query);
+		frame.queries.push_back(query);
+	}
+
+	glQueryCounter(frame.queries[frame.num_queries], GL_TIMESTAMP);
+
+	return frame.num_queries++;
+}
+
+// The timestamps are written in order, so the last one is enough.
+bool Profiler::available(const Frame& frame) const
+{
+	GLint available = GL_FALSE;
+	glGetQueryObjectiv(frame.queries[frame.num_queries - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+
+	return available == GL_TRUE;
+}
+
+void Profiler::resolve(Frame& frame)
+{
+	frame.pending = false;
+
+	std::vector<GLuint64> times(frame.num_queries);
+	for (size_t i = 0; i < frame.num_queries; ++i)
+		glGetQueryObjectui64v(frame.queries[i], GL_QUERY_RESULT, &times[i]);
+
+	// Calls of the same pass add up, e.g. when the same layer is drawn twice.
+	std::vector<Pass> passes;
+	std::unordered_map<std::string, size_t> indices;
+	for (const auto& sample : frame.samples)
+	{
+		auto inserted = indices.emplace(sample.key, passes.size());
+		if (inserted.second)
+			passes.push_back({sample.name, sample.depth, 0, 0.0, 0.0});
+
+		auto& pass = passes[inserted.first->second];
+		pass.calls  += 1;
+		pass.cpu_ms += milliseconds(sample.cpu_end - sample.cpu_begin);
+		pass.gpu_ms += (times[sample.gpu_end] - times[sample.gpu_begin]) / 1e6;
+
+		Trace::record_gpu(sample.name.c_str(), (int64_t)times[sample.gpu_begin] + frame.gpu_offset,
+		                  (int64_t)times[sample.gpu_end] + frame.gpu_offset);
+	}
+
+	// Passes that didn't run this frame are dropped.
+	std::unordered_map<std::string, std::pair<double, double>> smoothed;
+	for (const auto& index : indices)
+	{
+		auto& pass     = passes[index.second];
+		auto  previous = smoothed_.find(index.first);
+		if (previous != std::end(smoothed_))
+		{
+			pass.cpu_ms = previous->second.first  + SMOOTHING * (pass.cpu_ms - previous->second.first);
+			pass.gpu_ms = previous->second.second + SMOOTHING * (pass.gpu_ms - previous->second.second);
+		}
+
+		smoothed.emplace(index.first, std::make_pair(pass.cpu_ms, pass.gpu_ms));
+	}
+
+	passes_   = std::move(passes);
+	smoothed_ = std::move(smoothed);
+}
@@ -0,0 +1,292 @@
+#include "ProgramCache.h"
+
+#include "AssetBundle.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+// Within the user's cache directory.
+#define CACHE_DIRECTORY "symmetrifier/shaders"
+#define MANIFEST_FILE   "programs"
+
+//--------------------
+
+namespace
+{
+// 64-bit FNV-1a, continued from the given hash.
+uint64_t hash_bytes(uint64_t hash, const void* data, size_t size)
+{
+	auto bytes = (const unsigned char*)data;
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+
+	return hash;
+}
+
+uint64_t hash_string(uint64_t hash, const std::string& string)
+{
+	// Include the terminator, so that consecutive strings can't run together.
+	return hash_bytes(hash, string.c_str(), string.size() + 1);
+}
+
+std::string read_file(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	return std::string((std::istreambuf_iterator<char>(file)),
+	                   std::istreambuf_iterator<char>());
+}
+
+std::string key(const std::vector<ProgramCache::Stage>& stages)
+{
+	std::string key;
+	for (const auto& stage : stages)
+	{
+		key += std::to_string(stage.type) + '\0' + stage.file + '\0' + stage.definitions + '\0';
+	}
+
+	return key;
+}
+
+// Per user, and independent of the working directory, which may not
+// even be writable. Falls back to the temporary directory.
+fs::path cache_directory(void)
+{
+	static const fs::path directory = [](){
+		fs::path base;
+		if (auto xdg = std::getenv("XDG_CACHE_HOME"))
+			base = xdg;
+		else if (auto local = std::getenv("LOCALAPPDATA"))
+			base = local;
+		else if (auto home = std::getenv("HOME"))
+			base = fs::path(home) / ".cache";
+		else
+		{
+			std::error_code error;
+			base = fs::temp_directory_path(error);
+		}
+
+		return base / CACHE_DIRECTORY;
+	}();
+
+	return directory;
+}
+
+fs::path binary_path(uint64_t hash)
+{
+	char name[21];
+	std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)hash);
+
+	return cache_directory() / name;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+ProgramCache& ProgramCache::get(void)
+{
+	static ProgramCache cache;
+	return cache;
+}
+
+ProgramCache::ProgramCache(void) :
+	binaries_supported_ (GLEW_ARB_get_program_binary),
+	num_loaded_         (0),
+	num_compiled_       (0),
+	load_time_          (0.0),
+	compile_time_       (0.0)
+{
+	// Binaries are only valid for the driver that made them.
+	for (auto name : {GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION})
+	{
+		auto string = glGetString(name);
+		driver_ += string ? (const char*)string : "";
+		driver_ += '\n';
+	}
+
+	// The extension may be there without any formats to use it with.
+	if (binaries_supported_)
+	{
+		GLint num_formats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats);
+		binaries_supported_ = num_formats > 0;
+	}
+
+	// Each stage is "<type> <length of definitions>\n<file>\n<definitions>".
+	std::ifstream manifest(cache_directory() / MANIFEST_FILE, std::ios::binary);
+	size_t num_stages;
+	while (manifest >> num_stages)
+	{
+		std::vector<Stage> stages(num_stages);
+		for (auto& stage : stages)
+		{
+			size_t length;
+			manifest >> stage.type >> length;
+			manifest.ignore(1);
+			std::getline(manifest, stage.file);
+
+			stage.definitions.resize(length);
+			manifest.read(&stage.definitions[0], length);
+		}
+
+		if (!manifest)
+			break;
+
+		recorded_keys_.insert(key(stages));
+		recorded_.push_back(std::move(stages));
+	}
+}
+
+const GL::ShaderProgram& ProgramCache::program(const std::vector<Stage>& stages)
+{
+	auto name     = key(stages);
+	auto existing = programs_.find(name);
+	if (existing != std::end(programs_))
+		return existing->second;
+
+	auto hash = hash_string(14695981039346656037ull, driver_);
+	for (const auto& stage : stages)
+	{
+		hash = hash_bytes(hash, &stage.type, sizeof(stage.type));
+		hash = hash_string(hash, AssetBundle::get().read(stage.file));
+		hash = hash_string(hash, stage.definitions);
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	GL::ShaderProgram program;
+	if (binaries_supported_ && load(program, hash))
+	{
+		load_time_ += seconds_since(start);
+		++num_loaded_;
+	}
+	else
+	{
+		program = compile(stages);
+		if (binaries_supported_)
+			save(program, hash);
+
+		compile_time_ += seconds_since(start);
+		++num_compiled_;
+	}
+
+	remember(stages, name);
+
+	return programs_.emplace(name, std::move(program)).first->second;
+}
+
+void ProgramCache::preload(const std::vector<std::vector<Stage>>& programs)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	// The fixed set first, then whatever earlier runs used beyond it.
+	auto all = programs;
+	all.insert(std::end(all), std::begin(recorded_), std::end(recorded_));
+
+	for (const auto& stages : all)
+	{
+		// The sources may be gone or broken by now. That's reported
+		// when compiling, and again if the program is actually used.
+		try
+		{
+			program(stages);
+		}
+		catch (const std::runtime_error&) {}
+	}
+
+	std::printf("Shader programs ready in %.1f ms: %zu from cache in %.1f ms, %zu compiled in %.1f ms.\n",
+	            1000.0 * seconds_since(start), num_loaded_, 1000.0 * load_time_,
+	            num_compiled_, 1000.0 * compile_time_);
+}
+
+bool ProgramCache::load(const GL::ShaderProgram& program, uint64_t hash)
+{
+	auto binary = read_file(binary_path(hash));
+	if (binary.size() <= sizeof(GLenum))
+		return false;
+
+	GLenum format;
+	std::copy(binary.data(), binary.data() + sizeof(GLenum), (char*)&format);
+
+	glProgramBinary(program, format, binary.data() + sizeof(GLenum), binary.size() - sizeof(GLenum));
+
+	// Drivers reject binaries from their older versions, for instance.
+	GLint link_status;
+	glGetProgramiv(program, GL_LINK_STATUS, &link_status);
+
+	return link_status == GL_TRUE;
+}
+
+void ProgramCache::save(const GL::ShaderProgram& program, uint64_t hash)
+{
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+		return;
+
+	GLenum format;
+	std::string binary(sizeof(GLenum) + length, '\0');
+	glGetProgramBinary(program, length, nullptr, &format, &binary[sizeof(GLenum)]);
+	std::copy((const char*)&format, (const char*)&format + sizeof(GLenum), &binary[0]);
+
+	std::error_code error;
+	fs::create_directories(cache_directory(), error);
+
+	std::ofstream file(binary_path(hash), std::ios::binary);
+	file.write(binary.data(), binary.size());
+}
+
+GL::ShaderProgram ProgramCache::compile(const std::vector<Stage>& stages)
+{
+	GL::ShaderProgram program;
+
+	// Flagged for deletion right away; they go with the program.
+	std::vector<GL::ShaderObject> objects;
+	for (const auto& stage : stages)
+	{
+		objects.push_back(GL::ShaderObject::from_file(stage.type, stage.file.c_str(), stage.definitions));
+		glAttachShader(program, objects.back());
+	}
+
+	if (binaries_supported_)
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+	if (!program.link())
+	{
+		std::fprintf(stderr, "Shader program linking failed. Info log:\n%s", program.get_info_log().c_str());
+		throw std::runtime_error("Shader program linking failed.");
+	}
+
+	return program;
+}
+
+// Appends new programs to the manifest, so that the next run preloads them.
+void ProgramCache::remember(const std::vector<Stage>& stages, const std::string& key)
+{
+	if (!recorded_keys_.insert(key).second)
+		return;
+
+	std::error_code error;
+	fs::create_directories(cache_directory(), error);
+
+	std::ofstream manifest(cache_directory() / MANIFEST_FILE, std::ios::binary | std::ios::app);
+	manifest << stages.size() << '\n';
+	for (const auto& stage : stages)
+	{
+		manifest << stage.type << ' ' << stage.definitions.size() << '\n'
+		         << stage.file << '\n'
+		         << stage.definitions;
+	}
+	manifest << '\n';
+}
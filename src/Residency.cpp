@@ -0,0 +1,40 @@
+#include "Residency.h"
+
+#include "MemoryUsage.h"
+
+Residency::Residency(void) :
+	budget_      (DEFAULT_BUDGET),
+	frame_       (0),
+	idle_frames_ (240)
+{}
+
+Residency& Residency::get(void)
+{
+	static Residency residency;
+	return residency;
+}
+
+size_t Residency::resident_bytes(void) const
+{
+	return MemoryUsage::get().total(MemoryUsage::GPU).bytes;
+}
+
+bool Residency::over_budget(void) const
+{
+	return excess_bytes() > 0;
+}
+
+size_t Residency::excess_bytes(void) const
+{
+	auto resident = resident_bytes();
+
+	if (budget_ == 0 || resident <= budget_)
+		return 0;
+	else
+		return resident - budget_;
+}
+
+bool Residency::is_idle(unsigned last_used_frame) const
+{
+	return frame_ - last_used_frame > idle_frames_;
+}
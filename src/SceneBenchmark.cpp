@@ -0,0 +1,179 @@
+#include "SceneBenchmark.h"
+
+#include "App.h"
+#include "Profiler.h"
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+// Runs of each measurement per scene, after the warm-up frames.
+#define BENCHMARK_WARMUP_FRAMES 5
+#define BENCHMARK_FRAMES        30
+#define BENCHMARK_REBUILDS      5
+#define BENCHMARK_EXPORTS       3
+// The export size, fixed so that runs compare whatever the defaults.
+#define BENCHMARK_EXPORT_WIDTH  1600
+#define BENCHMARK_EXPORT_HEIGHT 1200
+
+//--------------------
+
+namespace
+{
+// Smooth colour waves, different for every seed, in a disc so that
+// overlapping images blend. Rows go from bottom to top.
+std::vector<unsigned char> procedural_pixels(int resolution, unsigned seed)
+{
+	std::vector<unsigned char> pixels(4 * (size_t)resolution * resolution);
+	float phase = 2.1f * seed;
+
+	auto* pixel = pixels.data();
+	for (int y = 0; y < resolution; ++y)
+	{
+		for (int x = 0; x < resolution; ++x, pixel += 4)
+		{
+			float u = (x + 0.5f) / resolution - 0.5f;
+			float v = (y + 0.5f) / resolution - 0.5f;
+			float r = std::hypot(u, v);
+
+			pixel[0] = (unsigned char)(127.5f * (1.0f + std::sin(20.0f * u + phase)));
+			pixel[1] = (unsigned char)(127.5f * (1.0f + std::sin(17.0f * v + 2.0f * phase)));
+			pixel[2] = (unsigned char)(127.5f * (1.0f + std::sin(40.0f * r + 3.0f * phase)));
+			pixel[3] = r < 0.5f ? 255 : 0;
+		}
+	}
+
+	return pixels;
+}
+} // namespace
+
+SceneBenchmark::SceneBenchmark(App& app) :
+	app_ (app)
+{}
+
+// Frame times go through the whole frame, GUI included. Domain texture
+// rebuilds are of every layer at the resolution it's drawn at.
+void SceneBenchmark::run(const std::string& path)
+{
+	FILE* file = std::fopen(path.c_str(), "w");
+	if (!file)
+	{
+		std::fprintf(stderr, "Could not write the benchmark results to %s.\n", path.c_str());
+		return;
+	}
+
+	bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+	if (json)
+		std::fprintf(file, "[");
+	else
+		std::fprintf(file, "axis,layers,images,resolution,group,domains,frame_ms,frame_p90_ms,domain_ms,export_ms\n");
+
+	auto scenes = sweep();
+	for (size_t i = 0; i < scenes.size(); ++i)
+	{
+		const auto& scene = scenes[i];
+		const char* group = Wallpaper::info(scene.group).name;
+
+		build(scene);
+
+		// The first frames build the domain textures and page in the images.
+		for (int j = 0; j < BENCHMARK_WARMUP_FRAMES; ++j)
+			app_.render_frame();
+
+		auto frames   = Profiler::time_runs(BENCHMARK_FRAMES, [this](){ app_.render_frame(); });
+		auto rebuilds = Profiler::time_runs(BENCHMARK_REBUILDS, [this](){ app_.rebuild_domains(); });
+		auto exports  = Profiler::time_runs(BENCHMARK_EXPORTS, [this](){
+			app_.render_export(BENCHMARK_EXPORT_WIDTH, BENCHMARK_EXPORT_HEIGHT);
+		});
+
+		double frame_ms  = Profiler::percentile(frames, 0.5);
+		double frame_p90 = Profiler::percentile(frames, 0.9);
+		double domain_ms = Profiler::percentile(rebuilds, 0.5);
+		double export_ms = Profiler::percentile(exports, 0.5);
+
+		if (json)
+			std::fprintf(file, "%s\n{\"axis\":\"%s\",\"layers\":%d,\"images\":%d,\"resolution\":%d,"
+			             "\"group\":\"%s\",\"domains\":%d,\"frame_ms\":%.3f,\"frame_p90_ms\":%.3f,"
+			             "\"domain_ms\":%.3f,\"export_ms\":%.3f}",
+			             i ? "," : "", scene.axis, scene.layers, scene.images, scene.resolution,
+			             group, scene.domains, frame_ms, frame_p90, domain_ms, export_ms);
+		else
+			std::fprintf(file, "%s,%d,%d,%d,%s,%d,%.3f,%.3f,%.3f,%.3f\n",
+			             scene.axis, scene.layers, scene.images, scene.resolution,
+			             group, scene.domains, frame_ms, frame_p90, domain_ms, export_ms);
+
+		std::printf("%-10s %d layers, %2d images, %4d px, %-5s %2d domains: "
+		            "frame %.2f ms, domains %.2f ms, export %.2f ms\n",
+		            scene.axis, scene.layers, scene.images, scene.resolution,
+		            group, scene.domains, frame_ms, domain_ms, export_ms);
+	}
+
+	if (json)
+		std::fprintf(file, "\n]\n");
+
+	std::fclose(file);
+	std::printf("Wrote the scene benchmark to %s.\n", path.c_str());
+}
+
+std::vector<SceneBenchmark::Scene> SceneBenchmark::sweep(void)
+{
+	const Scene base = {"base", 1, 1, 1024, Wallpaper::Group::P3, 1};
+
+	std::vector<Scene> scenes = {base};
+	for (int layers : {2, 4, 8})
+		scenes.push_back({"layers", layers, base.images, base.resolution, base.group, base.domains});
+	for (int images : {4, 16})
+		scenes.push_back({"images", base.layers, images, base.resolution, base.group, base.domains});
+	for (int resolution : {256, 2048, 4096})
+		scenes.push_back({"resolution", base.layers, base.images, resolution, base.group, base.domains});
+	for (int group = 0; group < Wallpaper::NUM_GROUPS; ++group)
+	{
+		if ((Wallpaper::Group)group != base.group)
+			scenes.push_back({"group", base.layers, base.images, base.resolution, (Wallpaper::Group)group, base.domains});
+	}
+	for (int domains : {4, 9, 25})
+		scenes.push_back({"domains", base.layers, base.images, base.resolution, base.group, domains});
+
+	return scenes;
+}
+
+// The layers and images are spread around the view, each transformed a
+// little differently, but the same way on every run.
+void SceneBenchmark::build(const Scene& scene)
+{
+	auto& layering = app_.layering();
+	layering = Layering();
+
+	std::mt19937 generator(0);
+	std::uniform_real_distribution<float> offset(-0.3f, 0.3f);
+	std::uniform_real_distribution<float> angle(0.0f, 3.14159265f);
+
+	unsigned seed = 0;
+	for (int i = 0; i < scene.layers; ++i)
+	{
+		if (i > 0)
+			layering.add_layer();
+
+		auto& layer = layering.current_layer();
+		layer.set_rotation(angle(generator));
+
+		auto& tiling = layer.tiling();
+		tiling.set_symmetry_group(scene.group);
+		tiling.set_num_lattice_domains(scene.domains);
+		tiling.set_center({0.5f + offset(generator), 0.5f + offset(generator)});
+		tiling.set_scale(1.0f + offset(generator));
+
+		for (int j = 0; j < scene.images; ++j)
+		{
+			auto pixels = procedural_pixels(scene.resolution, seed++);
+			layer.add_image("scene", GL::Texture::from_pixels(pixels.data(), scene.resolution, scene.resolution,
+			                                                  true, MemoryUsage::SOURCE_IMAGE));
+
+			auto& image = layer.current_image();
+			image.set_center({0.5f + offset(generator), 0.5f + offset(generator)});
+			image.set_rotation(angle(generator));
+			image.set_scale(0.5f + offset(generator));
+		}
+	}
+
+	app_.set_view({0.5f, 0.5f}, 300.0);
+}
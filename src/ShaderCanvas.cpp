@@ -16,15 +16,19 @@ ShaderCanvas::ShaderCanvas(void) {
 		Vector2f(0, 0), Vector2f(1, 1), Vector2f(0, 1)
 	};
 
-	glBindVertexArray(vao_);
+	GL::State::bind_vao(vao_);
 
 	glBindBuffer(GL_ARRAY_BUFFER, position_buffer_);
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vector3f), (GLvoid*)0);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+	position_buffer_.set_owner(MemoryUsage::MESH);
+	position_buffer_.set_bytes(sizeof(vertices));
 
 	glBindBuffer(GL_ARRAY_BUFFER, texcoord_buffer_);
 	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vector2f), (GLvoid*)0);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(texcoords), texcoords, GL_STATIC_DRAW);
+	texcoord_buffer_.set_owner(MemoryUsage::MESH);
+	texcoord_buffer_.set_bytes(sizeof(texcoords));
 
 	glEnableVertexAttribArray(0);
 	glEnableVertexAttribArray(2);
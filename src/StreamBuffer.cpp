@@ -0,0 +1,124 @@
+#include "StreamBuffer.h"
+
+#include <algorithm>
+
+// How long to wait for a fence at a time, in nanoseconds.
+#define FENCE_TIMEOUT 1000000u
+// Regions start at multiples of this, so any attribute type is aligned within them.
+#define REGION_ALIGNMENT 16u
+
+//--------------------
+
+namespace
+{
+// Mapped pointers are only guaranteed this alignment, where it can be queried.
+size_t region_alignment(void)
+{
+	static const size_t alignment = [](){
+		GLint map_alignment = 0;
+		if (GLEW_ARB_map_buffer_alignment)
+			glGetIntegerv(GL_MIN_MAP_BUFFER_ALIGNMENT, &map_alignment);
+		return std::max<size_t>(REGION_ALIGNMENT, map_alignment);
+	}();
+
+	return alignment;
+}
+} // namespace
+
+StreamBuffer::StreamBuffer(MemoryUsage::Owner owner, size_t region_size) :
+	buffer_      (owner),
+	region_size_ (0),
+	region_      (0),
+	mapping_     (nullptr),
+	persistent_  (GLEW_ARB_buffer_storage)
+{
+	fences_.fill(nullptr);
+	allocate(region_size);
+}
+
+StreamBuffer::~StreamBuffer(void)
+{
+	for (auto fence : fences_)
+		glDeleteSync(fence);
+}
+
+void* StreamBuffer::begin(size_t size)
+{
+	region_ = (region_ + 1) % NUM_REGIONS;
+
+	if (size > region_size_)
+		allocate(std::max(size, 2 * region_size_));
+
+	wait(region_);
+
+	auto offset = region_ * region_size_;
+	if (persistent_)
+		return mapping_ + offset;
+
+	// The fence already tells us the GPU is done with the region,
+	// so the driver doesn't need to synchronize.
+	glBindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+	return glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, size,
+	                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+}
+
+size_t StreamBuffer::end(void)
+{
+	if (!persistent_)
+	{
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+	}
+
+	return region_ * region_size_;
+}
+
+void StreamBuffer::fence(void)
+{
+	glDeleteSync(fences_[region_]);
+	fences_[region_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+// Replaces the buffer. The driver keeps the old storage alive
+// until the GPU is done with it, so the fences can be dropped.
+void StreamBuffer::allocate(size_t region_size)
+{
+	for (auto& fence : fences_)
+	{
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+
+	auto alignment = region_alignment();
+
+	buffer_      = GL::Buffer(buffer_.owner());
+	region_size_ = (region_size + alignment - 1) / alignment * alignment;
+	region_      = 0;
+
+	glBindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+	if (persistent_)
+	{
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_COPY_WRITE_BUFFER, NUM_REGIONS * region_size_, nullptr, flags);
+		mapping_ = (char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, NUM_REGIONS * region_size_, flags);
+	}
+	else
+		glBufferData(GL_COPY_WRITE_BUFFER, NUM_REGIONS * region_size_, nullptr, GL_STREAM_DRAW);
+
+	buffer_.set_bytes(NUM_REGIONS * region_size_);
+}
+
+void StreamBuffer::wait(size_t region)
+{
+	auto fence = fences_[region];
+	if (!fence)
+		return;
+
+	GLenum status;
+	do
+		status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT);
+	while (status == GL_TIMEOUT_EXPIRED);
+
+	glDeleteSync(fence);
+	fences_[region] = nullptr;
+}
@@ -0,0 +1,301 @@
+#include "TextureCache.h"
+
+#include "LayerImage.h"
+#include "Residency.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// Size limit for the overviews of tiled images.
+#define OVERVIEW_SIZE 2048u
+
+//--------------------
+
+namespace
+{
+// 64-bit FNV-1a.
+uint64_t hash_bytes(const std::vector<unsigned char>& bytes)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (auto byte : bytes)
+	{
+		hash ^= byte;
+		hash *= 1099511628211ull;
+	}
+
+	return hash;
+}
+
+std::vector<unsigned char> read_file(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	return std::vector<unsigned char>((std::istreambuf_iterator<char>(file)),
+	                                  std::istreambuf_iterator<char>());
+}
+
+// Domain textures are often smaller than their sources, so sources
+// are minified through mipmaps.
+GL::Texture decode_source(const std::vector<unsigned char>& bytes, const std::string& path, bool& successful)
+{
+	auto texture = GL::Texture::from_png_memory(bytes.data(), bytes.size(), path.c_str(), successful, true,
+	                                            MemoryUsage::SOURCE_IMAGE);
+	LayerImage::set_sampling_parameters(texture);
+
+	return texture;
+}
+
+// Halves the resolution of a texture by blitting it. The mipmaps are rebuilt.
+GL::Texture downsampled(const GL::Texture& texture)
+{
+	int width  = std::max(1u, texture.width_ / 2);
+	int height = std::max(1u, texture.height_ / 2);
+
+	auto result = GL::Texture::empty_2D_mipmap(width, height, MemoryUsage::SOURCE_IMAGE);
+
+	auto read_fbo = GL::FBO::simple_C0(texture);
+	auto draw_fbo = GL::FBO::simple_C0(result);
+
+	GLuint old_read = GL::State::framebuffer(GL_READ_FRAMEBUFFER);
+	GLuint old_draw = GL::State::framebuffer(GL_DRAW_FRAMEBUFFER);
+
+	GL::State::bind_framebuffer(GL_READ_FRAMEBUFFER, read_fbo);
+	GL::State::bind_framebuffer(GL_DRAW_FRAMEBUFFER, draw_fbo);
+	glBlitFramebuffer(0, 0, texture.width_, texture.height_, 0, 0, width, height,
+	                  GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+	GL::State::bind_framebuffer(GL_READ_FRAMEBUFFER, old_read);
+	GL::State::bind_framebuffer(GL_DRAW_FRAMEBUFFER, old_draw);
+
+	GLuint old_tex = GL::State::texture(GL_TEXTURE_2D);
+	GL::State::bind_texture(GL_TEXTURE_2D, result);
+	glGenerateMipmap(GL_TEXTURE_2D);
+	GL::State::bind_texture(GL_TEXTURE_2D, old_tex);
+
+	return result;
+}
+} // namespace
+
+TextureCache& TextureCache::get(void)
+{
+	static TextureCache cache;
+	return cache;
+}
+
+TextureCache::Handle TextureCache::load_png(const char* filename, bool& successful)
+{
+	std::error_code error;
+	auto mtime = fs::last_write_time(filename, error).time_since_epoch().count();
+	auto size  = error ? 0 : fs::file_size(filename, error);
+
+	if (error)
+	{
+		successful = false;
+		std::fprintf(stderr, "PNG loading failed for %s\nError: %s\n", filename, error.message().c_str());
+		return error_texture();
+	}
+
+	// Fast path: the file is unchanged since we last hashed it.
+	auto stamp = stamps_.find(filename);
+	if (stamp != std::end(stamps_) && stamp->second.mtime == mtime && stamp->second.size == size)
+	{
+		if (auto texture = find(stamp->second.hash))
+		{
+			successful = true;
+			touch(texture);
+			return texture;
+		}
+	}
+
+	auto bytes = read_file(filename);
+	auto hash  = hash_bytes(bytes);
+	stamps_[filename] = {mtime, size, hash};
+
+	// The same content may have been loaded from another path.
+	if (auto texture = find(hash))
+	{
+		successful = true;
+		touch(texture);
+		return texture;
+	}
+
+	std::shared_ptr<TiledImage> tiles;
+	GL::Texture texture;
+	if (TiledImage::needs_tiling(bytes))
+	{
+		tiles = TiledImage::open(bytes, hash, successful);
+		if (successful)
+			texture = tiles->overview(OVERVIEW_SIZE);
+	}
+	else
+		texture = decode_source(bytes, filename, successful);
+
+	if (!successful)
+	{
+		stamps_.erase(filename);
+		return error_texture();
+	}
+
+	prune();
+
+	auto handle = std::make_shared<GL::Texture>(std::move(texture));
+	entries_[hash] = {handle, filename, Residency::get().frame(), false, true, tiles};
+	hashes_[handle.get()] = hash;
+
+	return handle;
+}
+
+TextureCache::Handle TextureCache::load_png(const char* filename)
+{
+	bool unused_status;
+	return load_png(filename, unused_status);
+}
+
+TextureCache::Handle TextureCache::error_texture(void)
+{
+	if (!error_texture_)
+		error_texture_ = std::make_shared<GL::Texture>(GL::Texture::checkerboard(MemoryUsage::SOURCE_IMAGE));
+
+	return error_texture_;
+}
+
+std::shared_ptr<TiledImage> TextureCache::tiles(const Handle& texture) const
+{
+	auto hash = hashes_.find(texture.get());
+	if (hash == std::end(hashes_))
+		return nullptr;
+
+	return entries_.at(hash->second).tiles;
+}
+
+size_t TextureCache::size(void) const
+{
+	size_t alive = 0;
+	for (const auto& entry : entries_)
+		alive += !entry.second.texture.expired();
+
+	return alive;
+}
+
+void TextureCache::touch(const Handle& texture)
+{
+	auto hash = hashes_.find(texture.get());
+	if (hash == std::end(hashes_))
+		return;
+
+	entries_.at(hash->second).last_used = Residency::get().frame();
+}
+
+bool TextureCache::reduced(const Handle& texture) const
+{
+	auto hash = hashes_.find(texture.get());
+	return hash != std::end(hashes_) && entries_.at(hash->second).reduced;
+}
+
+size_t TextureCache::restore_used(void)
+{
+	const auto& residency = Residency::get();
+
+	size_t restored = 0;
+	for (auto& it : entries_)
+	{
+		auto& entry   = it.second;
+		auto  texture = entry.texture.lock();
+
+		// Reduced textures were idle, so any use since shows up here.
+		if (!texture || !entry.reduced || !entry.restorable || residency.is_idle(entry.last_used))
+			continue;
+
+		// Other images share the texture by content, so only the same content may come back.
+		auto bytes = read_file(entry.path);
+		bool successful = !bytes.empty() && hash_bytes(bytes) == it.first;
+
+		GL::Texture full;
+		if (successful)
+			full = decode_source(bytes, entry.path, successful);
+
+		if (!successful)
+		{
+			std::fprintf(stderr, "%s has changed or is gone, keeping its downsampled texture.\n",
+			             entry.path.c_str());
+			entry.restorable = false;
+			continue;
+		}
+
+		// In place, so every holder of the handle sees the full texture.
+		*texture      = std::move(full);
+		entry.reduced = false;
+		++restored;
+	}
+
+	return restored;
+}
+
+size_t TextureCache::reduce_idle(size_t bytes)
+{
+	const auto& residency = Residency::get();
+
+	std::vector<Entry*> candidates;
+	for (auto& entry : entries_)
+	{
+		// Tiled images are only resident as a small overview anyway.
+		if (!entry.second.texture.expired() && !entry.second.reduced &&
+		    !entry.second.tiles && residency.is_idle(entry.second.last_used))
+		{
+			candidates.push_back(&entry.second);
+		}
+	}
+
+	auto least_recent = [](const Entry* a, const Entry* b){ return a->last_used < b->last_used; };
+	std::sort(std::begin(candidates), std::end(candidates), least_recent);
+
+	size_t released = 0;
+	for (auto entry : candidates)
+	{
+		if (released >= bytes)
+			break;
+
+		auto texture = entry->texture.lock();
+		auto before  = texture->bytes();
+
+		// The images keep the source dimensions, so proportions and the
+		// domain texture size don't change under the user.
+		*texture = downsampled(*texture);
+		LayerImage::set_sampling_parameters(*texture);
+
+		entry->reduced = true;
+		released      += before - texture->bytes();
+	}
+
+	return released;
+}
+
+TextureCache::Handle TextureCache::find(uint64_t hash) const
+{
+	auto it = entries_.find(hash);
+	if (it == std::end(entries_))
+		return nullptr;
+
+	return it->second.texture.lock();
+}
+
+// Forgets textures nobody uses anymore.
+void TextureCache::prune(void)
+{
+	for (auto it = std::begin(hashes_); it != std::end(hashes_);)
+	{
+		auto entry = entries_.find(it->second);
+		if (entry == std::end(entries_) || entry->second.texture.expired())
+		{
+			if (entry != std::end(entries_))
+				entries_.erase(entry);
+			it = hashes_.erase(it);
+		}
+		else
+			++it;
+	}
+}
@@ -0,0 +1,379 @@
+#include "TiledImage.h"
+
+#include "LayerImage.h"
+#include "Profiler.h"
+#include "stb_image.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+#define TILE_SIZE 256u
+#define TILING_THRESHOLD 8192u
+#define CACHE_MAGIC "SYMTILE1"
+// Enough for every view of the image to keep its own window.
+#define MAX_WINDOWS 4u
+
+//--------------------
+
+namespace
+{
+struct FileHeader
+{
+	char     magic[8];
+	uint32_t width;
+	uint32_t height;
+	uint32_t tile_size;
+	uint32_t num_levels;
+};
+
+unsigned max_texture_size(void)
+{
+	static const unsigned size = [](){
+		GLint s; glGetIntegerv(GL_MAX_TEXTURE_SIZE, &s);
+		return (unsigned)s;
+	}();
+
+	return size;
+}
+
+// Writes the image as zero-padded tiles, row by row from the bottom.
+void write_tiles(std::ofstream& file, const unsigned char* pixels, unsigned width, unsigned height)
+{
+	std::vector<unsigned char> tile(4 * TILE_SIZE * TILE_SIZE);
+
+	for (unsigned y = 0; y < height; y += TILE_SIZE)
+	{
+		for (unsigned x = 0; x < width; x += TILE_SIZE)
+		{
+			std::fill(std::begin(tile), std::end(tile), 0);
+
+			unsigned rows    = std::min(TILE_SIZE, height - y);
+			unsigned columns = std::min(TILE_SIZE, width - x);
+			for (unsigned r = 0; r < rows; ++r)
+			{
+				std::memcpy(&tile[4 * r * TILE_SIZE],
+				            &pixels[4 * ((size_t)(y + r) * width + x)],
+				            4 * columns);
+			}
+
+			file.write((const char*)tile.data(), tile.size());
+		}
+	}
+}
+
+// 2x2 box filter. Odd edges repeat their last texel.
+std::vector<unsigned char> downsampled(const unsigned char* pixels, unsigned width, unsigned height)
+{
+	unsigned new_width  = std::max(1u, width / 2);
+	unsigned new_height = std::max(1u, height / 2);
+
+	std::vector<unsigned char> result(4 * (size_t)new_width * new_height);
+	for (unsigned y = 0; y < new_height; ++y)
+	{
+		unsigned y0 = std::min(2 * y, height - 1), y1 = std::min(2 * y + 1, height - 1);
+		for (unsigned x = 0; x < new_width; ++x)
+		{
+			unsigned x0 = std::min(2 * x, width - 1), x1 = std::min(2 * x + 1, width - 1);
+			for (unsigned c = 0; c < 4; ++c)
+			{
+				unsigned sum = pixels[4 * ((size_t)y0 * width + x0) + c] +
+				               pixels[4 * ((size_t)y0 * width + x1) + c] +
+				               pixels[4 * ((size_t)y1 * width + x0) + c] +
+				               pixels[4 * ((size_t)y1 * width + x1) + c];
+				result[4 * ((size_t)y * new_width + x) + c] = (sum + 2) / 4;
+			}
+		}
+	}
+
+	return result;
+}
+
+// Decodes the PNG once and writes all of its levels to the cache file.
+bool build_cache(const std::vector<unsigned char>& png, const fs::path& path)
+{
+	int width, height, channels;
+	unsigned char* decoded = stbi_load_from_memory(png.data(), (int)png.size(),
+	                                               &width, &height, &channels, 4);
+	if (decoded == NULL)
+	{
+		std::fprintf(stderr, "Tile cache building failed for %s\nError: %s\n",
+		             path.string().c_str(), stbi_failure_reason());
+		return false;
+	}
+
+	// Flip the rows in place for OpenGL, like for regular textures.
+	size_t stride = 4 * (size_t)width;
+	for (int i = 0; i < height / 2; ++i)
+	{
+		std::swap_ranges(decoded + stride * i, decoded + stride * (i + 1),
+		                 decoded + stride * (height - (1 + i)));
+	}
+
+	// Levels go down until a single tile covers the image.
+	FileHeader header;
+	std::memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+	header.width      = width;
+	header.height     = height;
+	header.tile_size  = TILE_SIZE;
+	header.num_levels = 0;
+
+	std::vector<uint32_t> widths, heights;
+	for (unsigned w = width, h = height;; w = std::max(1u, w / 2), h = std::max(1u, h / 2))
+	{
+		widths.push_back(w);
+		heights.push_back(h);
+		++header.num_levels;
+
+		if (w <= TILE_SIZE && h <= TILE_SIZE)
+			break;
+	}
+
+	std::vector<uint64_t> level_table;
+	uint64_t offset = sizeof(FileHeader) + header.num_levels * 3 * sizeof(uint64_t);
+	for (unsigned i = 0; i < header.num_levels; ++i)
+	{
+		uint32_t tiles_x = (widths[i] + TILE_SIZE - 1) / TILE_SIZE;
+		uint32_t tiles_y = (heights[i] + TILE_SIZE - 1) / TILE_SIZE;
+
+		level_table.push_back(widths[i] | (uint64_t)heights[i] << 32);
+		level_table.push_back(tiles_x | (uint64_t)tiles_y << 32);
+		level_table.push_back(offset);
+
+		offset += (uint64_t)tiles_x * tiles_y * 4 * TILE_SIZE * TILE_SIZE;
+	}
+
+	// Write to a temporary file first, so that an interrupted build
+	// never leaves a truncated cache behind.
+	auto temporary = path;
+	temporary += ".tmp";
+
+	std::ofstream file(temporary, std::ios::binary);
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)level_table.data(), level_table.size() * sizeof(uint64_t));
+
+	write_tiles(file, decoded, width, height);
+	std::vector<unsigned char> level;
+	for (unsigned i = 1; i < header.num_levels; ++i)
+	{
+		level = downsampled(i == 1 ? decoded : level.data(), widths[i - 1], heights[i - 1]);
+		write_tiles(file, level.data(), widths[i], heights[i]);
+	}
+	stbi_image_free(decoded);
+
+	file.close();
+	if (!file)
+		return false;
+
+	std::error_code error;
+	fs::rename(temporary, path, error);
+
+	return !error;
+}
+} // namespace
+
+TiledImage::TiledImage(MappedFile&& file) :
+	file_         (std::move(file)),
+	width_        (0),
+	height_       (0),
+	tile_size_    (0),
+	windows_      (MAX_WINDOWS),
+	window_clock_ (0)
+{
+	for (auto& cached : windows_)
+	{
+		cached.level     = 0;
+		std::fill(cached.rect, cached.rect + 4, 0u);
+		cached.last_used = 0;
+	}
+
+	FileHeader header;
+	if (file_.size() < sizeof(header))
+		return;
+
+	std::memcpy(&header, file_.data(), sizeof(header));
+	if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) != 0 || header.num_levels == 0)
+		return;
+
+	size_t table_size = header.num_levels * 3 * sizeof(uint64_t);
+	if (file_.size() < sizeof(header) + table_size)
+		return;
+
+	std::vector<uint64_t> level_table(header.num_levels * 3);
+	std::memcpy(level_table.data(), file_.data() + sizeof(header), table_size);
+
+	std::vector<Level> levels;
+	for (unsigned i = 0; i < header.num_levels; ++i)
+	{
+		Level level;
+		level.width   = level_table[3 * i]     & 0xFFFFFFFF;
+		level.height  = level_table[3 * i]     >> 32;
+		level.tiles_x = level_table[3 * i + 1] & 0xFFFFFFFF;
+		level.tiles_y = level_table[3 * i + 1] >> 32;
+		level.offset  = level_table[3 * i + 2];
+
+		uint64_t level_size = (uint64_t)level.tiles_x * level.tiles_y * 4 * header.tile_size * header.tile_size;
+		if (level.offset + level_size > file_.size())
+			return;
+
+		levels.push_back(level);
+	}
+
+	width_     = header.width;
+	height_    = header.height;
+	tile_size_ = header.tile_size;
+	levels_    = std::move(levels);
+}
+
+bool TiledImage::needs_tiling(const std::vector<unsigned char>& png)
+{
+	int width, height, channels;
+	if (!stbi_info_from_memory(png.data(), (int)png.size(), &width, &height, &channels))
+		return false;
+
+	auto limit = std::min(TILING_THRESHOLD, max_texture_size());
+	return (unsigned)std::max(width, height) > limit;
+}
+
+std::shared_ptr<TiledImage> TiledImage::open(const std::vector<unsigned char>& png,
+                                             uint64_t hash, bool& successful)
+{
+	std::error_code error;
+	auto directory = fs::temp_directory_path(error) / "symmetrifier";
+	fs::create_directories(directory, error);
+
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016" PRIx64 ".tiles", hash);
+	auto path = directory / name;
+
+	std::shared_ptr<TiledImage> image(new TiledImage(MappedFile(path.string(), MemoryUsage::SOURCE_IMAGE)));
+	if (!image->valid())
+	{
+		std::printf("Building tile cache %s...\n", path.string().c_str());
+		if (build_cache(png, path))
+			image.reset(new TiledImage(MappedFile(path.string(), MemoryUsage::SOURCE_IMAGE)));
+	}
+
+	successful = image->valid();
+	return image;
+}
+
+GL::Texture TiledImage::overview(unsigned max_size) const
+{
+	unsigned level = 0;
+	while (level + 1 < levels_.size() &&
+	       std::max(levels_[level].width, levels_[level].height) > max_size)
+	{
+		++level;
+	}
+
+	auto texture = upload(level, 0, 0, levels_[level].width, levels_[level].height);
+
+	// Image proportions are derived from these.
+	texture.width_  = width_;
+	texture.height_ = height_;
+
+	return texture;
+}
+
+TiledImage::Window TiledImage::window(const Eigen::Vector2f& min, const Eigen::Vector2f& max,
+                                      float texels_across)
+{
+	Eigen::Vector2f lo = min.cwiseMax(0.0f).cwiseMin(1.0f);
+	Eigen::Vector2f hi = max.cwiseMax(lo).cwiseMin(1.0f);
+
+	unsigned level = 0;
+	while (level + 1 < levels_.size() && levels_[level + 1].width >= texels_across)
+		++level;
+
+	// Find the tile-aligned texel rectangle. Go coarser if it doesn't fit in a texture.
+	unsigned rect[4];
+	for (;; ++level)
+	{
+		const auto& l = levels_[level];
+
+		rect[0] = std::min(l.width  - 1, (unsigned)(lo.x() * l.width))  / tile_size_ * tile_size_;
+		rect[1] = std::min(l.height - 1, (unsigned)(lo.y() * l.height)) / tile_size_ * tile_size_;
+		rect[2] = (unsigned)std::ceil(hi.x() * l.width  / tile_size_) * tile_size_;
+		rect[3] = (unsigned)std::ceil(hi.y() * l.height / tile_size_) * tile_size_;
+		rect[2] = std::min(l.width,  std::max(rect[2], rect[0] + 1));
+		rect[3] = std::min(l.height, std::max(rect[3], rect[1] + 1));
+
+		bool fits = rect[2] - rect[0] <= max_texture_size() &&
+		            rect[3] - rect[1] <= max_texture_size();
+		if (fits || level + 1 == levels_.size())
+			break;
+	}
+
+	// Reuse a window that covers the rectangle, or replace the least recently used one.
+	CachedWindow* window = nullptr;
+	for (auto& cached : windows_)
+	{
+		bool covered = cached.texture && cached.level == level &&
+		               cached.rect[0] <= rect[0] && cached.rect[1] <= rect[1] &&
+		               cached.rect[2] >= rect[2] && cached.rect[3] >= rect[3];
+		if (covered)
+		{
+			window = &cached;
+			break;
+		}
+	}
+
+	if (!window)
+	{
+		window = &*std::min_element(std::begin(windows_), std::end(windows_),
+			[](const CachedWindow& a, const CachedWindow& b) { return a.last_used < b.last_used; });
+
+		// Views still holding the old texture keep it.
+		window->texture = std::make_shared<GL::Texture>(upload(level, rect[0], rect[1], rect[2], rect[3]));
+		window->level   = level;
+		std::copy(rect, rect + 4, window->rect);
+	}
+	window->last_used = ++window_clock_;
+
+	const auto& l = levels_[window->level];
+	return {window->texture,
+	        {window->rect[0] / (float)l.width, window->rect[1] / (float)l.height},
+	        {window->rect[2] / (float)l.width, window->rect[3] / (float)l.height}};
+}
+
+const unsigned char* TiledImage::tile(unsigned level, unsigned x, unsigned y) const
+{
+	const auto& l = levels_[level];
+	return file_.data() + l.offset + ((size_t)y * l.tiles_x + x) * 4 * tile_size_ * tile_size_;
+}
+
+// Uploads a texel rectangle of a level. x0 and y0 must be tile-aligned.
+GL::Texture TiledImage::upload(unsigned level, unsigned x0, unsigned y0,
+                                               unsigned x1, unsigned y1) const
+{
+	auto texture = GL::Texture::empty_2D(x1 - x0, y1 - y0, MemoryUsage::SOURCE_IMAGE);
+
+	GLuint old_tex = GL::State::texture(GL_TEXTURE_2D);
+	GL::State::bind_texture(GL_TEXTURE_2D, texture);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, tile_size_);
+
+	// Touching the mapped tiles here is what pages them in.
+	for (unsigned y = y0; y < y1; y += tile_size_)
+	{
+		for (unsigned x = x0; x < x1; x += tile_size_)
+		{
+			glTexSubImage2D(GL_TEXTURE_2D, 0, x - x0, y - y0,
+			                std::min(tile_size_, x1 - x), std::min(tile_size_, y1 - y),
+			                GL_RGBA, GL_UNSIGNED_BYTE, tile(level, x / tile_size_, y / tile_size_));
+		}
+	}
+
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	GL::State::bind_texture(GL_TEXTURE_2D, old_tex);
+	Profiler::get().count_upload(4 * (size_t)(x1 - x0) * (y1 - y0));
+
+	LayerImage::set_sampling_parameters(texture);
+
+	return texture;
+}
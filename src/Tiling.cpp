@@ -1,25 +1,23 @@
 #include "Tiling.h"
 
-#include "GLFunctions.h"
-#include <cstring>
+#include "Trace.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstdio>
 
 Tiling::Tiling(void) :
-	num_lattice_domains_ (1),
+	lattice_side_        (1),
 
 	position_            (0.0f, 0.0f),
-	t1_                  (1.0f, 0.0f),
-
-	line_color_          (1.0, 0.6, 0.1),
-	mirror_color_        (0.1, 0.6, 1.0),
-	rotation_color_      (0.1, 1.0, 0.6)
+	t1_                  (1.0f, 0.0f)
 {
-	set_symmetry_group("o");
+	set_symmetry_group(Wallpaper::Group::P1);
 }
 
 Eigen::Vector2f Tiling::center(void) const
 {
-	if (num_lattice_domains_ % 2)
+	if (lattice_side_ % 2)
 		return position_ + (t1_ + t2()) / 2.0f;
 	else
 		return position_;
@@ -31,136 +29,72 @@ Eigen::Vector2f Tiling::t2(void) const
 	return t1_ * t2_relative_.x() + orthogonal * t2_relative_.y();
 }
 
+Eigen::AlignedBox2f Tiling::lattice_offsets(void) const
+{
+	Eigen::Vector2f min = Eigen::Vector2f::Constant(-(lattice_side_ / 2));
+	return {min, min + Eigen::Vector2f::Constant(lattice_side_ - 1)};
+}
+
 double Tiling::rotation(void) const
 {
 	return std::atan2(t1_.y(), t1_.x());
 }
 
-void Tiling::set_symmetry_group(const char* group)
+std::vector<std::array<float, 6>> Tiling::barycentric_maps(void) const
 {
-	if (!strncmp(group, "o", 8))
-	{
-		symmetry_group_ = "o";
-		lattice_        = Lattice::Oblique;
-		construct_p1();
-	}
-	else if (!strncmp(group, "**", 8))
-	{
-		symmetry_group_ = "**";
-		lattice_        = Lattice::Rectangular;
-		construct_pm();
-	}
-	else if (!strncmp(group, "*x", 8))
-	{
-		symmetry_group_ = "*x";
-		lattice_        = Lattice::Rhombic;
-		construct_cm();
-	}
-	else if (!strncmp(group, "xx", 8))
-	{
-		symmetry_group_ = "xx";
-		lattice_        = Lattice::Rectangular;
-		construct_pg();
-	}
-	else if (!strncmp(group, "2222", 8))
-	{
-		symmetry_group_ = "2222";
-		lattice_        = Lattice::Oblique;
-		construct_p2();
-	}
-	else if (!strncmp(group, "*2222", 8))
-	{
-		symmetry_group_ = "*2222";
-		lattice_        = Lattice::Rectangular;
-		construct_pmm();
-	}
-	else if (!strncmp(group, "22*", 8))
-	{
-		symmetry_group_ = "22*";
-		lattice_        = Lattice::Rectangular;
-		construct_pmg();
-	}
-	else if (!strncmp(group, "2*22", 8))
-	{
-		symmetry_group_ = "2*22";
-		lattice_        = Lattice::Rhombic;
-		construct_cmm();
-	}
-	else if (!strncmp(group, "22x", 8))
-	{
-		symmetry_group_ = "22x";
-		lattice_        = Lattice::Rectangular;
-		construct_pgg();
-	}
-	else if (!strncmp(group, "333", 8))
-	{
-		symmetry_group_ = "333";
-		lattice_        = Lattice::Hexagonal;
-		construct_p3();
-	}
-	else if (!strncmp(group, "*333", 8))
-	{
-		symmetry_group_ = "*333";
-		lattice_        = Lattice::Hexagonal;
-		construct_p3m1();
-	}
-	else if (!strncmp(group, "3*3", 8))
-	{
-		symmetry_group_ = "3*3";
-		lattice_        = Lattice::Hexagonal;
-		construct_p31m();
-	}
-	else if (!strncmp(group, "442", 8))
-	{
-		symmetry_group_ = "442";
-		lattice_        = Lattice::Square;
-		construct_p4();
-	}
-	else if (!strncmp(group, "*442", 8))
-	{
-		symmetry_group_ = "*442";
-		lattice_        = Lattice::Square;
-		construct_p4m();
-	}
-	else if (!strncmp(group, "4*2", 8))
-	{
-		symmetry_group_ = "4*2";
-		lattice_        = Lattice::Square;
-		construct_p4g();
-	}
-	else if (!strncmp(group, "632", 8))
-	{
-		symmetry_group_ = "632";
-		lattice_        = Lattice::Hexagonal;
-		construct_p6();
-	}
-	else if (!strncmp(group, "*632", 8))
+	const auto& info = Wallpaper::info(group_);
+	auto vertex = [&info](int i){ return Eigen::Vector2f(info.triangles[i].x, info.triangles[i].y); };
+
+	std::vector<std::array<float, 6>> maps;
+	for (int i = 0; i + 2 < info.num_vertices; i += 3)
 	{
-		symmetry_group_ = "*632";
-		lattice_        = Lattice::Hexagonal;
-		construct_p6m();
+		Eigen::Vector2f origin = vertex(i);
+		Eigen::Matrix2f edges;
+		edges << vertex(i+1) - origin, vertex(i+2) - origin;
+
+		Eigen::Matrix2f to_barycentric = edges.inverse();
+		Eigen::Vector2f offset         = -to_barycentric * origin;
+
+		maps.push_back({to_barycentric(0, 0), to_barycentric(1, 0),
+		                to_barycentric(0, 1), to_barycentric(1, 1),
+		                offset.x(),           offset.y()});
 	}
-	else
+
+	return maps;
+}
+
+void Tiling::set_symmetry_group(const char* name)
+{
+	Wallpaper::Group group;
+	if (!Wallpaper::find(name, group))
 	{
 		printf("Unsupported group. Falling back to pure translational symmetry.\n");
-		symmetry_group_ = "o";
-		lattice_        = Lattice::Oblique;
-		construct_p1();
+		group = Wallpaper::Group::P1;
 	}
 
-	update_total_mesh();
+	set_symmetry_group(group);
+}
+
+// TODO: Preserve custom lattice transformations?
+void Tiling::set_symmetry_group(Wallpaper::Group group)
+{
+	Trace::Zone zone("set_symmetry_group");
+
+	const auto& info = Wallpaper::info(group);
+
+	group_       = group;
+	t2_relative_ = {info.t2_relative.x, info.t2_relative.y};
 }
 
 void Tiling::set_num_lattice_domains(int n)
 {
-	num_lattice_domains_ = n;
-	update_total_mesh();
+	lattice_side_ = std::max(1, (int)std::sqrt(n));
 }
 
 void Tiling::set_center(const Eigen::Vector2f& center)
 {
 	position_ = center;
-	if (num_lattice_domains_ % 2)
+	if (lattice_side_ % 2)
 		position_ -= (t1_ + t2()) / 2.0f;
 }
 
@@ -180,7 +114,7 @@ void Tiling::set_t1(const Eigen::Vector2f& t1)
 void Tiling::set_t2(const Eigen::Vector2f& t2)
 {
 	// Early out if lattice is square or hexagonal and thus fixed.
-	if (lattice_ == Lattice::Square || lattice_ == Lattice::Hexagonal)
+	if (lattice() == Lattice::Square || lattice() == Lattice::Hexagonal)
 		return;
 
 	// Convert t2 to relative coordinates.
@@ -192,13 +126,13 @@ void Tiling::set_t2(const Eigen::Vector2f& t2)
 	Eigen::Vector2f t2_relative = basis.inverse() * t2;
 
 	// Fulfill lattice constraints as well as possible.
-	if (lattice_ == Lattice::Oblique)
+	if (lattice() == Lattice::Oblique)
 		// No constraints.
 		t2_relative_ = t2_relative;
-	else if (lattice_ == Lattice::Rhombic)
+	else if (lattice() == Lattice::Rhombic)
 		// Must be of same length as t1.
 		t2_relative_ = t2_relative.normalized();
-	else if (lattice_ == Lattice::Rectangular)
+	else if (lattice() == Lattice::Rectangular)
 		// Must be orthogonal to t1.
 		t2_relative_ = {0.0f, t2_relative.y()};
 }
@@ -245,7 +179,7 @@ void Tiling::set_deform_origin(const Eigen::Vector2f& deform_origin)
 	deform_original_t1_ = t1_;
 	deform_original_t2_ = t2();
 
-	if (lattice_ == Lattice::Rectangular || lattice_ == Lattice::Rhombic)
+	if (lattice() == Lattice::Rectangular || lattice() == Lattice::Rhombic)
 	{
 		Eigen::Matrix2f basis;
 		basis << t1_.normalized(), t2().normalized();
@@ -263,10 +197,10 @@ void Tiling::deform(const Eigen::Vector2f& deformation)
 {
 	auto center = this->center();
 
-	float adj_factor = 2.0f / std::sqrt(num_lattice_domains_);
+	float adj_factor = 2.0f / lattice_side_;
 	Eigen::Vector2f adj_deformation = adj_factor * deformation;
 
-	if (lattice_ == Lattice::Rhombic)
+	if (lattice() == Lattice::Rhombic)
 	{
 		Eigen::Vector2f orthogonal = { -deform_corner_.y(), deform_corner_.x() };
 		Eigen::Matrix2f basis;
@@ -287,7 +221,7 @@ void Tiling::deform(const Eigen::Vector2f& deformation)
 		t1_        = basis * t1_relative * deform_quadrant_.x();
 		this->set_t2(basis * t2_relative * deform_quadrant_.y());
 	}
-	else if (lattice_ == Lattice::Rectangular)
+	else if (lattice() == Lattice::Rectangular)
 	{
 		Eigen::Matrix2f basis;
 		basis << deform_original_t1_.normalized(),
@@ -302,742 +236,3 @@ void Tiling::deform(const Eigen::Vector2f& deformation)
 
 	this->set_center(center);
 }
-
-// TODO: Preserve custom lattice transformations?
-void Tiling::construct_p1(void)
-{
-	// Square lattice.
-	t2_relative_ = {0, 1};
-
-	mesh_.positions_ = {
-		{0, 0, 0}, {1, 0, 0}, {1, 1, 0},
-		{1, 1, 0}, {0, 1, 0}, {0, 0, 0}
-	};
-	mesh_.update_buffers();
-
-	frame_mesh_.positions_ = {
-		{0, 0, 0}, {1, 0, 0},
-		{0, 1, 0}, {1, 1, 0},
-		{0, 0, 0}, {0, 1, 0},
-		{1, 0, 0}, {1, 1, 0},
-	};
-
-	// We'll use normals as colors.
-	frame_mesh_.normals_ = std::vector<Eigen::Vector3f>(8, line_color_);
-	frame_mesh_.update_buffers();
-}
-
-void Tiling::construct_pm(void)
-{
-	// Square lattice.
-	t2_relative_ = {0, 1};
-
-	mesh_.positions_ = {
-		// Left half.
-		{0, 0, 0},   {0.5, 0, 0}, {0.5, 1, 0},
-		{0.5, 1, 0}, {0, 1, 0},   {0, 0, 0},
-		// Right half, mirrored.
-		{1, 0, 0},   {0.5, 0, 0}, {0.5, 1, 0},
-		{0.5, 1, 0}, {1, 1, 0},   {1, 0, 0}
-	};
-	mesh_.update_buffers();
-
-	frame_mesh_.positions_ = {
-		{0, 0, 0}, {1, 0, 0},
-		{0, 1, 0}, {1, 1, 0},
-		{0, 0, 0}, {0, 1, 0},
-		{1, 0, 0}, {1, 1, 0},
-
-		{0.5, 0, 0}, {0.5, 1, 0},
-	};
-
-	frame_mesh_.normals_ = {
-		line_color_, line_color_,
-		line_color_, line_color_,
-		mirror_color_, mirror_color_,
-		mirror_color_, mirror_color_,
-
-		mirror_color_, mirror_color_
-	};
-
-	frame_mesh_.update_buffers();
-}
-
-void Tiling::construct_cm(void)
-{
-	// Square lattice.
-	t2_relative_ = {0, 1};
-
-	mesh_.positions_ = {
-		// Bottom right.
-		{1, 1, 0}, {0.5, 0.5, 0}, {1, 0, 0},
-		{1, 0, 0}, {0.5, 0.5, 0}, {0, 0, 0},
-		// Top left, mirrored.
-		{1, 1, 0}, {0.5, 0.5, 0}, {0, 1, 0},
-		{0, 1, 0}, {0.5, 0.5, 0}, {0, 0, 0}
-	};
-	mesh_.update_buffers();
-
-	frame_mesh_.positions_ = {
-		{0, 0, 0}, {1, 0, 0},
-		{0, 1, 0}, {1, 1, 0},
-		{0, 0, 0}, {0, 1, 0},
-		{1, 0, 0}, {1, 1, 0},
-
-		{0, 0, 0}, {1, 1, 0}
-	};
-
-	frame_mesh_.normals_ = {
-		line_color_, line_color_,
-		line_color_, line_color_,
-		line_color_, line_color_,
-		line_color_, line_color_,
-
-		mirror_color_, mirror_color_
-	};
-
-	frame_mesh_.update_buffers();
-}
-
-void Tiling::construct_pg(void)
-{
-	// Square lattice.
-	t2_relative_ = {0, 1};
-
-	mesh_.positions_ = {
-		// Left half.
-		{0, 0, 0},   {0.5, 0, 0}, {0.5, 1, 0},
-		{0.5, 1, 0}, {0, 1, 0},   {0, 0, 0},
-		// Right half, mirrored.
-		{0.5, 1, 0}, {1, 1, 0},   {1, 0, 0},
-		{1, 0, 0},   {0.5, 0, 0}, {0.5, 1, 0}
-	};
-	mesh_.update_buffers();
-
-	frame_mesh_.positions_ = {
-		{0, 0, 0}, {1, 0, 0},
-		{0, 1, 0}, {1, 1, 0},
-		{0, 0, 0}, {0, 1, 0},
-		{1, 0, 0}, {1, 1, 0},
-
-		{0.5, 0, 0}, {0.5, 1, 0},
-	};
-
-	frame_mesh_.normals_ = std::vector<Eigen::Vector3f>(10, line_color_);
-	frame_mesh_.update_buffers();
-}
-
-void Tiling::construct_p2(void)
-{
-	// Square lattice.
-	t2_relative_ = {0, 1};
-
-	mesh_.positions_ = {
-		// Lower right-hand triangle, divided in half.
-		{1, 0, 0}, {0.5, 0.5, 0}, {0, 0, 0},
-		{1, 1, 0}, {0.5, 0.5, 0}, {1, 0, 0},
-		// Upper left-hand triangle.
-		{0, 1, 0}, {0.5, 0.5, 0}, {1, 1, 0},
-		{0, 0, 0}, {0.5, 0.5, 0}, {0, 1, 0}
-	};
-	mesh_.update_buffers();
-
-	frame_mesh_.positions_  = {
-		{0, 0, 0}, {1, 0, 0},
-		{0, 1, 0}, {1, 1, 0},
-		{0, 0, 0}, {0, 1, 0},
-		{1, 0, 0}, {1, 1, 0},
-
-		{0, 0, 0}, {1, 1, 0}
-	};
-
-	frame_mesh_.normals_ = std::vector<Eigen::Vector3f>(10, rotation_color_);
-	frame_mesh_.update_buffers();
-}
-
-void Tiling::construct_pmm(void)
-{
-	// Square lattice.
-	t2_relative_ = {0, 1};
-
-	mesh_.positions_ = {
-		// Bottom left.
-		{0, 0, 0},     {0.5, 0, 0}, {0.5, 0.5, 0},
-		{0.5, 0.5, 0}, {0, 0.5, 0}, {0, 0, 0},
-		// Top left, mirrored.
-		{0, 1, 0},     {0.5, 1, 0}, {0.5, 0.5, 0},
-		{0.5, 0.5, 0}, {0, 0.5, 0}, {0, 1, 0},
-		// Top right.
-		{1, 1, 0},     {0.5, 1, 0}, {0.5, 0.5, 0},
-		{0.5, 0.5, 0}, {1, 0.5, 0}, {1, 1, 0},
-		// Bottom right, mirrored.
-		{1, 0, 0},     {0.5, 0, 0}, {0.5, 0.5, 0},
-		{0.5, 0.5, 0}, {1, 0.5, 0}, {1, 0, 0}
-	};
-	mesh_.update_buffers();
-
-	frame_mesh_.positions_ = {
-		{0, 0, 0}, {1, 0, 0},
-		{0, 1, 0}, {1, 1, 0},
-		{0, 0, 0}, {0, 1, 0},
-		{1, 0, 0}, {1, 1, 0},
-
-		{0, 0.5, 0}, {1, 0.5, 0},
-		{0.5, 0, 0}, {0.5, 1, 0}
-	};
-
-	frame_mesh_.normals_ = std::vector<Eigen::Vector3f>(12, mirror_color_);
-	frame_mesh_.update_buffers();
-}
-
-void Tiling::construct_pmg(void)
-{
-	// Square lattice.
-	t2_relative_ = {0, 1};
-
-	mesh_.positions_ = {
-		// Bottom left.
-		{0, 0, 0},     {0.5, 0, 0}, {0.5, 0.5, 0},
-		{0.5, 0.5, 0}, {0, 0.5, 0}, {0, 0, 0},
-		// Top left, mirrored.
-		{0, 1, 0},     {0.5, 1, 0}, {0.5, 0.5, 0},
-		{0.5, 0.5, 0}, {0, 0.5, 0}, {0, 1, 0},
-		// Top right, mirrored.
-		{1, 0.5, 0},   {0.5, 0.5, 0}, {0.5, 1, 0},
-		{0.5, 1, 0},   {1, 1, 0},     {1, 0.5, 0},
-		// Bottom right.
-		{1, 0.5, 0},   {0.5, 0.5, 0}, {0.5, 0, 0},
-		{0.5, 0, 0},   {1, 0, 0},     {1, 0.5, 0}
-	};
-	mesh_.update_buffers();
-
-	frame_mesh_.positions_ = {
-		{0, 0, 0}, {1, 0, 0},
-		{0, 1, 0}, {1, 1, 0},
-		{0, 0, 0}, {0, 1, 0},
-		{1, 0, 0}, {1, 1, 0},
-
-		{0, 0.5, 0}, {1, 0.5, 0},
-		{0.5, 0, 0}, {0.5, 1, 0}
-	};
-
-	frame_mesh_.normals_ = {
-		mirror_color_, mirror_color_,
-		mirror_color_, mirror_color_,
-		rotation_color_, rotation_color_,
-		rotation_color_, rotation_color_,
-
-		mirror_color_, mirror_color_,
-		rotation_color_, rotation_color_
-	};
-	frame_mesh_.update_buffers();
-}
-
-void Tiling::construct_cmm(void)
-{
-	// Square lattice.
-	t2_relative_ = {0, 1};
-
-	mesh_.positions_ = {
-		// Bottom triangle, divided in half.
-		{0, 0, 0},     {0.5, 0, 0}, {0.5, 0.5, 0},
-		{0.5, 0.5, 0}, {0.5, 0, 0}, {1, 0, 0},
-		// Left triangle. This is mirrored, so clockwise.
-		{0, 0, 0},     {0, 0.5, 0}, {0.5, 0.5, 0},
-		{0.5, 0.5, 0}, {0, 0.5, 0}, {0, 1, 0},
-		// Top triangle. Not mirrored - counter-clockwise.
-		{1, 1, 0},     {0.5, 1, 0}, {0.5, 0.5, 0},
-		{0.5, 0.5, 0}, {0.5, 1, 0}, {0, 1, 0},
-		// Right triangle. Mirrored. Clockwise again.
-		{1, 1, 0},     {1, 0.5, 0}, {0.5, 0.5, 0},
-		{0.5, 0.5, 0}, {1, 0.5, 0}, {1, 0, 0}
-	};
-	mesh_.update_buffers();
-
-	frame_mesh_.positions_ = {
-		{0, 0, 0}, {1, 0, 0},
-		{0, 1, 0}, {1, 1, 0},
-		{0, 0, 0}, {0, 1, 0},
-		{1, 0, 0}, {1, 1, 0},
-
-		{0, 0, 0}, {1, 1, 0},
-		{0, 1, 0}, {1, 0, 0}
-	};
-
-	frame_mesh_.normals_ = {
-		rotation_color_, rotation_color_,
-		rotation_color_, rotation_color_,
-		rotation_color_, rotation_color_,
-		rotation_color_, rotation_color_,
-
-		mirror_color_, mirror_color_,
-		mirror_color_, mirror_color_
-	};
-	frame_mesh_.update_buffers();
-}
-
-void Tiling::construct_pgg(void)
-{
-	// Square lattice.
-	t2_relative_ = {0, 1};
-
-	mesh_.positions_ = {
-		// Bottom left and right.
-		{0, 0.5, 0}, {0, 0, 0},     {0.5, 0, 0},
-		{0.5, 0, 0}, {1, 0, 0},     {1, 0.5, 0},
-		// Top right and left.
-		{1, 0.5, 0}, {1, 1, 0},     {0.5, 1, 0},
-		{0.5, 1, 0}, {0, 1, 0},     {0, 0.5, 0},
-		// Bottom center, mirrored.
-		{0.5, 0, 0}, {0.5, 0.5, 0}, {1, 0.5, 0},
-		{0, 0.5, 0}, {0.5, 0.5, 0}, {0.5, 0, 0},
-		// Top center, mirrored.
-		{0.5, 1, 0}, {0.5, 0.5, 0}, {0, 0.5, 0},
-		{1, 0.5, 0}, {0.5, 0.5, 0}, {0.5, 1, 0}
-	};
-	mesh_.update_buffers();
-
-	frame_mesh_.positions_ = {
-		{0, 0, 0}, {1, 0, 0},
-		{0, 0.5, 0}, {1, 0.5, 0},
-		{0, 1, 0}, {1, 1, 0},
-		{0, 0.5, 0}, {0.5, 0, 0},
-		{0.5, 0, 0}, {1, 0.5, 0},
-		{1, 0.5, 0}, {0.5, 1, 0},
-		{0.5, 1, 0}, {0, 0.5, 0},
-	};
-
-	frame_mesh_.normals_ = {
-		rotation_color_, rotation_color_,
-		rotation_color_, rotation_color_,
-		rotation_color_, rotation_color_,
-		line_color_, line_color_,
-		line_color_, line_color_,
-		line_color_, line_color_,
-		line_color_, line_color_
-	};
-	frame_mesh_.update_buffers();
-}
-
-void Tiling::construct_p3(void)
-{
-	// Hexagonal lattice.
-	t2_relative_ = {0.5, std::sqrt(3) / 2.0};
-
-	mesh_.positions_ = {
-		// Left and right side.
-		{0, 0, 0}, {1 / 3., 1 / 3., 0}, {0, 1, 0},
-		{1, 1, 0}, {2 / 3., 2 / 3., 0}, {1, 0, 0},
-		// Bottom and top.
-		{1, 0, 0}, {1 / 3., 1 / 3., 0}, {0, 0, 0},
-		{0, 1, 0}, {2 / 3., 2 / 3., 0}, {1, 1, 0},
-		// Center.
-		{0, 1, 0}, {1 / 3., 1 / 3., 0}, {1, 0, 0},
-		{1, 0, 0}, {2 / 3., 2 / 3., 0}, {0, 1, 0}
-	};
-	mesh_.update_buffers();
-
-	frame_mesh_.positions_ = {
-		{0, 0, 0}, {1 / 3., 1 / 3., 0},
-		{1, 0, 0}, {1 / 3., 1 / 3., 0},
-		{0, 1, 0}, {1 / 3., 1 / 3., 0},
-
-		{1, 1, 0}, {2 / 3., 2 / 3., 0},
-		{0, 1, 0}, {2 / 3., 2 / 3., 0},
-		{1, 0, 0}, {2 / 3., 2 / 3., 0},
-	};
-
-	frame_mesh_.normals_ = std::vector<Eigen::Vector3f>(12, line_color_);
-	frame_mesh_.update_buffers();
-}
-
-void Tiling::construct_p3m1(void)
-{
-	// Hexagonal lattice.
-	t2_relative_ = {0.5, std::sqrt(3) / 2.0};
-
-	mesh_.positions_ = {
-		// Bottom and top left.
-		{0, 0, 0}, {0.5, 0, 0}, {1 / 3., 1 / 3., 0},
-		{2 / 3., 2 / 3., 0}, {0.5, 1, 0}, {0, 1, 0},
-		// Bottom and top right, mirrored.
-		{1, 0, 0}, {0.5, 0, 0}, {1 / 3., 1 / 3., 0},
-		{2 / 3., 2 / 3., 0}, {0.5, 1, 0}, {1, 1, 0},
-		// Left and right top.
-		{0, 1, 0}, {0, 0.5, 0}, {1 / 3., 1 / 3., 0},
-		{2 / 3., 2 / 3., 0}, {1, 0.5, 0}, {1, 1, 0},
-		// Left and right bottom, mirrored.
-		{0, 0, 0}, {0, 0.5, 0}, {1 / 3., 1 / 3., 0},
-		{2 / 3., 2 / 3., 0}, {1, 0.5, 0}, {1, 0, 0},
-		// Bottom center.
-		{1, 0, 0}, {0.5, 0.5, 0}, {1 / 3., 1 / 3., 0},
-		{2 / 3., 2 / 3., 0}, {0.5, 0.5, 0}, {1, 0, 0},
-		// Top center, mirrored.
-		{0, 1, 0}, {0.5, 0.5, 0}, {1 / 3., 1 / 3., 0},
-		{2 / 3., 2 / 3., 0}, {0.5, 0.5, 0}, {0, 1, 0}
-	};
-	mesh_.update_buffers();
-
-	frame_mesh_.positions_  = {
-		{0, 0, 0}, {1, 1, 0},
-		{0.5, 0, 0}, {0, 1, 0},
-		{0.5, 1, 0}, {1, 0, 0},
-		{0, 0.5, 0}, {1, 0, 0},
-		{1, 0.5, 0}, {0, 1, 0}
-	};
-
-	frame_mesh_.normals_ = std::vector<Eigen::Vector3f>(10, mirror_color_);
-	frame_mesh_.update_buffers();
-}
-
-void Tiling::construct_p31m(void)
-{
-	// Hexagonal lattice.
-	t2_relative_ = {0.5, std::sqrt(3) / 2.0};
-
-	mesh_.positions_ = {
-		// Bottom.
-		{0, 0, 0},           {0.5, 0, 0},   {1 / 3., 1 / 3., 0},
-		{1 / 3., 1 / 3., 0}, {0.5, 0, 0},   {1, 0, 0},
-		// Left.
-		{0, 1, 0},           {0, 0.5, 0},   {1 / 3., 1 / 3., 0},
-		{1 / 3., 1 / 3., 0}, {0, 0.5, 0},   {0, 0, 0},
-		// Top, mirrored.
-		{0, 1, 0},           {0.5, 1, 0},   {2 / 3., 2 / 3., 0},
-		{2 / 3., 2 / 3., 0}, {0.5, 1, 0},   {1, 1, 0},
-		// Right, mirrored.
-		{1, 1, 0},           {1, 0.5, 0},   {2 / 3., 2 / 3., 0},
-		{2 / 3., 2 / 3., 0}, {1, 0.5, 0},   {1, 0, 0},
-		// Center left.
-		{1, 0, 0},           {0.5, 0.5, 0}, {1 / 3., 1 / 3., 0},
-		{1 / 3., 1 / 3., 0}, {0.5, 0.5, 0}, {0, 1, 0},
-		// Kepu, mirrored.
-		{1, 0, 0},           {0.5, 0.5, 0}, {2 / 3., 2 / 3., 0},
-		{2 / 3., 2 / 3., 0}, {0.5, 0.5, 0}, {0, 1, 0}
-	};
-	mesh_.update_buffers();
-
-	frame_mesh_.positions_ = {
-		{0, 0, 0}, {1, 0, 0},
-		{0, 1, 0}, {1, 1, 0},
-		{0, 0, 0}, {0, 1, 0},
-		{1, 0, 0}, {1, 1, 0},
-		{1, 0, 0}, {0, 1, 0},
-
-		{0, 0, 0}, {1 / 3., 1 / 3., 0},
-		{1, 0, 0}, {1 / 3., 1 / 3., 0},
-		{0, 1, 0}, {1 / 3., 1 / 3., 0},
-
-		{1, 1, 0}, {2 / 3., 2 / 3., 0},
-		{0, 1, 0}, {2 / 3., 2 / 3., 0},
-		{1, 0, 0}, {2 / 3., 2 / 3., 0}
-	};
-
-	frame_mesh_.normals_ = {
-		mirror_color_, mirror_color_,
-		mirror_color_, mirror_color_,
-		mirror_color_, mirror_color_,
-		mirror_color_, mirror_color_,
-		mirror_color_, mirror_color_,
-
-		line_color_, line_color_,
-		line_color_, line_color_,
-		line_color_, line_color_,
-
-		line_color_, line_color_,
-		line_color_, line_color_,
-		line_color_, line_color_
-	};
-	frame_mesh_.update_buffers();
-}
-
-void Tiling::construct_p4(void)
-{
-	// Square lattice.
-	t2_relative_ = {0, 1};
-
-	mesh_.positions_ = {
-		// Bottom left.
-		{0, 0, 0},     {0.5, 0, 0}, {0.5, 0.5, 0},
-		{0.5, 0.5, 0}, {0, 0.5, 0}, {0, 0, 0},
-		// Top left.
-		{0, 1, 0},     {0, 0.5, 0}, {0.5, 0.5, 0},
-		{0.5, 0.5, 0}, {0.5, 1, 0}, {0, 1, 0},
-		// Top right.
-		{1, 1, 0},     {0.5, 1, 0}, {0.5, 0.5, 0},
-		{0.5, 0.5, 0}, {1, 0.5, 0}, {1, 1, 0},
-		// Bottom right.
-		{1, 0, 0},     {1, 0.5, 0}, {0.5, 0.5, 0},
-		{0.5, 0.5, 0}, {0.5, 0, 0}, {1, 0, 0}
-	};
-	mesh_.update_buffers();
-
-	frame_mesh_.positions_ = {
-		{0, 0, 0}, {1, 0, 0},
-		{0, 0.5, 0}, {1, 0.5, 0},
-		{0, 1, 0}, {1, 1, 0},
-		{0, 0, 0}, {0, 1, 0},
-		{0.5, 0, 0}, {0.5, 1, 0},
-		{1, 0, 0}, {1, 1, 0}
-	};
-
-	frame_mesh_.normals_ = std::vector<Eigen::Vector3f>(12, line_color_);
-	frame_mesh_.update_buffers();
-}
-
-void Tiling::construct_p4m(void)
-{
-	// Square lattice.
-	t2_relative_ = {0, 1};
-
-	mesh_.positions_ = {
-		// Bottom left.
-		{0.5, 0.5, 0}, {0.25, 0.25, 0}, {0.5, 0, 0},
-		{0.5, 0, 0},   {0.25, 0.25, 0}, {0, 0, 0},
-		// Left bottom, mirrored.
-		{0.5, 0.5, 0}, {0.25, 0.25, 0}, {0, 0.5, 0},
-		{0, 0.5, 0},   {0.25, 0.25, 0}, {0, 0, 0},
-		// Left top.
-		{0.5, 0.5, 0}, {0.25, 0.75, 0}, {0, 0.5, 0},
-		{0, 0.5, 0},   {0.25, 0.75, 0}, {0, 1, 0},
-		// Top left, mirrored.
-		{0.5, 0.5, 0}, {0.25, 0.75, 0}, {0.5, 1, 0},
-		{0.5, 1, 0},   {0.25, 0.75, 0}, {0, 1, 0},
-		// Top right.
-		{0.5, 0.5, 0}, {0.75, 0.75, 0}, {0.5, 1, 0},
-		{0.5, 1, 0},   {0.75, 0.75, 0}, {1, 1, 0},
-		// Right top, mirrored.
-		{0.5, 0.5, 0}, {0.75, 0.75, 0}, {1, 0.5, 0},
-		{1, 0.5, 0},   {0.75, 0.75, 0}, {1, 1, 0},
-		// Right bottom.
-		{0.5, 0.5, 0}, {0.75, 0.25, 0}, {1, 0.5, 0},
-		{1, 0.5, 0},   {0.75, 0.25, 0}, {1, 0, 0},
-		// Bottom right, mirrored.
-		{0.5, 0.5, 0}, {0.75, 0.25, 0}, {0.5, 0, 0},
-		{0.5, 0, 0},   {0.75, 0.25, 0}, {1, 0, 0},
-	};
-	mesh_.update_buffers();
-
-	frame_mesh_.positions_ = {
-		{0, 0, 0}, {1, 0, 0},
-		{0, 0.5, 0}, {1, 0.5, 0},
-		{0, 1, 0}, {1, 1, 0},
-		{0, 0, 0}, {0, 1, 0},
-		{0.5, 0, 0}, {0.5, 1, 0},
-		{1, 0, 0}, {1, 1, 0},
-		{0, 0, 0}, {1, 1, 0},
-		{0, 1, 0}, {1, 0, 0}
-	};
-
-	frame_mesh_.normals_ = std::vector<Eigen::Vector3f>(16, mirror_color_);
-	frame_mesh_.update_buffers();
-}
-
-void Tiling::construct_p4g(void)
-{
-	// Square lattice.
-	t2_relative_ = {0, 1};
-
-	mesh_.positions_ = {
-		// Inner bottom left.
-		{0, 0.5, 0},   {0.25, 0.25, 0}, {0.5, 0.5, 0},
-		{0.5, 0.5, 0}, {0.25, 0.25, 0}, {0.5, 0, 0},
-		// Outer bottom left, mirrored.
-		{0, 0.5, 0},   {0.25, 0.25, 0}, {0, 0, 0},
-		{0, 0, 0},     {0.25, 0.25, 0}, {0.5, 0, 0},
-		// Inner top left.
-		{0.5, 1, 0},   {0.25, 0.75, 0}, {0.5, 0.5, 0},
-		{0.5, 0.5, 0}, {0.25, 0.75, 0}, {0, 0.5, 0},
-		// Outer top left, mirrored.
-		{0.5, 1, 0},   {0.25, 0.75, 0}, {0, 1, 0},
-		{0, 1, 0},     {0.25, 0.75, 0}, {0, 0.5, 0},
-		// Inner top right.
-		{1, 0.5, 0},   {0.75, 0.75, 0}, {0.5, 0.5, 0},
-		{0.5, 0.5, 0}, {0.75, 0.75, 0}, {0.5, 1, 0},
-		// Outer top right, mirrored.
-		{1, 0.5, 0},   {0.75, 0.75, 0}, {1, 1, 0},
-		{1, 1, 0},     {0.75, 0.75, 0}, {0.5, 1, 0},
-		// Inner bottom right.
-		{0.5, 0, 0},   {0.75, 0.25, 0}, {0.5, 0.5, 0},
-		{0.5, 0.5, 0}, {0.75, 0.25, 0}, {1, 0.5, 0},
-		// Outer bottom right, mirrored.
-		{0.5, 0, 0},   {0.75, 0.25, 0}, {1, 0, 0},
-		{1, 0, 0},     {0.75, 0.25, 0}, {1, 0.5, 0}
-	};
-	mesh_.update_buffers();
-
-	frame_mesh_.positions_ = {
-		{0, 0, 0}, {1, 0, 0},
-		{0, 0.5, 0}, {1, 0.5, 0},
-		{0, 1, 0}, {1, 1, 0},
-		{0, 0, 0}, {0, 1, 0},
-		{0.5, 0, 0}, {0.5, 1, 0},
-		{1, 0, 0}, {1, 1, 0},
-
-		{0, 0.5, 0}, {0.5, 0, 0},
-		{0.5, 0, 0}, {1, 0.5, 0},
-		{1, 0.5, 0}, {0.5, 1, 0},
-		{0.5, 1, 0}, {0, 0.5, 0}
-	};
-
-	frame_mesh_.normals_ = {
-		line_color_, line_color_,
-		line_color_, line_color_,
-		line_color_, line_color_,
-		line_color_, line_color_,
-		line_color_, line_color_,
-		line_color_, line_color_,
-
-		mirror_color_, mirror_color_,
-		mirror_color_, mirror_color_,
-		mirror_color_, mirror_color_,
-		mirror_color_, mirror_color_
-	};
-	frame_mesh_.update_buffers();
-}
-
-void Tiling::construct_p6(void)
-{
-	// Hexagonal lattice.
-	t2_relative_ = {0.5, std::sqrt(3) / 2.0};
-
-	mesh_.positions_ = {
-		// Bottom.
-		{0, 0, 0},           {0.5, 0, 0},   {1 / 3., 1 / 3., 0},
-		{1 / 3., 1 / 3., 0}, {0.5, 0, 0},   {1, 0, 0},
-		// Left.
-		{0, 1, 0},           {0, 0.5, 0},   {1 / 3., 1 / 3., 0},
-		{1 / 3., 1 / 3., 0}, {0, 0.5, 0},   {0, 0, 0},
-		// Top.
-		{1, 1, 0},           {0.5, 1, 0},   {2 / 3., 2 / 3., 0},
-		{2 / 3., 2 / 3., 0}, {0.5, 1, 0},   {0, 1, 0},
-		// Right.
-		{1, 0, 0},           {1, 0.5, 0},   {2 / 3., 2 / 3., 0},
-		{2 / 3., 2 / 3., 0}, {1, 0.5, 0},   {1, 1, 0},
-		// Center left.
-		{1, 0, 0},           {0.5, 0.5, 0}, {1 / 3., 1 / 3., 0},
-		{1 / 3., 1 / 3., 0}, {0.5, 0.5, 0}, {0, 1, 0},
-		// Kepu.
-		{0, 1, 0},           {0.5, 0.5, 0}, {2 / 3., 2 / 3., 0},
-		{2 / 3., 2 / 3., 0}, {0.5, 0.5, 0}, {1, 0, 0}
-	};
-	mesh_.update_buffers();
-
-	frame_mesh_.positions_ = {
-		{0, 0, 0}, {1, 0, 0},
-		{0, 1, 0}, {1, 1, 0},
-		{0, 0, 0}, {0, 1, 0},
-		{1, 0, 0}, {1, 1, 0},
-		{1, 0, 0}, {0, 1, 0},
-
-		{0, 0, 0}, {1 / 3., 1 / 3., 0},
-		{1, 0, 0}, {1 / 3., 1 / 3., 0},
-		{0, 1, 0}, {1 / 3., 1 / 3., 0},
-
-		{1, 1, 0}, {2 / 3., 2 / 3., 0},
-		{0, 1, 0}, {2 / 3., 2 / 3., 0},
-		{1, 0, 0}, {2 / 3., 2 / 3., 0}
-	};
-
-	frame_mesh_.normals_ = {
-		rotation_color_, rotation_color_,
-		rotation_color_, rotation_color_,
-		rotation_color_, rotation_color_,
-		rotation_color_, rotation_color_,
-		rotation_color_, rotation_color_,
-
-		line_color_, line_color_,
-		line_color_, line_color_,
-		line_color_, line_color_,
-
-		line_color_, line_color_,
-		line_color_, line_color_,
-		line_color_, line_color_
-	};
-	frame_mesh_.update_buffers();
-}
-
-void Tiling::construct_p6m(void)
-{
-	// Hexagonal lattice.
-	t2_relative_ = {0.5, std::sqrt(3) / 2.0};
-
-	mesh_.positions_ = {
-		// Bottom left.
-		{1 / 3., 1 / 3., 0}, {1 / 6., 1 / 6., 0}, {0.5, 0, 0},
-		{0.5, 0, 0},         {1 / 6., 1 / 6., 0}, {0, 0, 0},
-		// Bottom right, mirrored.
-		{1 / 3., 1 / 3., 0}, {2 / 3., 1 / 6., 0}, {0.5, 0, 0},
-		{0.5, 0, 0},         {2 / 3., 1 / 6., 0}, {1, 0, 0},
-		// Left top.
-		{1 / 3., 1 / 3., 0}, {1 / 6., 2 / 3., 0}, {0, 0.5, 0},
-		{0, 0.5, 0},         {1 / 6., 2 / 3., 0}, {0, 1, 0},
-		// Left bottom, mirrored.
-		{1 / 3., 1 / 3., 0}, {1 / 6., 1 / 6., 0}, {0, 0.5, 0},
-		{0, 0.5, 0},         {1 / 6., 1 / 6., 0}, {0, 0, 0},
-		// Top right.
-		{2 / 3., 2 / 3., 0}, {5 / 6., 5 / 6., 0}, {0.5, 1, 0},
-		{0.5, 1, 0},         {5 / 6., 5 / 6., 0}, {1, 1, 0},
-		// Top left, mirrored.
-		{2 / 3., 2 / 3., 0}, {1 / 3., 5 / 6., 0}, {0.5, 1, 0},
-		{0.5, 1, 0},         {1 / 3., 5 / 6., 0}, {0, 1, 0},
-		// Right bottom.
-		{2 / 3., 2 / 3., 0}, {5 / 6., 1 / 3., 0}, {1, 0.5, 0},
-		{1, 0.5, 0},         {5 / 6., 1 / 3., 0}, {1, 0, 0},
-		// Right top, mirrored.
-		{2 / 3., 2 / 3., 0}, {5 / 6., 5 / 6., 0}, {1, 0.5, 0},
-		{1, 0.5, 0},         {5 / 6., 5 / 6., 0}, {1, 1, 0},
-		// Central bottom left.
-		{1 / 3., 1 / 3., 0}, {2 / 3., 1 / 6., 0}, {0.5, 0.5, 0},
-		{0.5, 0.5, 0},       {2 / 3., 1 / 6., 0}, {1, 0, 0},
-		// Central bottom right, mirrored.
-		{2 / 3., 2 / 3., 0}, {5 / 6., 1 / 3., 0}, {0.5, 0.5, 0},
-		{0.5, 0.5, 0},       {5 / 6., 1 / 3., 0}, {1, 0, 0},
-		// Central top right.
-		{2 / 3., 2 / 3., 0}, {1 / 3., 5 / 6., 0}, {0.5, 0.5, 0},
-		{0.5, 0.5, 0},       {1 / 3., 5 / 6., 0}, {0, 1, 0},
-		// Central top left, mirrored.
-		{1 / 3., 1 / 3., 0}, {1 / 6., 2 / 3., 0}, {0.5, 0.5, 0},
-		{0.5, 0.5, 0},       {1 / 6., 2 / 3., 0}, {0, 1, 0}
-	};
-	mesh_.update_buffers();
-
-	frame_mesh_.positions_  = {
-		{0, 0, 0}, {1, 0, 0},
-		{0, 1, 0}, {1, 1, 0},
-		{0, 0, 0}, {0, 1, 0},
-		{1, 0, 0}, {1, 1, 0},
-		{1, 0, 0}, {0, 1, 0},
-
-		{0, 0, 0}, {1, 1, 0},
-		{0.5, 0, 0}, {0, 1, 0},
-		{0.5, 1, 0}, {1, 0, 0},
-		{0, 0.5, 0}, {1, 0, 0},
-		{1, 0.5, 0}, {0, 1, 0}
-	};
-
-	frame_mesh_.normals_ = std::vector<Eigen::Vector3f>(20, mirror_color_);
-	frame_mesh_.update_buffers();
-}
-
-void Tiling::update_total_mesh(void)
-{
-	auto& vertices = total_mesh_.positions_;
-	vertices.clear();
-	vertices.reserve(num_lattice_domains_ * mesh_.positions_.size());
-
-	int s = std::sqrt(num_lattice_domains_);
-	for (int y = 0; y < s; ++y)
-	{
-		for (int x = 0; x < s; ++x)
-		{
-			Eigen::Vector3f adjustment = {(float)(x - s/2), (float)(y - s/2), 0};
-
-			for (const auto& vertex : mesh_.positions_)
-				vertices.push_back(vertex + adjustment);
-		}
-	}
-
-	total_mesh_.update_buffers();
-	mesh_texture_ = GL::Texture::buffer_texture(total_mesh_.position_buffer_, GL_RGB32F);
-}
@@ -0,0 +1,211 @@
+#include "Trace.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Events kept per track. At 64 bytes each, a megabyte per thread.
+#define TRACK_EVENTS (1u << 14)
+
+//--------------------
+
+namespace
+{
+struct Event
+{
+	int64_t begin;
+	int64_t end;
+	char    name[48];
+};
+
+// Written by a single thread. The head only grows, and readers use it to
+// tell which events may have been overwritten while they were copying.
+struct Track
+{
+	std::string                     name;
+	size_t                          id;
+	std::array<Event, TRACK_EVENTS> events;
+	std::atomic<uint64_t>           head;
+};
+
+struct Registry
+{
+	std::mutex                          mutex;
+	std::vector<std::unique_ptr<Track>> tracks;
+};
+
+Registry& registry(void)
+{
+	static Registry registry;
+	return registry;
+}
+
+// Registration locks, but only once per track.
+Track* new_track(const std::string& name)
+{
+	auto& tracks = registry();
+	std::lock_guard<std::mutex> lock(tracks.mutex);
+
+	std::unique_ptr<Track> track(new Track());
+	track->name = name;
+	track->id   = tracks.tracks.size() + 1;
+	track->head = 0;
+
+	tracks.tracks.push_back(std::move(track));
+	return tracks.tracks.back().get();
+}
+
+Track& thread_track(void)
+{
+	thread_local Track* track = new_track("");
+	return *track;
+}
+
+Track& gpu_track(void)
+{
+	static Track* track = new_track("GPU");
+	return *track;
+}
+
+void append(Track& track, const char* name, int64_t begin, int64_t end)
+{
+	auto index  = track.head.load(std::memory_order_relaxed);
+	auto& event = track.events[index % TRACK_EVENTS];
+
+	event.begin = begin;
+	event.end   = end;
+	std::strncpy(event.name, name, sizeof(event.name) - 1);
+	event.name[sizeof(event.name) - 1] = '\0';
+
+	track.head.store(index + 1, std::memory_order_release);
+}
+
+// Copies the events that are certain not to have been overwritten meanwhile.
+std::vector<Event> snapshot(const Track& track)
+{
+	auto head  = track.head.load(std::memory_order_acquire);
+	auto first = head > TRACK_EVENTS ? head - TRACK_EVENTS : 0;
+
+	std::vector<Event> events;
+	for (auto i = first; i < head; ++i)
+		events.push_back(track.events[i % TRACK_EVENTS]);
+
+	// The slot of the event being written now held the oldest one.
+	auto after = track.head.load(std::memory_order_acquire);
+	auto valid = after >= TRACK_EVENTS ? after - TRACK_EVENTS + 1 : 0;
+	if (valid > first)
+		events.erase(std::begin(events), std::begin(events) + std::min<uint64_t>(valid - first, events.size()));
+
+	return events;
+}
+
+std::string escape(const char* string)
+{
+	std::string escaped;
+	for (; *string; ++string)
+	{
+		if (*string == '"' || *string == '\\')
+			escaped += '\\';
+		if ((unsigned char)*string >= 0x20)
+			escaped += *string;
+	}
+
+	return escaped;
+}
+} // namespace
+
+Trace::Zone::Zone(const char* name) :
+	begin_ (Trace::now())
+{
+	std::strncpy(name_, name, sizeof(name_) - 1);
+	name_[sizeof(name_) - 1] = '\0';
+}
+
+Trace::Zone::Zone(const std::string& name) :
+	Zone(name.c_str())
+{}
+
+Trace::Zone::~Zone(void)
+{
+	Trace::record(name_, begin_, Trace::now());
+}
+
+int64_t Trace::now(void)
+{
+	using namespace std::chrono;
+	return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void Trace::record(const char* name, int64_t begin, int64_t end)
+{
+	append(thread_track(), name, begin, end);
+}
+
+void Trace::record_gpu(const char* name, int64_t begin, int64_t end)
+{
+	append(gpu_track(), name, begin, end);
+}
+
+void Trace::set_thread_name(const char* name)
+{
+	auto& track  = thread_track();
+	auto& tracks = registry();
+	std::lock_guard<std::mutex> lock(tracks.mutex);
+
+	track.name = name;
+}
+
+bool Trace::dump(const std::string& path, double seconds)
+{
+	auto end   = now();
+	auto start = end - (int64_t)(seconds * 1e9);
+
+	FILE* file = std::fopen(path.c_str(), "w");
+	if (!file)
+	{
+		std::fprintf(stderr, "Could not write the trace to %s.\n", path.c_str());
+		return false;
+	}
+
+	auto& tracks = registry();
+	std::lock_guard<std::mutex> lock(tracks.mutex);
+
+	// Timestamps are in microseconds, relative to the start of the window.
+	std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+	bool first = true;
+	size_t num_events = 0;
+	for (const auto& track : tracks.tracks)
+	{
+		auto name = track->name.empty() ? "Thread " + std::to_string(track->id) : track->name;
+		std::fprintf(file, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":\"%s\"}}",
+		             first ? "" : ",\n", track->id, escape(name.c_str()).c_str());
+		first = false;
+
+		for (const auto& event : snapshot(*track))
+		{
+			if (event.end < start)
+				continue;
+
+			std::fprintf(file, ",\n{\"ph\":\"X\",\"name\":\"%s\",\"pid\":1,\"tid\":%zu,\"ts\":%.3f,\"dur\":%.3f}",
+			             escape(event.name).c_str(), track->id,
+			             (event.begin - start) / 1e3, (event.end - event.begin) / 1e3);
+			++num_events;
+		}
+	}
+
+	std::fprintf(file, "\n]}\n");
+	bool successful = std::ferror(file) == 0;
+	std::fclose(file);
+
+	if (successful)
+		std::printf("Wrote %zu trace events to %s.\n", num_events, path.c_str());
+
+	return successful;
+}
@@ -0,0 +1,54 @@
+#include "UniformArray.h"
+
+#include <algorithm>
+#include <cstring>
+
+//--------------------
+
+UniformArray::UniformArray(size_t element_size) :
+	element_size_ (element_size),
+	capacity_     (0)
+{
+	static GLint alignment = [](){
+		GLint a; glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &a);
+		return a;
+	}();
+
+	stride_ = (element_size_ + alignment - 1) / alignment * alignment;
+}
+
+void UniformArray::clear(void)
+{
+	data_.clear();
+}
+
+size_t UniformArray::push(const void* element)
+{
+	auto index = size();
+
+	data_.resize(data_.size() + stride_);
+	std::memcpy(&data_[index * stride_], element, element_size_);
+
+	return index;
+}
+
+void UniformArray::upload(void)
+{
+	if (data_.empty())
+		return;
+
+	glBindBuffer(GL_UNIFORM_BUFFER, buffer_);
+
+	// Fresh storage every time, so the driver doesn't wait for draws using the old one.
+	if (data_.size() > capacity_)
+		capacity_ = std::max(data_.size(), 2 * capacity_);
+	glBufferData(GL_UNIFORM_BUFFER, capacity_, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, data_.size(), data_.data());
+	buffer_.set_bytes(capacity_);
+}
+
+void UniformArray::bind(GLuint binding, size_t index) const
+{
+	assert(index < size());
+	glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer_, index * stride_, element_size_);
+}
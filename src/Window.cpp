@@ -1,20 +1,32 @@
 #include "Window.h"
 
 #include <iostream>
+#include <stdexcept>
 
 MainWindow::PointerMap MainWindow::window_by_pointer__;
+bool                   MainWindow::visible__ = true;
 
 //--------------------
 
-MainWindow::MainWindow(int width, int height, const char* title) :
-	window_p_(nullptr)
+MainWindow::MainWindow(int width, int height, const char* title, bool visible) :
+	window_p_        (nullptr),
+	cursor_x_        (0.0),
+	cursor_y_        (0.0),
+	recording_start_ (0.0),
+	replaying_       (false),
+	replay_time_     (0.0)
 {
+	keys_down_.fill(false);
+	mouse_buttons_down_.fill(false);
+
+	visible__ = visible;
 	glfwSetErrorCallback(&master_error_callback);
 	if (!glfwInit())
 		throw std::runtime_error("Failed to initialize GLFW.");
 
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
 
 	window_p_ = glfwCreateWindow(width, height, title, NULL, NULL);
 	if (!window_p_)
@@ -44,6 +56,8 @@ MainWindow::MainWindow(int width, int height, const char* title) :
 	glfwSetCursorPosCallback(window_p_, &master_mouse_pos_callback);
 	glfwSetScrollCallback(window_p_, &master_scroll_callback);
 	glfwSetDropCallback(window_p_, &master_path_drop_callback);
+
+	glfwGetCursorPos(window_p_, &cursor_x_, &cursor_y_);
 }
 
 MainWindow::~MainWindow(void) {
@@ -91,71 +105,225 @@ void MainWindow::add_path_drop_callback(const PathDropCallback& callback)
 	path_drop_callbacks_.push_back(callback);
 }
 
-void MainWindow::master_key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+bool MainWindow::key_down(int key) const
+{
+	return key >= 0 && key <= GLFW_KEY_LAST && keys_down_[key];
+}
+
+bool MainWindow::mouse_button_down(int button) const
+{
+	return button >= 0 && button <= GLFW_MOUSE_BUTTON_LAST && mouse_buttons_down_[button];
+}
+
+void MainWindow::cursor_position(double& x, double& y) const
+{
+	x = cursor_x_;
+	y = cursor_y_;
+}
+
+// A headless replay has no focus to lose.
+bool MainWindow::focused(void) const
+{
+	return replaying_ || glfwGetWindowAttrib(window_p_, GLFW_FOCUSED);
+}
+
+double MainWindow::time(void) const
 {
-	const auto& callback_map = window_by_pointer__.at(window)->key_callback_map_;
-	const auto& callbacks    = window_by_pointer__.at(window)->general_key_callbacks_;
+	return replaying_ ? replay_time_ : glfwGetTime();
+}
 
-	if (callback_map.find(key) != std::end(callback_map))
+// The header holds the window size, since cursor positions depend on it.
+// The cursor position goes first, to start the replay where it was.
+bool MainWindow::record(const std::string& path)
+{
+	std::unique_ptr<std::ofstream> file(new std::ofstream(path));
+	if (!*file)
 	{
-		for (auto& callback : callback_map.at(key))
-			callback(scancode, action, mods);
+		std::cerr << "Could not record the input to " << path << "." << std::endl;
+		return false;
 	}
 
-	for (auto& callback : callbacks)
-		callback(key, scancode, action, mods);
+	int width, height;
+	glfwGetWindowSize(window_p_, &width, &height);
+	*file << "symmetrifier-input 1 " << width << ' ' << height << '\n';
+
+	recording_       = std::move(file);
+	recording_start_ = time();
+
+	*recording_ << InputEvent{0.0, InputEvent::MOUSE_POS, 0, 0, 0, 0, 0, cursor_x_, cursor_y_, {}};
+	return true;
 }
 
-void MainWindow::master_char_callback(GLFWwindow* window, unsigned int c)
+void MainWindow::begin_replay(void)
 {
-	const auto& callbacks = window_by_pointer__.at(window)->char_callbacks_;
+	replaying_   = true;
+	replay_time_ = 0.0;
 
-	for (auto& callback : callbacks)
-		callback(c);
+	// Nothing is held down at the start of a recording.
+	keys_down_.fill(false);
+	mouse_buttons_down_.fill(false);
 }
 
-void MainWindow::master_mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
+void MainWindow::set_replay_time(double time)
 {
-	const auto& callback_map = window_by_pointer__.at(window)->mouse_button_callback_map_;
-	const auto& callbacks    = window_by_pointer__.at(window)->general_mouse_button_callbacks_;
+	replay_time_ = time;
+}
+
+void MainWindow::replay(const InputEvent& event)
+{
+	InputEvent replayed = event;
+	receive(replayed);
+}
+
+void MainWindow::receive(InputEvent& event)
+{
+	switch (event.type)
+	{
+	case InputEvent::KEY:
+		if (event.code >= 0 && event.code <= GLFW_KEY_LAST)
+			keys_down_[event.code] = event.action != GLFW_RELEASE;
+		break;
+	case InputEvent::MOUSE_BUTTON:
+		if (event.code >= 0 && event.code <= GLFW_MOUSE_BUTTON_LAST)
+			mouse_buttons_down_[event.code] = event.action != GLFW_RELEASE;
+		break;
+	case InputEvent::MOUSE_POS:
+		cursor_x_ = event.x;
+		cursor_y_ = event.y;
+		break;
+	default:
+		break;
+	}
+
+	if (recording_)
+	{
+		event.time = time() - recording_start_;
+		*recording_ << event;
+	}
 
-	if (callback_map.find(button) != std::end(callback_map))
+	dispatch(event);
+}
+
+void MainWindow::dispatch(const InputEvent& event)
+{
+	switch (event.type)
 	{
-		for (auto& callback : callback_map.at(button))
-			callback(action, mods);
+	case InputEvent::KEY:
+	{
+		auto callbacks = key_callback_map_.find(event.code);
+		if (callbacks != std::end(key_callback_map_))
+		{
+			for (auto& callback : callbacks->second)
+				callback(event.scancode, event.action, event.mods);
+		}
+
+		for (auto& callback : general_key_callbacks_)
+			callback(event.code, event.scancode, event.action, event.mods);
+		break;
+	}
+	case InputEvent::CHAR:
+		for (auto& callback : char_callbacks_)
+			callback(event.character);
+		break;
+	case InputEvent::MOUSE_BUTTON:
+	{
+		auto callbacks = mouse_button_callback_map_.find(event.code);
+		if (callbacks != std::end(mouse_button_callback_map_))
+		{
+			for (auto& callback : callbacks->second)
+				callback(event.action, event.mods);
+		}
+
+		for (auto& callback : general_mouse_button_callbacks_)
+			callback(event.code, event.action, event.mods);
+		break;
+	}
+	case InputEvent::MOUSE_POS:
+		for (auto& callback : mouse_pos_callbacks_)
+			callback(event.x, event.y);
+		break;
+	case InputEvent::SCROLL:
+		for (auto& callback : scroll_callbacks_)
+			callback(event.x, event.y);
+		break;
+	case InputEvent::PATH_DROP:
+	{
+		std::vector<const char*> paths;
+		for (const auto& path : event.paths)
+			paths.push_back(path.c_str());
+
+		for (auto& callback : path_drop_callbacks_)
+			callback((int)paths.size(), paths.data());
+		break;
+	}
 	}
+}
+
+// GLFW input only goes through while no replay has taken over.
+void MainWindow::master_key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+	auto* main_window = window_by_pointer__.at(window);
+	if (main_window->replaying_)
+		return;
+
+	InputEvent event{0.0, InputEvent::KEY, key, scancode, action, mods, 0, 0.0, 0.0, {}};
+	main_window->receive(event);
+}
+
+void MainWindow::master_char_callback(GLFWwindow* window, unsigned int c)
+{
+	auto* main_window = window_by_pointer__.at(window);
+	if (main_window->replaying_)
+		return;
+
+	InputEvent event{0.0, InputEvent::CHAR, 0, 0, 0, 0, c, 0.0, 0.0, {}};
+	main_window->receive(event);
+}
+
+void MainWindow::master_mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
+{
+	auto* main_window = window_by_pointer__.at(window);
+	if (main_window->replaying_)
+		return;
 
-	for (auto& callback : callbacks)
-		callback(button, action, mods);
+	InputEvent event{0.0, InputEvent::MOUSE_BUTTON, button, 0, action, mods, 0, 0.0, 0.0, {}};
+	main_window->receive(event);
 }
 
 void MainWindow::master_mouse_pos_callback(GLFWwindow* window, double xpos, double ypos)
 {
-	const auto& callbacks = window_by_pointer__.at(window)->mouse_pos_callbacks_;
+	auto* main_window = window_by_pointer__.at(window);
+	if (main_window->replaying_)
+		return;
 
-	for (auto& callback : callbacks)
-		callback(xpos, ypos);
+	InputEvent event{0.0, InputEvent::MOUSE_POS, 0, 0, 0, 0, 0, xpos, ypos, {}};
+	main_window->receive(event);
 }
 
 void MainWindow::master_scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
 {
-	const auto& callbacks = window_by_pointer__.at(window)->scroll_callbacks_;
+	auto* main_window = window_by_pointer__.at(window);
+	if (main_window->replaying_)
+		return;
 
-	for (auto& callback : callbacks)
-		callback(xoffset, yoffset);
+	InputEvent event{0.0, InputEvent::SCROLL, 0, 0, 0, 0, 0, xoffset, yoffset, {}};
+	main_window->receive(event);
 }
 
 void MainWindow::master_path_drop_callback(GLFWwindow* window, int count, const char** paths)
 {
-	const auto& callbacks = window_by_pointer__.at(window)->path_drop_callbacks_;
+	auto* main_window = window_by_pointer__.at(window);
+	if (main_window->replaying_)
+		return;
 
-	for (auto& callback : callbacks)
-		callback(count, paths);
+	InputEvent event{0.0, InputEvent::PATH_DROP, 0, 0, 0, 0, 0, 0.0, 0.0, {paths, paths + count}};
+	main_window->receive(event);
 }
 
 void MainWindow::master_error_callback(int error, const char* description)
 {
 	(void)error;
 	fputs(description, stderr);
-	getchar();
+	if (visible__)
+		getchar();
 }
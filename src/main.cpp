@@ -3,12 +3,23 @@
 //#endif
 
 #include "App.h"
+#include "GoldenCheck.h"
+#include "SceneBenchmark.h"
 
 //--------------------
 
 int main(int argc, char* argv[]) {
-	App app(argc, argv);
-	app.loop();
+	auto options = Options::parse(argc, argv);
+	App app(options);
 
-	return 0;
+	int result = 0;
+	if (!options.benchmark_file.empty())
+		SceneBenchmark(app).run(options.benchmark_file);
+	else if (!options.golden_directory.empty())
+		result = GoldenCheck(app, options.golden_report, options.update_golden).run(options.golden_directory) ? 0 : 1;
+	else
+		result = app.loop();
+
+	app.dump_reports();
+	return result;
 }
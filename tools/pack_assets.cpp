@@ -0,0 +1,33 @@
+#include "AssetBundle.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Usage: pack_assets <bundle> [file | --atlas directory]...
+// Paths are stored as given, so run this from where the application runs.
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		std::fprintf(stderr, "Usage: %s <bundle> [file | --atlas directory]...\n", argv[0]);
+		return 1;
+	}
+
+	std::vector<std::string> files, atlas_directories;
+	for (int i = 2; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--atlas") == 0 && i + 1 < argc)
+			atlas_directories.push_back(argv[++i]);
+		else
+			files.push_back(argv[i]);
+	}
+
+	if (!AssetBundle::pack(argv[1], files, atlas_directories))
+		return 1;
+
+	std::printf("Packed %zu files and %zu atlases into %s.\n",
+	            files.size(), atlas_directories.size(), argv[1]);
+
+	return 0;
+}